@@ -42,6 +42,10 @@ void GatewayHandlers::registerRoutes(httplib::Server& server) {
         handleGetSubmissionReport(req, res);
     });
 
+    server.Get(R"(/api/jobs/(\d+))", [this](const httplib::Request& req, httplib::Response& res) {
+        handleGetAnalysisJob(req, res);
+    });
+
     server.Get(R"(/api/submissions/(\d+)/wordcloud)", [this](const httplib::Request& req, httplib::Response& res) {
         handleGetWordCloud(req, res);
     });
@@ -49,6 +53,18 @@ void GatewayHandlers::registerRoutes(httplib::Server& server) {
     server.Get(R"(/api/tasks/([^/]+)/reports)", [this](const httplib::Request& req, httplib::Response& res) {
         handleGetTaskReports(req, res);
     });
+
+    server.Post(R"(/api/tasks/([^/]+)/similarity-matrix)", [this](const httplib::Request& req, httplib::Response& res) {
+        handleSimilarityMatrix(req, res);
+    });
+
+    server.Post(R"(/api/tasks/([^/]+)/base-files)", [this](const httplib::Request& req, httplib::Response& res) {
+        handleAddBaseFile(req, res);
+    });
+
+    server.Get(R"(/api/tasks/([^/]+)/base-files)", [this](const httplib::Request& req, httplib::Response& res) {
+        handleGetBaseFiles(req, res);
+    });
 }
 
 void GatewayHandlers::handleHealth(const httplib::Request& /*req*/, httplib::Response& res) {
@@ -67,8 +83,12 @@ void GatewayHandlers::handleRoot(const httplib::Request& /*req*/, httplib::Respo
     endpoints["POST /api/submissions"] = "Upload a submission for plagiarism check";
     endpoints["GET /api/submissions/{id}"] = "Get submission info";
     endpoints["GET /api/submissions/{id}/report"] = "Get plagiarism report for submission";
+    endpoints["GET /api/jobs/{job_id}"] = "Get status of a queued analysis";
     endpoints["GET /api/submissions/{id}/wordcloud"] = "Get word cloud visualization URL";
     endpoints["GET /api/tasks/{task_id}/reports"] = "Get all reports for a task";
+    endpoints["POST /api/tasks/{task_id}/similarity-matrix"] = "Pairwise similarity of all submissions in a task";
+    endpoints["POST /api/tasks/{task_id}/base-files"] = "Register starter code excluded from matching";
+    endpoints["GET /api/tasks/{task_id}/base-files"] = "List starter code files of a task";
     response["endpoints"] = endpoints;
 
     sendJson(res, 200, response.dump(2));
@@ -130,6 +150,7 @@ void GatewayHandlers::handleCreateSubmission(const httplib::Request& req, httpli
     analyzeRequest["task_id"] = taskId;
     analyzeRequest["student_name"] = studentName;
     analyzeRequest["file_hash"] = fileHash;
+    analyzeRequest["filename"] = fileData.value("filename", "");
 
     auto analysisResponse = analysisService_.post("/analyze", analyzeRequest.dump());
 
@@ -142,6 +163,26 @@ void GatewayHandlers::handleCreateSubmission(const httplib::Request& req, httpli
         return;
     }
 
+    // Анализ идёт в очереди: 202 и ссылка на задание
+    if (analysisResponse.status == 202) {
+        json response;
+        response["submission"] = fileData;
+        try {
+            json job = json::parse(analysisResponse.body);
+            response["analysis"] = job;
+            response["job_url"] = "/api/jobs/" + std::to_string(job.value("job_id", 0));
+        } catch (...) {
+            response["analysis"] = nullptr;
+        }
+        response["report_url"] = "/api/submissions/" + std::to_string(submissionId) + "/report";
+        response["word_cloud_url"] = "/api/submissions/" + std::to_string(submissionId) + "/wordcloud";
+
+        std::cout << "[Gateway] Analysis queued for submission " << submissionId << std::endl;
+
+        sendJson(res, 202, response.dump());
+        return;
+    }
+
     if (analysisResponse.status != 201) {
         json response;
         response["submission"] = fileData;
@@ -184,6 +225,14 @@ void GatewayHandlers::handleGetSubmissionReport(const httplib::Request& req, htt
     sendJson(res, response.status, response.body);
 }
 
+void GatewayHandlers::handleGetAnalysisJob(const httplib::Request& req, httplib::Response& res) {
+    std::string id = req.matches[1];
+    std::cout << "[Gateway] GET /api/jobs/" << id << std::endl;
+
+    auto response = analysisService_.get("/jobs/" + id);
+    sendJson(res, response.status, response.body);
+}
+
 void GatewayHandlers::handleGetWordCloud(const httplib::Request& req, httplib::Response& res) {
     std::string id = req.matches[1];
     std::cout << "[Gateway] GET /api/submissions/" << id << "/wordcloud" << std::endl;
@@ -200,6 +249,31 @@ void GatewayHandlers::handleGetTaskReports(const httplib::Request& req, httplib:
     sendJson(res, response.status, response.body);
 }
 
+void GatewayHandlers::handleSimilarityMatrix(const httplib::Request& req, httplib::Response& res) {
+    std::string taskId = req.matches[1];
+    std::cout << "[Gateway] POST /api/tasks/" << taskId << "/similarity-matrix" << std::endl;
+
+    auto response = analysisService_.post("/tasks/" + taskId + "/similarity-matrix",
+                                          req.body.empty() ? "{}" : req.body);
+    sendJson(res, response.status, response.body);
+}
+
+void GatewayHandlers::handleAddBaseFile(const httplib::Request& req, httplib::Response& res) {
+    std::string taskId = req.matches[1];
+    std::cout << "[Gateway] POST /api/tasks/" << taskId << "/base-files" << std::endl;
+
+    auto response = analysisService_.post("/tasks/" + taskId + "/base-files", req.body);
+    sendJson(res, response.status, response.body);
+}
+
+void GatewayHandlers::handleGetBaseFiles(const httplib::Request& req, httplib::Response& res) {
+    std::string taskId = req.matches[1];
+    std::cout << "[Gateway] GET /api/tasks/" << taskId << "/base-files" << std::endl;
+
+    auto response = analysisService_.get("/tasks/" + taskId + "/base-files");
+    sendJson(res, response.status, response.body);
+}
+
 void GatewayHandlers::sendError(httplib::Response& res, int status, const std::string& message) {
     json error;
     error["error"] = message;
@@ -666,6 +740,70 @@ paths:
       responses:
         '200':
           description: Сводка по заданию
+
+  /api/tasks/{task_id}/similarity-matrix:
+    post:
+      tags: [reports]
+      summary: Попарное сходство всех работ задания
+      parameters:
+        - name: task_id
+          in: path
+          required: true
+          schema:
+            type: string
+          example: homework-3
+      requestBody:
+        required: false
+        content:
+          application/json:
+            schema:
+              type: object
+              properties:
+                min_similarity:
+                  type: number
+                  default: 30
+      responses:
+        '200':
+          description: Пары работ со сходством не ниже min_similarity
+
+  /api/tasks/{task_id}/base-files:
+    post:
+      tags: [reports]
+      summary: Добавить файл-заготовку задания
+      parameters:
+        - name: task_id
+          in: path
+          required: true
+          schema:
+            type: string
+          example: homework-3
+      requestBody:
+        required: true
+        content:
+          application/json:
+            schema:
+              type: object
+              required: [filename, content]
+              properties:
+                filename:
+                  type: string
+                content:
+                  type: string
+      responses:
+        '201':
+          description: Заготовка добавлена
+    get:
+      tags: [reports]
+      summary: Файлы-заготовки задания
+      parameters:
+        - name: task_id
+          in: path
+          required: true
+          schema:
+            type: string
+      responses:
+        '200':
+          description: Список заготовок
 )";
     res.status = 200;
     res.set_content(yaml, "text/yaml");
@@ -25,9 +25,13 @@ private:
   void handleGetSubmission(const httplib::Request& req, httplib::Response& res);
   void handleGetSubmissionReport(const httplib::Request& req, httplib::Response& res);
   void handleGetWordCloud(const httplib::Request& req, httplib::Response& res);
+  void handleGetAnalysisJob(const httplib::Request& req, httplib::Response& res);
 
   // Tasks
   void handleGetTaskReports(const httplib::Request& req, httplib::Response& res);
+  void handleSimilarityMatrix(const httplib::Request& req, httplib::Response& res);
+  void handleAddBaseFile(const httplib::Request& req, httplib::Response& res);
+  void handleGetBaseFiles(const httplib::Request& req, httplib::Response& res);
 
   // Utils
   void sendError(httplib::Response& res, int status, const std::string& message);
@@ -0,0 +1,164 @@
+// Бенчмарк фильтров Блума сегментов: поиск отпечатков новой работы по
+// сегментам с фильтром и без него на корпусе размером с поток студентов.
+// Запуск: ./bloom_bench [работ на задание] [заданий] [сегментов] [повторов]
+
+#include "indexing/fingerprintindex.h"
+#include "indexing/segment.h"
+#include "similarity/winnowing.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+// Работа — заготовка задания и строки из общего словаря идиом
+// с мелкими правками: как у настоящих работ, много общих k-грамм
+std::vector<uint32_t> makeSubmission(std::mt19937& rng, const std::vector<std::vector<uint32_t>>& idioms,
+                                     const std::vector<uint32_t>& base, size_t lines) {
+    std::vector<uint32_t> tokens = base;
+    std::geometric_distribution<size_t> popular(0.001);
+    for (size_t l = 0; l < lines; ++l) {
+        const auto& line = idioms[popular(rng) % idioms.size()];
+        for (uint32_t t : line) {
+            tokens.push_back(rng() % 6 == 0 ? rng() % 600 : t);
+        }
+    }
+    return tokens;
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t perTask = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 300;
+    size_t taskCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    size_t segmentCount = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 8;
+    int repeats = argc > 4 ? std::atoi(argv[4]) : 20;
+
+    std::mt19937 rng(42);
+    std::vector<std::vector<uint32_t>> idioms(20000);
+    for (auto& line : idioms) {
+        line.resize(4 + rng() % 8);
+        for (auto& t : line) {
+            t = rng() % 600;
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> bases(taskCount);
+    for (auto& base : bases) {
+        base = makeSubmission(rng, idioms, {}, 20);
+    }
+
+    similarity::Winnowing winnowing;
+    auto directory = std::filesystem::temp_directory_path() / ("bloom_bench_" + std::to_string(::getpid()));
+
+    indexing::FingerprintIndex index;
+    indexing::IndexStorageOptions storage;
+    storage.directory = directory.string();
+    storage.flushInterval = std::chrono::hours(1);
+    storage.maxSegments = segmentCount + 1;
+    index.open(storage);
+
+    // Работы идут по очереди во все задания, сегменты сбрасываются равными порциями
+    size_t total = perTask * taskCount;
+    size_t perSegment = (total + segmentCount - 1) / segmentCount;
+    size_t fingerprintTotal = 0;
+    for (size_t i = 0; i < total; ++i) {
+        size_t task = i % taskCount;
+        auto fingerprints = winnowing.fingerprints(makeSubmission(rng, idioms, bases[task], 120 + rng() % 120));
+        fingerprintTotal += fingerprints.size();
+        index.add("task-" + std::to_string(task), static_cast<int>(i + 1),
+                  "student-" + std::to_string(i / taskCount), fingerprints);
+        if ((i + 1) % perSegment == 0 || i + 1 == total) {
+            index.flush();
+        }
+    }
+
+    // Новые работы: отпечатки, которых в индексе ещё нет
+    std::vector<std::pair<std::string, std::vector<uint64_t>>> queries;
+    size_t queryFingerprints = 0;
+    for (size_t q = 0; q < 50; ++q) {
+        size_t task = q % taskCount;
+        auto fingerprints = winnowing.fingerprints(makeSubmission(rng, idioms, bases[task], 120 + rng() % 120));
+        queryFingerprints += fingerprints.size();
+        queries.emplace_back("task-" + std::to_string(task), std::move(fingerprints));
+    }
+
+    std::vector<std::shared_ptr<const indexing::Segment>> segments;
+    std::ifstream manifest(directory / "MANIFEST");
+    for (std::string name; std::getline(manifest, name);) {
+        segments.push_back(indexing::Segment::open((directory / name).string()));
+    }
+
+    size_t bloomBytes = 0;
+    size_t diskBytes = 0;
+    for (const auto& segment : segments) {
+        bloomBytes += segment->bloomMemoryUsage();
+        diskBytes += segment->fileSize();
+    }
+
+    std::cout << "submissions=" << total << " tasks=" << taskCount << " segments=" << segments.size()
+              << " fingerprints/submission=" << fingerprintTotal / total
+              << " disk=" << diskBytes / 1024 << " KiB bloom=" << bloomBytes / 1024 << " KiB" << std::endl;
+
+    size_t found = 0;
+    size_t rejected = 0;
+    size_t falsePositives = 0;
+    double seconds[2] = {0.0, 0.0};
+
+    for (int useBloom = 0; useBloom < 2; ++useBloom) {
+        size_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            for (const auto& [taskId, fingerprints] : queries) {
+                for (const auto& segment : segments) {
+                    indexing::SegmentTaskRef task = segment->findTask(taskId);
+                    for (uint64_t fp : fingerprints) {
+                        if (useBloom && !segment->mayContain(task, fp)) {
+                            if (r == 0) {
+                                ++rejected;
+                            }
+                            continue;
+                        }
+                        bool hit = !segment->find(task, fp).empty();
+                        hits += hit;
+                        if (useBloom && !hit && r == 0) {
+                            ++falsePositives;
+                        }
+                    }
+                }
+            }
+        }
+        seconds[useBloom] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        found = hits / repeats;
+    }
+
+    double probes = static_cast<double>(queryFingerprints * segments.size());
+    std::cout << "probes=" << static_cast<size_t>(probes) << " found=" << found
+              << " rejected=" << std::fixed << std::setprecision(1) << 100.0 * rejected / probes << "%"
+              << " false positive rate=" << std::setprecision(2)
+              << 100.0 * falsePositives / static_cast<double>(rejected + falsePositives) << "%" << std::endl;
+    for (int useBloom = 0; useBloom < 2; ++useBloom) {
+        std::cout << std::setw(8) << (useBloom ? "bloom" : "no bloom") << ": " << std::setprecision(1)
+                  << seconds[useBloom] * 1e9 / (probes * repeats) << " ns/probe, x"
+                  << std::setprecision(2) << seconds[0] / seconds[useBloom] << std::endl;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& [taskId, fingerprints] : queries) {
+        index.query(taskId, fingerprints);
+    }
+    double queryMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "FingerprintIndex::query: " << std::setprecision(2) << queryMs / queries.size()
+              << " ms/submission" << std::endl;
+
+    segments.clear();
+    std::filesystem::remove_all(directory);
+    return 0;
+}
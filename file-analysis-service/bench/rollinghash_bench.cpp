@@ -0,0 +1,55 @@
+// Бенчмарк ядер rolling hash: GB/s входных токенов для каждого набора инструкций.
+// Запуск: ./rollinghash_bench [токенов] [k] [повторов]
+
+#include "simd/rollinghash.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1u << 20;
+    size_t k = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    int repeats = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    // Поток, похожий на выход токенизатора: в основном мелкие id
+    std::mt19937 rng(42);
+    std::vector<uint32_t> tokens(count);
+    for (auto& t : tokens) {
+        t = rng() % 600;
+    }
+
+    std::vector<uint32_t> reference(simd::kgramCount(count, k));
+    simd::kgramHashes(tokens.data(), count, k, reference.data(), simd::Isa::Scalar);
+
+    std::cout << "tokens=" << count << " k=" << k << " repeats=" << repeats
+              << " best=" << simd::isaName(simd::bestIsa()) << std::endl;
+
+    double scalarSeconds = 0.0;
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::Sse42, simd::Isa::Avx2}) {
+        if (!simd::isaSupported(isa)) {
+            std::cout << std::setw(8) << simd::isaName(isa) << ": not supported" << std::endl;
+            continue;
+        }
+
+        std::vector<uint32_t> out(reference.size());
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            simd::kgramHashes(tokens.data(), count, k, out.data(), isa);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (isa == simd::Isa::Scalar) {
+            scalarSeconds = seconds;
+        }
+
+        double gbPerSecond = static_cast<double>(count) * sizeof(uint32_t) * repeats / seconds / 1e9;
+        std::cout << std::setw(8) << simd::isaName(isa) << ": " << std::fixed << std::setprecision(2)
+                  << gbPerSecond << " GB/s, x" << scalarSeconds / seconds
+                  << (out == reference ? "" : "  MISMATCH") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Бенчмарк планировщика: всплеск загрузок по одному заданию перед дедлайном
+// (в burst раз выше обычного потока) на фоне загрузок по другим заданиям
+// и пакетной перепроверки. Сравнивает ожидание загрузок по другим заданиям
+// с честными очередями и с одной общей очередью (FIFO).
+// Запуск: ./scheduler_bench [потоков] [работа, мс] [кратность всплеска] [секунд]
+
+#include "concurrency/scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Работа анализа — занятость процессора на заданное время
+void burn(std::chrono::microseconds duration) {
+    auto until = Clock::now() + duration;
+    volatile uint64_t sink = 0;
+    while (Clock::now() < until) {
+        for (int i = 0; i < 1000; ++i) {
+            sink = sink + i;
+        }
+    }
+}
+
+struct Latencies {
+    std::mutex mutex;
+    concurrency::DurationHistogram deadlineTask;
+    concurrency::DurationHistogram otherTasks;
+    concurrency::DurationHistogram batch;
+};
+
+void runScenario(const char* name, bool fair, size_t workers, std::chrono::microseconds work,
+                 double burst, double seconds) {
+    concurrency::Scheduler scheduler(workers, std::chrono::milliseconds(500));
+    Latencies latencies;
+
+    // Обычный поток загрузок — половина производительности; всплеск — в burst раз больше
+    double capacity = static_cast<double>(workers) * 1e6 / static_cast<double>(work.count());
+    double baseRate = capacity * 0.5 / 4.0;  // на каждое из 4 заданий
+    std::mt19937 rng(42);
+
+    auto submit = [&](concurrency::Priority priority, const std::string& task,
+                      concurrency::DurationHistogram Latencies::*histogram) {
+        auto enqueued = Clock::now();
+        std::string key = fair ? task : std::string("all");
+        scheduler.submit(fair ? priority : concurrency::Priority::Interactive, key,
+                         [&latencies, histogram, enqueued, work] {
+            burn(work);
+            std::lock_guard lock(latencies.mutex);
+            (latencies.*histogram).record(Clock::now() - enqueued);
+        });
+    };
+
+    auto start = Clock::now();
+    auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    // Всплеск занимает среднюю треть прогона
+    auto burstFrom = start + (end - start) / 3;
+    auto burstTo = start + 2 * (end - start) / 3;
+
+    std::exponential_distribution<double> gap(1.0);
+    auto next = start;
+    while (next < end) {
+        std::this_thread::sleep_until(next);
+        auto now = Clock::now();
+        bool inBurst = now >= burstFrom && now < burstTo;
+
+        double deadlineRate = baseRate * (inBurst ? burst : 1.0);
+        double totalRate = deadlineRate + 3 * baseRate + baseRate * 0.5;
+        double pick = std::uniform_real_distribution<double>(0.0, totalRate)(rng);
+        if (pick < deadlineRate) {
+            submit(concurrency::Priority::Interactive, "deadline", &Latencies::deadlineTask);
+        } else if (pick < deadlineRate + 3 * baseRate) {
+            submit(concurrency::Priority::Interactive, "task-" + std::to_string(rng() % 3),
+                   &Latencies::otherTasks);
+        } else {
+            submit(concurrency::Priority::Batch, "reanalysis", &Latencies::batch);
+        }
+
+        next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(rng) / totalRate));
+    }
+
+    while (scheduler.depth() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(work * 2);
+    scheduler.shutdown();
+
+    auto row = [](const char* label, const concurrency::DurationHistogram& h) {
+        std::cout << "  " << std::left << std::setw(16) << label << std::right
+                  << std::setw(8) << h.count()
+                  << std::setw(12) << std::fixed << std::setprecision(1) << h.percentileMs(0.5)
+                  << std::setw(12) << h.percentileMs(0.99)
+                  << std::setw(12) << h.maxMs() << std::endl;
+    };
+    std::cout << name << std::endl;
+    std::cout << "  " << std::left << std::setw(16) << "class" << std::right << std::setw(8) << "jobs"
+              << std::setw(12) << "p50, ms" << std::setw(12) << "p99, ms" << std::setw(12) << "max, ms"
+              << std::endl;
+    row("deadline task", latencies.deadlineTask);
+    row("other tasks", latencies.otherTasks);
+    row("batch", latencies.batch);
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+    auto work = std::chrono::microseconds(
+        static_cast<long>((argc > 2 ? std::strtod(argv[2], nullptr) : 5.0) * 1000));
+    double burst = argc > 3 ? std::strtod(argv[3], nullptr) : 10.0;
+    double seconds = argc > 4 ? std::strtod(argv[4], nullptr) : 6.0;
+
+    std::cout << "workers " << workers << ", job " << work.count() / 1000.0 << " ms, burst x"
+              << burst << ", " << seconds << " s" << std::endl;
+
+    runScenario("single FIFO queue", false, workers, work, burst, seconds);
+    runScenario("fair queues + priorities", true, workers, work, burst, seconds);
+    return 0;
+}
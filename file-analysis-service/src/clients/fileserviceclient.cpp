@@ -1,76 +1,64 @@
 #include "fileserviceclient.h"
+#include "../utils/hashutils.h"
 #include "httplib.h"
 #include "json.hpp"
 #include <iostream>
 
-using json = nlohmann::json;
-
 namespace clients {
 
+using json = nlohmann::json;
+
 FileServiceClient::FileServiceClient(const std::string& baseUrl) {
     auto [h, p] = parseUrl(baseUrl);
     host_ = h;
     port_ = p;
 }
 
-std::vector<FileInfo> FileServiceClient::findByHash(const std::string& hash) {
+std::string FileServiceClient::getFileContent(int submissionId) {
     httplib::Client client(host_, port_);
     client.set_connection_timeout(5);
-    client.set_read_timeout(5);
-
-    auto response = client.Get(("/files/hash/" + hash).c_str());
+    client.set_read_timeout(10);
 
-    std::vector<FileInfo> result;
+    std::string path = "/files/" + std::to_string(submissionId) + "/content";
+    auto response = client.Get(path.c_str());
 
     if (!response) {
-        std::cerr << "[FileServiceClient] Failed to connect to file service" << std::endl;
-        return result;
+        std::cerr << "[FileServiceClient] Failed to get file content" << std::endl;
+        return "";
     }
 
     if (response->status != 200) {
-        std::cerr << "[FileServiceClient] Error response: " << response->status << std::endl;
-        return result;
-    }
-
-    try {
-        auto data = json::parse(response->body);
-        auto files = data["files"];
-
-        for (const auto& file : files) {
-            FileInfo info;
-            info.id = file["id"];
-            info.studentName = file["student_name"];
-            info.taskId = file["task_id"];
-            info.filename = file["filename"];
-            info.uploadedAt = file["uploaded_at"];
-            result.push_back(info);
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "[FileServiceClient] Failed to parse response: " << e.what() << std::endl;
+        std::cerr << "[FileServiceClient] Error getting content: " << response->status << std::endl;
+        return "";
     }
 
-    return result;
+    return response->body;
 }
 
-std::string FileServiceClient::getFileContent(int submissionId) {
+std::optional<models::Sha256> FileServiceClient::getFileHash(int submissionId) {
     httplib::Client client(host_, port_);
     client.set_connection_timeout(5);
     client.set_read_timeout(10);
 
-    std::string path = "/files/" + std::to_string(submissionId) + "/content";
+    std::string path = "/files/" + std::to_string(submissionId);
     auto response = client.Get(path.c_str());
 
     if (!response) {
-        std::cerr << "[FileServiceClient] Failed to get file content" << std::endl;
-        return "";
+        std::cerr << "[FileServiceClient] Failed to get file info" << std::endl;
+        return std::nullopt;
     }
 
     if (response->status != 200) {
-        std::cerr << "[FileServiceClient] Error getting content: " << response->status << std::endl;
-        return "";
+        std::cerr << "[FileServiceClient] Error getting file info: " << response->status << std::endl;
+        return std::nullopt;
     }
 
-    return response->body;
+    try {
+        return utils::HashUtils::fromHex(json::parse(response->body).value("file_hash", ""));
+    } catch (const std::exception& e) {
+        std::cerr << "[FileServiceClient] Invalid file info: " << e.what() << std::endl;
+        return std::nullopt;
+    }
 }
 
 std::pair<std::string, int> FileServiceClient::parseUrl(const std::string& url) {
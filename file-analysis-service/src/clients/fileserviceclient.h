@@ -1,29 +1,23 @@
 #ifndef FILESERVICECLIENT_H
 #define FILESERVICECLIENT_H
 
+#include "../models/filehash.h"
+#include <optional>
 #include <string>
-#include <vector>
+#include <utility>
 
 namespace clients {
 
-struct FileInfo {
-  int id;
-  std::string studentName;
-  std::string taskId;
-  std::string filename;
-  std::string uploadedAt;
-};
-
 class FileServiceClient {
 public:
   explicit FileServiceClient(const std::string& baseUrl);
 
-  // Найти файлы по хэшу
-  std::vector<FileInfo> findByHash(const std::string& hash);
-
   // Получить содержимое файла по submission_id
   std::string getFileContent(int submissionId);
 
+  // Хэш файла, который File Storing Service хранит для submission_id
+  std::optional<models::Sha256> getFileHash(int submissionId);
+
 private:
   std::pair<std::string, int> parseUrl(const std::string& url);
 
@@ -0,0 +1,112 @@
+#include "shardclient.h"
+#include "httplib.h"
+#include "json.hpp"
+#include <iostream>
+
+using json = nlohmann::json;
+
+namespace clients {
+
+ShardClient::ShardClient(const std::string& baseUrl)
+    : url_(baseUrl)
+{
+    auto [h, p] = parseUrl(baseUrl);
+    host_ = h;
+    port_ = p;
+}
+
+std::vector<indexing::Candidate> ShardClient::query(const std::string& taskId,
+                                                    const std::vector<uint64_t>& fingerprints,
+                                                    size_t minShared) {
+    httplib::Client client(host_, port_);
+    client.set_connection_timeout(2);
+    client.set_read_timeout(5);
+
+    json body;
+    body["task_id"] = taskId;
+    body["fingerprints"] = fingerprints;
+    body["min_shared"] = minShared;
+
+    auto response = client.Post("/shard/query", body.dump(), "application/json");
+
+    std::vector<indexing::Candidate> result;
+
+    if (!response) {
+        std::cerr << "[ShardClient] Failed to connect to shard " << url_ << std::endl;
+        return result;
+    }
+
+    if (response->status != 200) {
+        std::cerr << "[ShardClient] Error response from " << url_ << ": " << response->status << std::endl;
+        return result;
+    }
+
+    try {
+        auto data = json::parse(response->body);
+        for (const auto& c : data["candidates"]) {
+            indexing::Candidate candidate;
+            candidate.submissionId = c["submission_id"];
+            candidate.studentName = c["student_name"];
+            candidate.sharedFingerprints = c["shared_fingerprints"];
+            candidate.fingerprintCount = c["fingerprint_count"];
+            result.push_back(std::move(candidate));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[ShardClient] Failed to parse response: " << e.what() << std::endl;
+        result.clear();
+    }
+
+    return result;
+}
+
+bool ShardClient::add(int64_t completedXid, const std::string& taskId, int submissionId,
+                      const std::string& studentName, const std::vector<uint64_t>& fingerprints,
+                      size_t fingerprintCount) {
+    httplib::Client client(host_, port_);
+    client.set_connection_timeout(2);
+    client.set_read_timeout(5);
+
+    json body;
+    body["completed_xid"] = completedXid;
+    body["task_id"] = taskId;
+    body["submission_id"] = submissionId;
+    body["student_name"] = studentName;
+    body["fingerprints"] = fingerprints;
+    body["fingerprint_count"] = fingerprintCount;
+
+    auto response = client.Post("/shard/add", body.dump(), "application/json");
+
+    if (!response) {
+        std::cerr << "[ShardClient] Failed to connect to shard " << url_ << std::endl;
+        return false;
+    }
+
+    if (response->status != 201) {
+        std::cerr << "[ShardClient] Error response from " << url_ << ": " << response->status << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::pair<std::string, int> ShardClient::parseUrl(const std::string& url) {
+    std::string host = "localhost";
+    int port = 80;
+
+    std::string cleanUrl = url;
+    if (cleanUrl.substr(0, 7) == "http://") {
+        cleanUrl = cleanUrl.substr(7);
+    }
+
+    size_t colonPos = cleanUrl.find(':');
+    if (colonPos != std::string::npos) {
+        host = cleanUrl.substr(0, colonPos);
+        port = std::stoi(cleanUrl.substr(colonPos + 1));
+    } else {
+        host = cleanUrl;
+    }
+
+    return {host, port};
+}
+
+}
@@ -0,0 +1,38 @@
+#ifndef SHARDCLIENT_H
+#define SHARDCLIENT_H
+
+#include "../indexing/fingerprintindex.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace clients {
+
+// Клиент соседнего узла анализа: его диапазон индекса отпечатков
+class ShardClient {
+public:
+  explicit ShardClient(const std::string& baseUrl);
+
+  // Кандидаты из индекса узла; пусто, если узел недоступен
+  std::vector<indexing::Candidate> query(const std::string& taskId,
+                                         const std::vector<uint64_t>& fingerprints,
+                                         size_t minShared);
+
+  // Добавить отпечатки работы из диапазона узла; false, если узел недоступен
+  bool add(int64_t completedXid, const std::string& taskId, int submissionId,
+           const std::string& studentName, const std::vector<uint64_t>& fingerprints,
+           size_t fingerprintCount);
+
+  const std::string& url() const { return url_; }
+
+private:
+  std::pair<std::string, int> parseUrl(const std::string& url);
+
+  std::string url_;
+  std::string host_;
+  int port_;
+};
+
+}
+
+#endif //SHARDCLIENT_H
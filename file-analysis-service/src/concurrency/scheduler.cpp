@@ -0,0 +1,321 @@
+#include "scheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace concurrency {
+
+namespace {
+
+// Планировщик, которому принадлежит текущий поток
+thread_local const Scheduler* tlsScheduler = nullptr;
+
+}
+
+const char* priorityName(Priority priority) {
+    switch (priority) {
+        case Priority::Interactive: return "interactive";
+        case Priority::Batch: return "batch";
+        case Priority::Backfill: return "backfill";
+    }
+    return "interactive";
+}
+
+std::optional<Priority> parsePriority(const std::string& name) {
+    if (name == "interactive") return Priority::Interactive;
+    if (name == "batch") return Priority::Batch;
+    if (name == "backfill") return Priority::Backfill;
+    return std::nullopt;
+}
+
+void DurationHistogram::record(std::chrono::steady_clock::duration duration) {
+    double ms = std::chrono::duration<double, std::milli>(duration).count();
+    size_t index = 0;
+    if (ms >= 1.0) {
+        index = std::min<size_t>(1 + static_cast<size_t>(std::log2(ms)), kBuckets - 1);
+    }
+    ++buckets_[index];
+    ++count_;
+    maxMs_ = std::max(maxMs_, ms);
+}
+
+uint64_t DurationHistogram::count() const {
+    return count_;
+}
+
+uint64_t DurationHistogram::bucket(size_t index) const {
+    return buckets_[index];
+}
+
+double DurationHistogram::upperBoundMs(size_t index) {
+    if (index + 1 >= kBuckets) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return std::ldexp(1.0, static_cast<int>(index));
+}
+
+double DurationHistogram::percentileMs(double fraction) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    auto target = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count_)));
+    target = std::max<uint64_t>(target, 1);
+
+    // Внутри корзины значения считаются равномерно распределёнными,
+    // k-е из n занимает середину своей доли: (k - 0.5) / n
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        if (buckets_[i] == 0 || seen + buckets_[i] < target) {
+            seen += buckets_[i];
+            continue;
+        }
+        double lower = i == 0 ? 0.0 : std::min(upperBoundMs(i - 1), maxMs_);
+        double upper = std::min(upperBoundMs(i), maxMs_);
+        double position = (static_cast<double>(target - seen) - 0.5) / static_cast<double>(buckets_[i]);
+        return lower + (upper - lower) * position;
+    }
+    return maxMs_;
+}
+
+double DurationHistogram::maxMs() const {
+    return maxMs_;
+}
+
+Scheduler::Scheduler(size_t workers, std::chrono::milliseconds agingStep)
+    : agingStep_(agingStep)
+{
+    workers = std::max<size_t>(workers, 1);
+    lowPriorityLimit_ = workers > 1 ? workers - 1 : 1;
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back([this] { runWorker(); });
+    }
+}
+
+Scheduler::~Scheduler() {
+    shutdown();
+}
+
+void Scheduler::shutdown() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // Отброшенные работы run() разбудят своих ждущих через broken_promise
+    std::lock_guard lock(mutex_);
+    for (auto& lane : lanes_) {
+        lane.tasks.clear();
+        lane.ring.clear();
+        lane.byAge.clear();
+        lane.stats.depth = 0;
+    }
+    depth_ = 0;
+}
+
+void Scheduler::submit(Priority priority, const std::string& key, std::function<void()> work) {
+    submit(priority, key, std::move(work), Clock::now());
+}
+
+void Scheduler::submit(Priority priority, const std::string& key, std::function<void()> work,
+                       Clock::time_point enqueued) {
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_) {
+            throw std::runtime_error("Scheduler is stopped");
+        }
+
+        Lane& lane = lanes_[static_cast<size_t>(priority)];
+        Item item;
+        item.seq = nextSeq_++;
+        item.enqueued = enqueued;
+        item.work = std::move(work);
+
+        auto [it, inserted] = lane.tasks.try_emplace(key);
+        if (inserted) {
+            lane.ring.push_back(key);
+        }
+        lane.byAge.emplace(item.enqueued, item.seq, key);
+        it->second.push_back(std::move(item));
+
+        ++lane.stats.submitted;
+        ++lane.stats.depth;
+        ++depth_;
+    }
+    ready_.notify_one();
+}
+
+void Scheduler::run(Priority priority, const std::string& key, const std::function<void()>& work) {
+    if (tlsScheduler == this) {
+        work();
+        return;
+    }
+
+    auto done = std::make_shared<std::promise<void>>();
+    auto future = done->get_future();
+    submit(priority, key, [done, &work] {
+        try {
+            work();
+            done->set_value();
+        } catch (...) {
+            done->set_exception(std::current_exception());
+        }
+    });
+    future.get();
+}
+
+size_t Scheduler::depth() const {
+    std::lock_guard lock(mutex_);
+    return depth_;
+}
+
+SchedulerStats Scheduler::stats() const {
+    std::lock_guard lock(mutex_);
+    SchedulerStats result;
+    result.workers = workers_.size();
+    result.agingStep = agingStep_;
+    for (size_t i = 0; i < kPriorityCount; ++i) {
+        result.classes[i] = lanes_[i].stats;
+        result.classes[i].tasks = lanes_[i].tasks.size();
+    }
+    return result;
+}
+
+bool Scheduler::eligible(size_t lane) const {
+    return lane == 0 || lowPriorityRunning_ < lowPriorityLimit_;
+}
+
+bool Scheduler::pick(Item& item, size_t& lane) {
+    // Класс, чья старейшая работа с поправкой на приоритет ждёт дольше всех
+    std::optional<size_t> best;
+    std::optional<size_t> highest;
+    Clock::time_point bestStart;
+    for (size_t i = 0; i < kPriorityCount; ++i) {
+        if (lanes_[i].byAge.empty() || !eligible(i)) {
+            continue;
+        }
+        if (!highest) {
+            highest = i;
+        }
+        auto start = std::get<0>(*lanes_[i].byAge.begin()) + agingStep_ * static_cast<int>(i);
+        if (!best || start < bestStart) {
+            best = i;
+            bestStart = start;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+
+    lane = *best;
+    Lane& chosen = lanes_[lane];
+    if (lane != *highest) {
+        // Постаревшая работа обгоняет более приоритетные — берём именно её
+        ++chosen.stats.promoted;
+        item = popOldest(chosen);
+    } else {
+        item = popRoundRobin(chosen);
+    }
+    return true;
+}
+
+Scheduler::Item Scheduler::popRoundRobin(Lane& lane) {
+    std::string key = std::move(lane.ring.front());
+    lane.ring.pop_front();
+
+    auto it = lane.tasks.find(key);
+    Item item = std::move(it->second.front());
+    it->second.pop_front();
+    lane.byAge.erase(std::make_tuple(item.enqueued, item.seq, key));
+
+    if (it->second.empty()) {
+        lane.tasks.erase(it);
+    } else {
+        lane.ring.push_back(std::move(key));
+    }
+    return item;
+}
+
+Scheduler::Item Scheduler::popOldest(Lane& lane) {
+    // Очередь задания упорядочена по постановке: старейшая работа — в её начале
+    std::string key = std::get<2>(*lane.byAge.begin());
+    lane.byAge.erase(lane.byAge.begin());
+
+    auto it = lane.tasks.find(key);
+    Item item = std::move(it->second.front());
+    it->second.pop_front();
+
+    if (it->second.empty()) {
+        lane.tasks.erase(it);
+        lane.ring.erase(std::find(lane.ring.begin(), lane.ring.end(), key));
+    }
+    return item;
+}
+
+void Scheduler::runWorker() {
+    tlsScheduler = this;
+
+    while (true) {
+        Item item;
+        size_t lane = 0;
+        {
+            std::unique_lock lock(mutex_);
+            while (!stopping_ && !pick(item, lane)) {
+                ready_.wait(lock);
+            }
+            if (stopping_) {
+                return;
+            }
+
+            auto& stats = lanes_[lane].stats;
+            --stats.depth;
+            ++stats.running;
+            --depth_;
+            if (lane > 0) {
+                ++lowPriorityRunning_;
+            }
+            stats.wait.record(Clock::now() - item.enqueued);
+        }
+
+        try {
+            item.work();
+        } catch (const std::exception& e) {
+            std::cerr << "[Scheduler] " << priorityName(static_cast<Priority>(lane))
+                      << " task failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "[Scheduler] " << priorityName(static_cast<Priority>(lane))
+                      << " task failed" << std::endl;
+        }
+        item.work = nullptr;
+
+        bool freedLowSlot = false;
+        {
+            std::lock_guard lock(mutex_);
+            auto& stats = lanes_[lane].stats;
+            --stats.running;
+            ++stats.completed;
+            stats.latency.record(Clock::now() - item.enqueued);
+            if (lane > 0) {
+                --lowPriorityRunning_;
+                freedLowSlot = true;
+            }
+        }
+        // Освободилось место для фоновых работ — их может взять ждущий поток
+        if (freedLowSlot) {
+            ready_.notify_one();
+        }
+    }
+}
+
+}
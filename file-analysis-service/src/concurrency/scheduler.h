@@ -0,0 +1,149 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace concurrency {
+
+// Классы приоритета: загрузка работы студентом важнее перепроверки
+// пакетом, а та — фоновой дозагрузки
+enum class Priority {
+  Interactive = 0,
+  Batch = 1,
+  Backfill = 2
+};
+
+constexpr size_t kPriorityCount = 3;
+
+const char* priorityName(Priority priority);
+std::optional<Priority> parsePriority(const std::string& name);
+
+// Гистограмма длительностей: корзины по степеням двойки в миллисекундах,
+// [0, 1), [1, 2), [2, 4), ..., последняя — всё, что дольше. Не потокобезопасна.
+class DurationHistogram {
+public:
+  static constexpr size_t kBuckets = 20;
+
+  void record(std::chrono::steady_clock::duration duration);
+
+  uint64_t count() const;
+  uint64_t bucket(size_t index) const;
+  // Верхняя граница корзины, мс; у последней — бесконечность
+  static double upperBoundMs(size_t index);
+  // Оценка квантиля: линейная интерполяция внутри корзины, в которую
+  // он попал; верхняя граница корзины ограничена максимумом
+  double percentileMs(double fraction) const;
+  double maxMs() const;
+
+private:
+  std::array<uint64_t, kBuckets> buckets_{};
+  uint64_t count_ = 0;
+  double maxMs_ = 0.0;
+};
+
+struct PriorityStats {
+  size_t depth = 0;      // ждут выполнения
+  size_t running = 0;    // выполняются
+  size_t tasks = 0;      // заданий с ожидающими работами
+  uint64_t submitted = 0;
+  uint64_t completed = 0;
+  uint64_t promoted = 0; // взяты раньше более приоритетных из-за старения
+  DurationHistogram wait;     // от постановки до начала
+  DurationHistogram latency;  // от постановки до завершения
+};
+
+struct SchedulerStats {
+  size_t workers = 0;
+  std::chrono::milliseconds agingStep{0};
+  std::array<PriorityStats, kPriorityCount> classes;
+};
+
+// Планировщик работ анализа. У каждого класса приоритета по очереди
+// на задание (task_id), задания обслуживаются по кругу, поэтому поток
+// загрузок по одному заданию не задерживает проверки по другим.
+// Старение: работа класса c, ждущая t, соперничает с другими как
+// поставленная в момент (постановка + c * agingStep), так что ждать
+// бесконечно не будет ни одна работа. Работы классов ниже Interactive
+// занимают не больше workers - 1 потоков: один всегда остаётся загрузкам.
+class Scheduler {
+public:
+  // workers == 0 — один поток
+  Scheduler(size_t workers, std::chrono::milliseconds agingStep);
+  ~Scheduler();
+
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  // Поставить работу; исключения из неё только пишутся в лог
+  void submit(Priority priority, const std::string& key, std::function<void()> work);
+
+  // То же для работы, которая ждёт с enqueued (например, с постановки в
+  // очередь в БД): от него считаются старение и гистограммы wait и latency
+  void submit(Priority priority, const std::string& key, std::function<void()> work,
+              std::chrono::steady_clock::time_point enqueued);
+
+  // Выполнить работу через планировщик и дождаться её; исключение
+  // пробрасывается. Из потока планировщика работа выполняется сразу.
+  void run(Priority priority, const std::string& key, const std::function<void()>& work);
+
+  // Остановить потоки; ожидающие работы отбрасываются
+  void shutdown();
+
+  size_t depth() const;
+  SchedulerStats stats() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Item {
+    uint64_t seq = 0;
+    Clock::time_point enqueued;
+    std::function<void()> work;
+  };
+
+  struct Lane {
+    std::unordered_map<std::string, std::deque<Item>> tasks;
+    std::deque<std::string> ring;  // задания с работами, в порядке обслуживания
+    // Ожидающие работы по времени постановки — для старения
+    std::set<std::tuple<Clock::time_point, uint64_t, std::string>> byAge;
+    PriorityStats stats;
+  };
+
+  void runWorker();
+  // Выбрать работу; false — нет работы, которую можно запустить сейчас
+  bool pick(Item& item, size_t& lane);
+  bool eligible(size_t lane) const;
+  Item popRoundRobin(Lane& lane);
+  Item popOldest(Lane& lane);
+
+  std::chrono::milliseconds agingStep_;
+  size_t lowPriorityLimit_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable ready_;
+  std::array<Lane, kPriorityCount> lanes_;
+  size_t depth_ = 0;
+  size_t lowPriorityRunning_ = 0;
+  uint64_t nextSeq_ = 0;
+  bool stopping_ = false;
+
+  std::vector<std::thread> workers_;
+};
+
+}
+
+#endif //SCHEDULER_H
@@ -0,0 +1,229 @@
+#include "threadpool.h"
+#include <algorithm>
+#include <exception>
+
+namespace concurrency {
+
+namespace {
+
+// Какому пулу и какой очереди принадлежит текущий поток
+thread_local const ThreadPool* tlsPool = nullptr;
+thread_local size_t tlsWorker = 0;
+
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this, i] { run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return threads_.size();
+}
+
+size_t ThreadPool::currentWorker() const {
+    return tlsPool == this ? tlsWorker : queues_.size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t target = currentWorker();
+    if (target == queues_.size()) {
+        target = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+
+    // Счётчик меняется под sleepMutex_, иначе пробуждение можно потерять.
+    // Увеличиваем его до публикации задачи: иначе её успеют взять
+    // и уменьшить pending_ раньше, чем он вырос
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        ++pending_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::tryPop(size_t self, std::function<void()>& task) {
+    if (self >= queues_.size()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(queues_[self]->mutex);
+    if (queues_[self]->tasks.empty()) {
+        return false;
+    }
+    task = std::move(queues_[self]->tasks.back());
+    queues_[self]->tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::trySteal(size_t self, std::function<void()>& task) {
+    size_t count = queues_.size();
+    for (size_t offset = 1; offset <= count; ++offset) {
+        size_t victim = (self + offset) % count;
+        if (victim == self) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(queues_[victim]->mutex);
+        if (!queues_[victim]->tasks.empty()) {
+            task = std::move(queues_[victim]->tasks.front());
+            queues_[victim]->tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t self) {
+    tlsPool = this;
+    tlsWorker = self;
+
+    std::function<void()> task;
+    while (true) {
+        if (tryPop(self, task) || trySteal(self, task)) {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                --pending_;
+            }
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+        if (stopping_ && pending_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::spawn(const std::shared_ptr<Join>& join, std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(join->mutex);
+        ++join->remaining;
+    }
+
+    submit([join, task = std::move(task)] {
+        std::exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(join->mutex);
+        if (error && !join->error) {
+            join->error = error;
+        }
+        if (--join->remaining == 0) {
+            join->done.notify_all();
+        }
+    });
+}
+
+void ThreadPool::wait(Join& join) {
+    // Пока ждём — помогаем: выполняем свои и чужие задачи
+    size_t self = currentWorker();
+    std::function<void()> task;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(join.mutex);
+            if (join.remaining == 0) {
+                return;
+            }
+        }
+
+        if (tryPop(self, task) || trySteal(self, task)) {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                --pending_;
+            }
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        // Оставшиеся задачи уже выполняются другими потоками
+        std::unique_lock<std::mutex> lock(join.mutex);
+        join.done.wait(lock, [&join] { return join.remaining == 0; });
+        return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain) {
+    if (count == 0) {
+        return;
+    }
+
+    grain = std::max<size_t>(grain, 1);
+    size_t tasks = std::min((count + grain - 1) / grain, queues_.size() * 4);
+    if (tasks <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    // Индексы вперемешку: соседние, часто похожие по цене, уходят в разные задачи
+    TaskGroup group(*this);
+    for (size_t t = 0; t < tasks; ++t) {
+        group.run([&body, t, tasks, count] {
+            for (size_t i = t; i < count; i += tasks) {
+                body(i);
+            }
+        });
+    }
+    group.wait();
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool_(pool)
+    , join_(std::make_shared<ThreadPool::Join>())
+{}
+
+TaskGroup::~TaskGroup() {
+    pool_.wait(*join_);
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pool_.spawn(join_, std::move(task));
+}
+
+void TaskGroup::wait() {
+    pool_.wait(*join_);
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(join_->mutex);
+        std::swap(error, join_->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}
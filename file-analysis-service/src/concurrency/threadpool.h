@@ -0,0 +1,117 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace concurrency {
+
+// Пул потоков с кражей задач: у каждого рабочего своя очередь, свои задачи
+// он берёт с конца (LIFO, горячий кэш), а простаивающие потоки крадут
+// из начала чужих очередей. Задачи, поставленные изнутри рабочего потока,
+// попадают в его собственную очередь.
+//
+// Все тяжёлые этапы анализа (разбор файлов, проверка кандидатов, расчёт
+// матрицы по заданию) делят один пул по числу ядер: одна большая проверка
+// занимает все ядра, а много мелких не плодят потоков сверх них.
+class ThreadPool {
+public:
+  // threads == 0 — по числу ядер
+  explicit ThreadPool(size_t threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void submit(std::function<void()> task);
+
+  // body(i) для всех i из [0, count); возвращает управление, когда всё
+  // выполнено. Вызывающий поток тоже берёт задачи, поэтому вызов
+  // из рабочего потока не блокирует пул. Первое исключение пробрасывается.
+  // Индексы раздаются не больше чем 4 * size() задачам вперемешку (i, i + n, ...),
+  // а задача получает не меньше grain индексов: дешёвые тела не тонут
+  // в накладных расходах. Если задача одна, body выполняется на месте.
+  void parallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain = 1);
+
+  // Выполнить first и second параллельно (fork/join)
+  template <typename First, typename Second>
+  void invoke(First&& first, Second&& second);
+
+  size_t size() const;
+
+private:
+  friend class TaskGroup;
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // Счётчик незавершённых задач одной группы
+  struct Join {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining = 0;
+    std::exception_ptr error;
+  };
+
+  void spawn(const std::shared_ptr<Join>& join, std::function<void()> task);
+  // Помогать пулу, пока задачи группы не завершатся
+  void wait(Join& join);
+
+  void run(size_t self);
+  bool tryPop(size_t self, std::function<void()>& task);
+  bool trySteal(size_t self, std::function<void()>& task);
+  // Текущий рабочий поток этого пула или size() для внешних потоков
+  size_t currentWorker() const;
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+  size_t pending_ = 0;
+  bool stopping_ = false;
+
+  std::atomic<size_t> nextQueue_{0};
+};
+
+// Группа задач fork/join: run() ставит задачу в пул, wait() ждёт все,
+// выполняя тем временем задачи пула, и пробрасывает первое исключение.
+// Деструктор тоже дожидается задач, но исключения не пробрасывает.
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool& pool);
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void run(std::function<void()> task);
+  void wait();
+
+private:
+  ThreadPool& pool_;
+  std::shared_ptr<ThreadPool::Join> join_;
+};
+
+template <typename First, typename Second>
+void ThreadPool::invoke(First&& first, Second&& second) {
+  TaskGroup group(*this);
+  group.run(std::forward<First>(first));
+  second();
+  group.wait();
+}
+
+}
+
+#endif //THREADPOOL_H
@@ -1,8 +1,25 @@
 #include "config.h"
 #include <cstdlib>
+#include <sstream>
 
 namespace config {
 
+namespace {
+
+std::vector<std::string> splitList(const std::string& value) {
+  std::vector<std::string> items;
+  std::stringstream stream(value);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+}
+
 std::string DatabaseConfig::connectionString() const {
   return "host=" + host + " port=" + port + " dbname=" + name +
          " user=" + user + " password=" + password;
@@ -21,6 +38,14 @@ const ServerConfig& Config::server() const {
   return server_;
 }
 
+const AnalysisConfig& Config::analysis() const {
+  return analysis_;
+}
+
+const ShardConfig& Config::shard() const {
+  return shard_;
+}
+
 Config::Config() {
   // Database config
   db_.host = getEnv("DB_HOST", "localhost");
@@ -32,6 +57,39 @@ Config::Config() {
   // Server config
   server_.port = std::stoi(getEnv("SERVICE_PORT", "8082"));
   server_.fileServiceUrl = getEnv("FILE_SERVICE_URL", "http://file-storing-service:8081");
+
+  // Analysis config
+  analysis_.kgramSize = std::stoul(getEnv("WINNOWING_K", "5"));
+  analysis_.windowSize = std::stoul(getEnv("WINNOWING_WINDOW", "6"));
+  analysis_.plagiarismThreshold = std::stod(getEnv("PLAGIARISM_THRESHOLD", "60"));
+  analysis_.minhashPermutations = std::stoul(getEnv("MINHASH_PERMUTATIONS", "128"));
+  analysis_.lshBands = std::stoul(getEnv("LSH_BANDS", "32"));
+  analysis_.simhashMaxDistance = std::stoi(getEnv("SIMHASH_MAX_DISTANCE", "3"));
+  analysis_.gstMinMatch = std::stoul(getEnv("GST_MIN_MATCH", "8"));
+  analysis_.verifyTopN = std::stoul(getEnv("VERIFY_TOP_N", "3"));
+  analysis_.verifier = getEnv("VERIFY_ALGORITHM", "gst");
+  analysis_.ncdSampleBytes = std::stoul(getEnv("NCD_SAMPLE_BYTES", "32768"));
+  analysis_.workerThreads = std::stoul(getEnv("ANALYSIS_THREADS", "0"));
+  analysis_.queueWorkers = std::stoul(getEnv("ANALYSIS_QUEUE_WORKERS", "2"));
+  analysis_.queueCapacity = std::stoul(getEnv("ANALYSIS_QUEUE_CAPACITY", "1000"));
+  analysis_.queueAgingMs = std::stoul(getEnv("ANALYSIS_QUEUE_AGING_MS", "5000"));
+  analysis_.queueLeaseSeconds = std::stoul(getEnv("ANALYSIS_QUEUE_LEASE_SECONDS", "60"));
+  analysis_.queueMaxAttempts = std::stoul(getEnv("ANALYSIS_QUEUE_MAX_ATTEMPTS", "3"));
+  analysis_.queueRetrySeconds = std::stoul(getEnv("ANALYSIS_QUEUE_RETRY_SECONDS", "5"));
+  analysis_.queuePollMs = std::stoul(getEnv("ANALYSIS_QUEUE_POLL_MS", "500"));
+  analysis_.matrixFloor = std::stod(getEnv("MATRIX_FLOOR", "20"));
+  analysis_.boilerplateMaxDf = std::stod(getEnv("BOILERPLATE_MAX_DF", "50")) / 100.0;
+  analysis_.boilerplateMinSubmissions = std::stoul(getEnv("BOILERPLATE_MIN_SUBMISSIONS", "10"));
+  analysis_.indexDir = getEnv("INDEX_DIR", "");
+  analysis_.indexFlushSeconds = std::stoul(getEnv("INDEX_FLUSH_SECONDS", "30"));
+  analysis_.indexMaxSegments = std::stoul(getEnv("INDEX_MAX_SEGMENTS", "8"));
+  analysis_.bloomBitsPerKey = std::stoul(getEnv("BLOOM_BITS_PER_KEY", "10"));
+  analysis_.snapshotSeconds = std::stoul(getEnv("SNAPSHOT_INTERVAL_SECONDS", "300"));
+
+  // Shard config
+  shard_.shardId = std::stoul(getEnv("SHARD_ID", "0"));
+  shard_.shardCount = std::stoul(getEnv("SHARD_COUNT", "1"));
+  shard_.peers = splitList(getEnv("SHARD_PEERS", ""));
 }
 
 std::string Config::getEnv(const char* name, const char* defaultValue) {
@@ -2,7 +2,9 @@
 #define CONFIG_H
 
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace config {
 
@@ -21,12 +23,50 @@ struct ServerConfig {
   std::string fileServiceUrl;
 };
 
+struct AnalysisConfig {
+  size_t kgramSize;
+  size_t windowSize;
+  double plagiarismThreshold;
+  size_t minhashPermutations;
+  size_t lshBands;
+  int simhashMaxDistance;
+  size_t gstMinMatch;
+  size_t verifyTopN;
+  std::string verifier;  // gst, lcs, edit или ncd
+  size_t ncdSampleBytes; // префикс потока для NCD, байт; 0 — весь поток
+  size_t workerThreads;  // 0 — по числу ядер
+  size_t queueWorkers;   // сколько работ анализируется одновременно
+  size_t queueCapacity;  // сколько работ может ждать в очереди анализа
+  size_t queueAgingMs;   // за столько мс ожидания работа поднимается на класс приоритета
+  size_t queueLeaseSeconds;   // аренда задания; продлевается, пока процесс жив
+  size_t queueMaxAttempts;    // попыток анализа до failed
+  size_t queueRetrySeconds;   // пауза перед повтором, удваивается с каждой попыткой
+  size_t queuePollMs;         // как часто проверять очередь и отчёты других процессов
+  double matrixFloor;    // нижний порог (%) пар в матрице сходства
+  double boilerplateMaxDf;          // доля работ, выше которой отпечаток — шаблон
+  size_t boilerplateMinSubmissions; // с какого числа работ включается порог
+  std::string indexDir;      // каталог сегментов индекса; пусто — только в памяти
+  size_t indexFlushSeconds;  // период сброса новых работ в сегмент
+  size_t indexMaxSegments;   // сколько сегментов допускается до слияния
+  size_t bloomBitsPerKey;    // размер фильтра Блума сегмента на отпечаток
+  size_t snapshotSeconds;    // период снимка индексов в INDEX_DIR; 0 — без снимков
+};
+
+// Разбиение индекса отпечатков по диапазонам хэша между узлами
+struct ShardConfig {
+  size_t shardId;                  // номер этого узла
+  size_t shardCount;               // 1 — без шардирования
+  std::vector<std::string> peers;  // адреса всех узлов по номерам шардов
+};
+
 class Config {
 public:
   static Config& instance();
 
   const DatabaseConfig& database() const;
   const ServerConfig& server() const;
+  const AnalysisConfig& analysis() const;
+  const ShardConfig& shard() const;
 
 private:
   Config();
@@ -34,6 +74,8 @@ private:
 
   DatabaseConfig db_;
   ServerConfig server_;
+  AnalysisConfig analysis_;
+  ShardConfig shard_;
 };
 
 }
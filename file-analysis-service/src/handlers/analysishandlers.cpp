@@ -1,16 +1,84 @@
 #include "analysishandlers.h"
+#include "../utils/hashutils.h"
 #include "json.hpp"
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <stdexcept>
 
 using json = nlohmann::json;
 
 namespace handlers {
 
+namespace {
+
+// Запрос на анализ одной работы; невалидные поля — std::invalid_argument
+service::AnalyzeRequest parseAnalyzeRequest(const json& body) {
+    if (!body.is_object() || !body.contains("submission_id") || !body.contains("task_id") ||
+        !body.contains("student_name")) {
+        throw std::invalid_argument("Fields 'submission_id', 'task_id' and 'student_name' are required");
+    }
+
+    service::AnalyzeRequest request;
+    request.submissionId = body["submission_id"];
+    request.taskId = body["task_id"];
+    request.studentName = body["student_name"];
+    auto fileHash = utils::HashUtils::fromHex(body.value("file_hash", ""));
+    if (!fileHash) {
+        throw std::invalid_argument("Field 'file_hash' must be a hex SHA-256");
+    }
+    request.fileHash = *fileHash;
+    request.filename = body.value("filename", "");
+    return request;
+}
+
+// Необязательное поле "priority": interactive, batch или backfill
+concurrency::Priority parsePriority(const json& body, concurrency::Priority defaultPriority) {
+    if (!body.contains("priority")) {
+        return defaultPriority;
+    }
+    auto priority = body["priority"].is_string()
+        ? concurrency::parsePriority(body["priority"].get<std::string>())
+        : std::nullopt;
+    if (!priority) {
+        throw std::invalid_argument("Field 'priority' must be 'interactive', 'batch' or 'backfill'");
+    }
+    return *priority;
+}
+
+json histogramJson(const concurrency::DurationHistogram& histogram) {
+    json buckets = json::array();
+    for (size_t i = 0; i < concurrency::DurationHistogram::kBuckets; ++i) {
+        json bucket;
+        double bound = concurrency::DurationHistogram::upperBoundMs(i);
+        if (std::isinf(bound)) {
+            bucket["le_ms"] = nullptr;
+        } else {
+            bucket["le_ms"] = bound;
+        }
+        bucket["count"] = histogram.bucket(i);
+        buckets.push_back(bucket);
+    }
+
+    json result;
+    result["count"] = histogram.count();
+    result["p50_ms"] = histogram.percentileMs(0.5);
+    result["p99_ms"] = histogram.percentileMs(0.99);
+    result["max_ms"] = histogram.maxMs();
+    result["buckets"] = buckets;
+    return result;
+}
+
+}
+
 AnalysisHandlers::AnalysisHandlers(service::AnalysisService& analysisService,
+                                   service::AnalysisQueue& queue,
+                                   concurrency::Scheduler& scheduler,
                                    clients::FileServiceClient& fileClient)
     : analysisService_(analysisService)
+    , queue_(queue)
+    , scheduler_(scheduler)
     , fileClient_(fileClient)
 {}
 
@@ -23,6 +91,14 @@ void AnalysisHandlers::registerRoutes(httplib::Server& server) {
         handleAnalyze(req, res);
     });
 
+    server.Post("/analyze/batch", [this](const httplib::Request& req, httplib::Response& res) {
+        handleAnalyzeBatch(req, res);
+    });
+
+    server.Get(R"(/jobs/(\d+))", [this](const httplib::Request& req, httplib::Response& res) {
+        handleGetJob(req, res);
+    });
+
     server.Get(R"(/reports/(\d+))", [this](const httplib::Request& req, httplib::Response& res) {
         handleGetReport(req, res);
     });
@@ -31,6 +107,34 @@ void AnalysisHandlers::registerRoutes(httplib::Server& server) {
         handleGetTaskReports(req, res);
     });
 
+    server.Post(R"(/tasks/([^/]+)/similarity-matrix)", [this](const httplib::Request& req, httplib::Response& res) {
+        handleSimilarityMatrix(req, res);
+    });
+
+    server.Post(R"(/tasks/([^/]+)/base-files)", [this](const httplib::Request& req, httplib::Response& res) {
+        handleAddBaseFile(req, res);
+    });
+
+    server.Get(R"(/tasks/([^/]+)/base-files)", [this](const httplib::Request& req, httplib::Response& res) {
+        handleGetBaseFiles(req, res);
+    });
+
+    server.Get("/index/stats", [this](const httplib::Request& req, httplib::Response& res) {
+        handleIndexStats(req, res);
+    });
+
+    server.Get("/scheduler/stats", [this](const httplib::Request& req, httplib::Response& res) {
+        handleSchedulerStats(req, res);
+    });
+
+    server.Post("/shard/query", [this](const httplib::Request& req, httplib::Response& res) {
+        handleShardQuery(req, res);
+    });
+
+    server.Post("/shard/add", [this](const httplib::Request& req, httplib::Response& res) {
+        handleShardAdd(req, res);
+    });
+
     // Word Cloud endpoint
     server.Get(R"(/submissions/(\d+)/wordcloud)", [this](const httplib::Request& req, httplib::Response& res) {
         handleGetWordCloud(req, res);
@@ -61,32 +165,133 @@ void AnalysisHandlers::handleAnalyze(const httplib::Request& req, httplib::Respo
             return;
         }
 
-        service::AnalyzeRequest analyzeReq;
-        analyzeReq.submissionId = body["submission_id"];
-        analyzeReq.taskId = body["task_id"];
-        analyzeReq.studentName = body["student_name"];
-        analyzeReq.fileHash = body["file_hash"];
+        service::AnalyzeRequest analyzeReq = parseAnalyzeRequest(body);
+        auto priority = parsePriority(body, concurrency::Priority::Interactive);
 
-        auto result = analysisService_.analyze(analyzeReq);
+        auto job = queue_.submit(analyzeReq, priority);
+        if (!job) {
+            sendError(res, 503, "Analysis queue is full, retry later");
+            return;
+        }
 
         json response;
-        response["report_id"] = result.reportId;
-        response["submission_id"] = result.submissionId;
-        response["is_plagiarism"] = result.isPlagiarism;
-        response["similarity_percent"] = result.similarityPercent;
+        response["job_id"] = job->id;
+        response["submission_id"] = job->submissionId;
+        response["priority"] = concurrency::priorityName(job->priority);
+        response["status"] = service::jobStatusName(job->status);
+        response["job_url"] = "/jobs/" + std::to_string(job->id);
+        response["report_url"] = "/reports/" + std::to_string(job->submissionId);
 
-        if (result.originalSubmissionId) {
-            response["original_submission_id"] = *result.originalSubmissionId;
-        } else {
-            response["original_submission_id"] = nullptr;
+        sendJson(res, 202, response.dump());
+
+    } catch (const std::invalid_argument& e) {
+        sendError(res, 400, e.what());
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleAnalyze: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleAnalyzeBatch(const httplib::Request& req, httplib::Response& res) {
+    std::cout << "[AnalysisHandlers] POST /analyze/batch" << std::endl;
+
+    try {
+        json body;
+        try {
+            body = json::parse(req.body);
+        } catch (const std::exception& e) {
+            sendError(res, 400, "Invalid JSON");
+            return;
+        }
+
+        if (!body.contains("submissions") || !body["submissions"].is_array()) {
+            sendError(res, 400, "Field 'submissions' must be an array");
+            return;
+        }
+
+        std::vector<service::AnalyzeRequest> requests;
+        requests.reserve(body["submissions"].size());
+        for (const auto& item : body["submissions"]) {
+            requests.push_back(parseAnalyzeRequest(item));
+        }
+
+        auto priority = parsePriority(body, concurrency::Priority::Batch);
+        // Очередь планировщика — по заданию пакета: импорты разных заданий чередуются
+        std::string key = requests.empty() ? std::string() : requests.front().taskId;
+
+        service::BatchResult batch;
+        scheduler_.run(priority, key, [&] {
+            batch = analysisService_.analyzeBatch(std::move(requests));
+        });
+
+        json results = json::array();
+        for (const auto& result : batch.results) {
+            json r;
+            r["report_id"] = result.reportId;
+            r["submission_id"] = result.submissionId;
+            r["is_plagiarism"] = result.isPlagiarism;
+            r["similarity_percent"] = result.similarityPercent;
+            if (result.originalSubmissionId) {
+                r["original_submission_id"] = *result.originalSubmissionId;
+            } else {
+                r["original_submission_id"] = nullptr;
+            }
+            r["status"] = result.status;
+            results.push_back(r);
         }
 
-        response["status"] = result.status;
+        json response;
+        response["results"] = results;
+        response["count"] = batch.results.size();
+        response["distinct_files"] = batch.distinctFiles;
+        response["elapsed_ms"] = batch.elapsedMs;
 
         sendJson(res, 201, response.dump());
 
+    } catch (const std::invalid_argument& e) {
+        sendError(res, 400, e.what());
     } catch (const std::exception& e) {
-        std::cerr << "[AnalysisHandlers] Error in handleAnalyze: " << e.what() << std::endl;
+        std::cerr << "[AnalysisHandlers] Error in handleAnalyzeBatch: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleGetJob(const httplib::Request& req, httplib::Response& res) {
+    try {
+        int jobId = std::stoi(req.matches[1]);
+        std::cout << "[AnalysisHandlers] GET /jobs/" << jobId << std::endl;
+
+        auto job = queue_.job(jobId);
+        if (!job) {
+            sendError(res, 404, "Job not found");
+            return;
+        }
+
+        json response;
+        response["job_id"] = job->id;
+        response["submission_id"] = job->submissionId;
+        response["priority"] = concurrency::priorityName(job->priority);
+        response["status"] = service::jobStatusName(job->status);
+        response["attempts"] = job->attempts;
+
+        if (job->result) {
+            response["report_id"] = job->result->reportId;
+            response["is_plagiarism"] = job->result->isPlagiarism;
+            response["similarity_percent"] = job->result->similarityPercent;
+            if (job->result->originalSubmissionId) {
+                response["original_submission_id"] = *job->result->originalSubmissionId;
+            } else {
+                response["original_submission_id"] = nullptr;
+            }
+        }
+        if (!job->error.empty()) {
+            response["error"] = job->error;
+        }
+
+        sendJson(res, 200, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleGetJob: " << e.what() << std::endl;
         sendError(res, 500, std::string("Server error: ") + e.what());
     }
 }
@@ -142,6 +347,8 @@ void AnalysisHandlers::handleGetTaskReports(const httplib::Request& req, httplib
         std::cout << "[AnalysisHandlers] GET /tasks/" << taskId << "/reports" << std::endl;
 
         auto reports = analysisService_.getReportsByTask(taskId);
+        // Сходство с другими работами — из поддерживаемой матрицы, без пересчёта
+        auto matches = analysisService_.taskMatches(taskId);
 
         json reportsJson = json::array();
         int plagiarismCount = 0;
@@ -158,6 +365,20 @@ void AnalysisHandlers::handleGetTaskReports(const httplib::Request& req, httplib
             report["status"] = r.status;
             report["created_at"] = r.createdAt;
             report["word_cloud_url"] = "/submissions/" + std::to_string(r.submissionId) + "/wordcloud";
+
+            json matchesJson = json::array();
+            auto it = matches.find(r.submissionId);
+            if (it != matches.end()) {
+                for (const auto& edge : it->second) {
+                    json match;
+                    match["submission_id"] = edge.submissionId;
+                    match["similarity_percent"] = edge.similarityPercent;
+                    match["verified"] = edge.verified;
+                    matchesJson.push_back(match);
+                }
+            }
+            report["matches"] = matchesJson;
+
             reportsJson.push_back(report);
         }
 
@@ -175,6 +396,259 @@ void AnalysisHandlers::handleGetTaskReports(const httplib::Request& req, httplib
     }
 }
 
+void AnalysisHandlers::handleSimilarityMatrix(const httplib::Request& req, httplib::Response& res) {
+    try {
+        std::string taskId = req.matches[1];
+        std::cout << "[AnalysisHandlers] POST /tasks/" << taskId << "/similarity-matrix" << std::endl;
+
+        // Тело необязательно: {"min_similarity": 30}
+        double minSimilarity = 30.0;
+        if (!req.body.empty()) {
+            try {
+                json body = json::parse(req.body);
+                minSimilarity = body.value("min_similarity", minSimilarity);
+            } catch (const std::exception& e) {
+                sendError(res, 400, "Invalid JSON");
+                return;
+            }
+        }
+
+        if (minSimilarity < 0.0 || minSimilarity > 100.0) {
+            sendError(res, 400, "min_similarity must be between 0 and 100");
+            return;
+        }
+
+        // Матрицу ждёт преподаватель: считаем её в классе interactive
+        service::SimilarityMatrix matrix;
+        scheduler_.run(concurrency::Priority::Interactive, taskId, [&] {
+            matrix = analysisService_.similarityMatrix(taskId, minSimilarity);
+        });
+
+        json submissionsJson = json::array();
+        for (const auto& s : matrix.submissions) {
+            json submission;
+            submission["submission_id"] = s.submissionId;
+            submission["student_name"] = s.studentName;
+            submission["fingerprint_count"] = s.fingerprintCount;
+            submissionsJson.push_back(submission);
+        }
+
+        json pairsJson = json::array();
+        for (const auto& p : matrix.pairs) {
+            json pair;
+            pair["first_submission_id"] = p.firstSubmissionId;
+            pair["second_submission_id"] = p.secondSubmissionId;
+            pair["shared_fingerprints"] = p.sharedFingerprints;
+            pair["similarity_percent"] = p.similarityPercent;
+            pairsJson.push_back(pair);
+        }
+
+        json response;
+        response["task_id"] = matrix.taskId;
+        response["total_submissions"] = matrix.submissions.size();
+        response["min_similarity"] = minSimilarity;
+        response["elapsed_ms"] = matrix.elapsedMs;
+        response["submissions"] = submissionsJson;
+        response["pairs"] = pairsJson;
+
+        sendJson(res, 200, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleSimilarityMatrix: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleAddBaseFile(const httplib::Request& req, httplib::Response& res) {
+    try {
+        std::string taskId = req.matches[1];
+        std::cout << "[AnalysisHandlers] POST /tasks/" << taskId << "/base-files" << std::endl;
+
+        if (req.body.empty()) {
+            sendError(res, 400, "Empty request body");
+            return;
+        }
+
+        json body;
+        try {
+            body = json::parse(req.body);
+        } catch (const std::exception& e) {
+            sendError(res, 400, "Invalid JSON");
+            return;
+        }
+
+        std::string filename = body.value("filename", "");
+        std::string content = body.value("content", "");
+        if (filename.empty() || content.empty()) {
+            sendError(res, 400, "Fields 'filename' and 'content' are required");
+            return;
+        }
+
+        auto result = analysisService_.addBaseFile(taskId, filename, content);
+
+        json response;
+        response["id"] = result.id;
+        response["task_id"] = result.taskId;
+        response["filename"] = result.filename;
+        response["fingerprint_count"] = result.fingerprintCount;
+
+        sendJson(res, 201, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleAddBaseFile: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleGetBaseFiles(const httplib::Request& req, httplib::Response& res) {
+    try {
+        std::string taskId = req.matches[1];
+        std::cout << "[AnalysisHandlers] GET /tasks/" << taskId << "/base-files" << std::endl;
+
+        json filesJson = json::array();
+        for (const auto& f : analysisService_.getBaseFiles(taskId)) {
+            json file;
+            file["id"] = f.id;
+            file["filename"] = f.filename;
+            file["size"] = f.content.size();
+            file["created_at"] = f.createdAt;
+            filesJson.push_back(file);
+        }
+
+        json response;
+        response["task_id"] = taskId;
+        response["base_files"] = filesJson;
+
+        sendJson(res, 200, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleGetBaseFiles: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleIndexStats(const httplib::Request& /*req*/, httplib::Response& res) {
+    try {
+        auto stats = analysisService_.indexStats();
+
+        json bloom;
+        bloom["memory_bytes"] = stats.bloomBytes;
+        bloom["segment_probes"] = stats.segmentProbes;
+        bloom["rejected"] = stats.bloomRejected;
+        bloom["false_positives"] = stats.bloomFalsePositives;
+        bloom["false_positive_rate"] = stats.falsePositiveRate;
+
+        json response;
+        response["submissions"] = stats.submissions;
+        response["segments"] = stats.segments;
+        response["memory_bytes"] = stats.memoryBytes;
+        response["disk_bytes"] = stats.diskBytes;
+        response["bloom"] = bloom;
+
+        sendJson(res, 200, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleIndexStats: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleSchedulerStats(const httplib::Request& /*req*/, httplib::Response& res) {
+    try {
+        auto stats = scheduler_.stats();
+
+        json classes;
+        for (size_t i = 0; i < concurrency::kPriorityCount; ++i) {
+            const auto& c = stats.classes[i];
+            json lane;
+            lane["depth"] = c.depth;
+            lane["running"] = c.running;
+            lane["tasks"] = c.tasks;
+            lane["submitted"] = c.submitted;
+            lane["completed"] = c.completed;
+            lane["promoted"] = c.promoted;
+            lane["wait"] = histogramJson(c.wait);
+            lane["latency"] = histogramJson(c.latency);
+            classes[concurrency::priorityName(static_cast<concurrency::Priority>(i))] = lane;
+        }
+
+        json response;
+        response["workers"] = stats.workers;
+        response["aging_step_ms"] = stats.agingStep.count();
+        response["queued_jobs"] = queue_.depth();
+        response["classes"] = classes;
+
+        sendJson(res, 200, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleSchedulerStats: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleShardQuery(const httplib::Request& req, httplib::Response& res) {
+    try {
+        json body;
+        try {
+            body = json::parse(req.body);
+        } catch (const std::exception& e) {
+            sendError(res, 400, "Invalid JSON");
+            return;
+        }
+
+        std::string taskId = body["task_id"];
+        std::vector<uint64_t> fingerprints = body["fingerprints"];
+        size_t minShared = body.value("min_shared", 1);
+
+        json candidatesJson = json::array();
+        for (const auto& c : analysisService_.queryShard(taskId, fingerprints, minShared)) {
+            json candidate;
+            candidate["submission_id"] = c.submissionId;
+            candidate["student_name"] = c.studentName;
+            candidate["shared_fingerprints"] = c.sharedFingerprints;
+            candidate["fingerprint_count"] = c.fingerprintCount;
+            candidatesJson.push_back(candidate);
+        }
+
+        json response;
+        response["candidates"] = candidatesJson;
+
+        sendJson(res, 200, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleShardQuery: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
+void AnalysisHandlers::handleShardAdd(const httplib::Request& req, httplib::Response& res) {
+    try {
+        json body;
+        try {
+            body = json::parse(req.body);
+        } catch (const std::exception& e) {
+            sendError(res, 400, "Invalid JSON");
+            return;
+        }
+
+        int submissionId = body["submission_id"];
+        std::vector<uint64_t> fingerprints = body["fingerprints"];
+        analysisService_.addShardPostings(body["completed_xid"], body["task_id"], submissionId,
+                                          body["student_name"], fingerprints,
+                                          body["fingerprint_count"]);
+
+        json response;
+        response["submission_id"] = submissionId;
+        response["fingerprints"] = fingerprints.size();
+
+        sendJson(res, 201, response.dump());
+
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisHandlers] Error in handleShardAdd: " << e.what() << std::endl;
+        sendError(res, 500, std::string("Server error: ") + e.what());
+    }
+}
+
 void AnalysisHandlers::handleGetWordCloud(const httplib::Request& req, httplib::Response& res) {
     try {
         int submissionId = std::stoi(req.matches[1]);
@@ -2,6 +2,8 @@
 #define ANALYSISHANDLERS_H
 
 #include "../service/analysisservice.h"
+#include "../service/analysisqueue.h"
+#include "../concurrency/scheduler.h"
 #include "../clients/fileserviceclient.h"
 #include "httplib.h"
 
@@ -9,16 +11,30 @@ namespace handlers {
 
 class AnalysisHandlers {
 public:
-  AnalysisHandlers(service::AnalysisService& analysisService,
-                   clients::FileServiceClient& fileClient);
+  AnalysisHandlers(service::AnalysisService& analysisService, service::AnalysisQueue& queue,
+                   concurrency::Scheduler& scheduler, clients::FileServiceClient& fileClient);
 
   void registerRoutes(httplib::Server& server);
 
 private:
   void handleHealth(const httplib::Request& req, httplib::Response& res);
+  // POST /analyze ставит работу в очередь и сразу отвечает 202
   void handleAnalyze(const httplib::Request& req, httplib::Response& res);
+  // Пакет работ: анализ через планировщик (класс batch), ответ — результаты по всем работам
+  void handleAnalyzeBatch(const httplib::Request& req, httplib::Response& res);
+  void handleGetJob(const httplib::Request& req, httplib::Response& res);
   void handleGetReport(const httplib::Request& req, httplib::Response& res);
   void handleGetTaskReports(const httplib::Request& req, httplib::Response& res);
+  void handleSimilarityMatrix(const httplib::Request& req, httplib::Response& res);
+  void handleAddBaseFile(const httplib::Request& req, httplib::Response& res);
+  void handleGetBaseFiles(const httplib::Request& req, httplib::Response& res);
+  void handleIndexStats(const httplib::Request& req, httplib::Response& res);
+  // Глубина очередей и гистограммы ожидания по классам приоритета
+  void handleSchedulerStats(const httplib::Request& req, httplib::Response& res);
+
+  // Диапазон индекса отпечатков для других узлов анализа
+  void handleShardQuery(const httplib::Request& req, httplib::Response& res);
+  void handleShardAdd(const httplib::Request& req, httplib::Response& res);
 
   // Word Cloud endpoint
   void handleGetWordCloud(const httplib::Request& req, httplib::Response& res);
@@ -27,6 +43,8 @@ private:
   void sendJson(httplib::Response& res, int status, const std::string& json);
 
   service::AnalysisService& analysisService_;
+  service::AnalysisQueue& queue_;
+  concurrency::Scheduler& scheduler_;
   clients::FileServiceClient& fileClient_;
 };
 
@@ -0,0 +1,65 @@
+#include "bloomfilter.h"
+#include <algorithm>
+
+namespace indexing {
+
+namespace {
+
+// Нечётные множители для битов в словах блока (из спецификации Parquet)
+constexpr uint32_t kSalts[BloomFilterView::kWordsPerBlock] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u,
+};
+
+// Старшие 32 бита хэша выбирают блок (без деления), младшие — биты в блоке
+size_t blockIndex(uint64_t hash, size_t blockCount) {
+    return static_cast<size_t>(((hash >> 32) * static_cast<uint64_t>(blockCount)) >> 32);
+}
+
+uint32_t bitMask(uint32_t key, size_t word) {
+    return 1u << ((key * kSalts[word]) >> 27);
+}
+
+}
+
+BloomFilterView::BloomFilterView(const uint32_t* blocks, size_t blockCount)
+    : blocks_(blocks)
+    , blockCount_(blockCount) {
+}
+
+bool BloomFilterView::mayContain(uint64_t hash) const {
+    if (blockCount_ == 0) {
+        return true;
+    }
+
+    const uint32_t* block = blocks_ + blockIndex(hash, blockCount_) * kWordsPerBlock;
+    auto key = static_cast<uint32_t>(hash);
+
+    // Без ранних выходов: цикл по 8 словам компилятор разворачивает в SIMD
+    uint32_t missing = 0;
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+        uint32_t mask = bitMask(key, i);
+        missing |= mask & ~block[i];
+    }
+    return missing == 0;
+}
+
+BloomFilter::BloomFilter(size_t keyCount, size_t bitsPerKey) {
+    size_t bits = std::max<size_t>(keyCount * bitsPerKey, 1);
+    size_t blocks = (bits + BloomFilterView::kBlockBytes * 8 - 1) / (BloomFilterView::kBlockBytes * 8);
+    words_.assign(blocks * BloomFilterView::kWordsPerBlock, 0);
+}
+
+void BloomFilter::insert(uint64_t hash) {
+    uint32_t* block = words_.data() + blockIndex(hash, blockCount()) * BloomFilterView::kWordsPerBlock;
+    auto key = static_cast<uint32_t>(hash);
+    for (size_t i = 0; i < BloomFilterView::kWordsPerBlock; ++i) {
+        block[i] |= bitMask(key, i);
+    }
+}
+
+BloomFilterView BloomFilter::view() const {
+    return BloomFilterView(words_.data(), blockCount());
+}
+
+}
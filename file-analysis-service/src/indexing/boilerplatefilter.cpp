@@ -0,0 +1,123 @@
+#include "boilerplatefilter.h"
+#include "snapshot.h"
+#include <mutex>
+
+namespace indexing {
+
+BoilerplateFilter::BoilerplateFilter(double maxDocumentFrequency, size_t minSubmissions)
+    : maxDocumentFrequency_(maxDocumentFrequency)
+    , minSubmissions_(minSubmissions)
+{}
+
+void BoilerplateFilter::addBaseFile(const std::string& taskId,
+                                    const std::vector<uint64_t>& fingerprints,
+                                    std::vector<uint32_t> tokens) {
+    std::unique_lock lock(mutex_);
+
+    TaskState& task = tasks_[taskId];
+    task.excluded.insert(fingerprints.begin(), fingerprints.end());
+    task.baseTokens.push_back(std::make_shared<const std::vector<uint32_t>>(std::move(tokens)));
+}
+
+void BoilerplateFilter::recordSubmission(const std::string& taskId,
+                                         const std::vector<uint64_t>& fingerprints) {
+    std::unique_lock lock(mutex_);
+
+    TaskState& task = tasks_[taskId];
+    ++task.submissions;
+    for (uint64_t fp : fingerprints) {
+        ++task.frequency[fp];
+    }
+}
+
+std::vector<uint64_t> BoilerplateFilter::filter(const std::string& taskId,
+                                                const std::vector<uint64_t>& fingerprints) const {
+    std::shared_lock lock(mutex_);
+
+    auto it = tasks_.find(taskId);
+    if (it == tasks_.end()) {
+        return fingerprints;
+    }
+    const TaskState& task = it->second;
+
+    // Порог по частоте включается, только когда работ достаточно для статистики
+    bool frequencyCutoff = task.submissions >= minSubmissions_ && maxDocumentFrequency_ < 1.0;
+    double maxCount = maxDocumentFrequency_ * static_cast<double>(task.submissions);
+
+    std::vector<uint64_t> result;
+    result.reserve(fingerprints.size());
+    for (uint64_t fp : fingerprints) {
+        if (task.excluded.count(fp)) {
+            continue;
+        }
+        if (frequencyCutoff) {
+            auto freq = task.frequency.find(fp);
+            if (freq != task.frequency.end() && freq->second > maxCount) {
+                continue;
+            }
+        }
+        result.push_back(fp);
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<const std::vector<uint32_t>>>
+BoilerplateFilter::baseTokens(const std::string& taskId) const {
+    std::shared_lock lock(mutex_);
+
+    auto it = tasks_.find(taskId);
+    if (it == tasks_.end()) {
+        return {};
+    }
+    return it->second.baseTokens;
+}
+
+void BoilerplateFilter::save(SnapshotWriter& out) const {
+    std::shared_lock lock(mutex_);
+
+    out.u64(tasks_.size());
+    for (const auto& [taskId, task] : tasks_) {
+        out.string(taskId);
+        out.u64(task.submissions);
+        out.u64s(std::vector<uint64_t>(task.excluded.begin(), task.excluded.end()));
+
+        out.u64(task.frequency.size());
+        for (const auto& [fp, count] : task.frequency) {
+            out.u64(fp);
+            out.u32(count);
+        }
+
+        out.u64(task.baseTokens.size());
+        for (const auto& tokens : task.baseTokens) {
+            out.u32s(*tokens);
+        }
+    }
+}
+
+void BoilerplateFilter::load(SnapshotReader& in) {
+    std::unordered_map<std::string, TaskState> tasks;
+
+    for (uint64_t t = in.u64(); t > 0; --t) {
+        TaskState& task = tasks[in.string()];
+        task.submissions = in.u64();
+
+        std::vector<uint64_t> excluded = in.u64s();
+        task.excluded.insert(excluded.begin(), excluded.end());
+
+        uint64_t frequencies = in.u64();
+        task.frequency.reserve(frequencies);
+        for (; frequencies > 0; --frequencies) {
+            uint64_t fp = in.u64();
+            task.frequency[fp] = in.u32();
+        }
+
+        for (uint64_t n = in.u64(); n > 0; --n) {
+            task.baseTokens.push_back(std::make_shared<const std::vector<uint32_t>>(in.u32s()));
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    tasks_ = std::move(tasks);
+}
+
+}
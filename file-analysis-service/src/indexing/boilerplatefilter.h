@@ -0,0 +1,61 @@
+#ifndef BOILERPLATEFILTER_H
+#define BOILERPLATEFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace indexing {
+
+class SnapshotReader;
+class SnapshotWriter;
+
+// Отсев шаблонного кода задания. Отпечаток считается шаблонным, если он
+// есть в файле-заготовке задания или встречается больше чем в
+// maxDocumentFrequency работ (когда их не меньше minSubmissions).
+// Фильтр применяется и при индексации, и при запросе, поэтому длинные
+// списки «горячих» отпечатков не попадают в генерацию кандидатов.
+class BoilerplateFilter {
+public:
+  explicit BoilerplateFilter(double maxDocumentFrequency = 0.5, size_t minSubmissions = 10);
+
+  // Файл-заготовка: его отпечатки исключаются, токены вырезаются при проверке
+  void addBaseFile(const std::string& taskId, const std::vector<uint64_t>& fingerprints,
+                   std::vector<uint32_t> tokens);
+
+  // Учесть отпечатки новой работы в document frequency
+  void recordSubmission(const std::string& taskId, const std::vector<uint64_t>& fingerprints);
+
+  // Отпечатки без шаблонных (порядок сохраняется)
+  std::vector<uint64_t> filter(const std::string& taskId,
+                               const std::vector<uint64_t>& fingerprints) const;
+
+  // Потоки токенов файлов-заготовок задания
+  std::vector<std::shared_ptr<const std::vector<uint32_t>>> baseTokens(const std::string& taskId) const;
+
+  // Снимок заготовок и document frequency; load заменяет состояние
+  void save(SnapshotWriter& out) const;
+  void load(SnapshotReader& in);
+
+private:
+  struct TaskState {
+    std::unordered_set<uint64_t> excluded;
+    std::unordered_map<uint64_t, uint32_t> frequency;
+    size_t submissions = 0;
+    std::vector<std::shared_ptr<const std::vector<uint32_t>>> baseTokens;
+  };
+
+  double maxDocumentFrequency_;
+  size_t minSubmissions_;
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, TaskState> tasks_;
+};
+
+}
+
+#endif //BOILERPLATEFILTER_H
@@ -0,0 +1,641 @@
+#include "fingerprintindex.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace indexing {
+
+namespace {
+
+constexpr const char* kManifestName = "MANIFEST";
+constexpr const char* kSegmentPrefix = "segment-";
+constexpr const char* kSegmentSuffix = ".seg";
+
+// Номер сегмента из имени segment-000042.seg; 0 — не сегмент
+uint64_t segmentNumber(const std::string& filename) {
+    std::string prefix = kSegmentPrefix;
+    std::string suffix = kSegmentSuffix;
+    if (filename.size() <= prefix.size() + suffix.size() ||
+        filename.compare(0, prefix.size(), prefix) != 0 ||
+        filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        return 0;
+    }
+
+    std::string digits = filename.substr(prefix.size(), filename.size() - prefix.size() - suffix.size());
+    if (digits.find_first_not_of("0123456789") != std::string::npos) {
+        return 0;
+    }
+    return std::stoull(digits);
+}
+
+}
+
+FingerprintIndex::~FingerprintIndex() {
+    {
+        std::lock_guard lock(stopMutex_);
+        stopping_ = true;
+    }
+    stopCv_.notify_all();
+    if (maintenance_.joinable()) {
+        maintenance_.join();
+    }
+}
+
+void FingerprintIndex::open(const IndexStorageOptions& options) {
+    namespace fs = std::filesystem;
+
+    const std::string& directory = options.directory;
+    fs::create_directories(directory);
+
+    SegmentList loaded;
+    std::set<std::string> live;
+
+    std::ifstream manifest(fs::path(directory) / kManifestName);
+    std::string filename;
+    while (std::getline(manifest, filename)) {
+        if (filename.empty()) {
+            continue;
+        }
+        try {
+            loaded.push_back(Segment::open((fs::path(directory) / filename).string()));
+            live.insert(filename);
+        } catch (const std::exception& e) {
+            // Потерянные работы вернёт восстановление из БД
+            std::cerr << "[FingerprintIndex] Skipping segment " << filename << ": " << e.what() << std::endl;
+        }
+    }
+
+    // Незавершённые сбросы и слияния, не попавшие в MANIFEST
+    uint64_t maxNumber = 0;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        std::string name = entry.path().filename().string();
+        uint64_t number = segmentNumber(name);
+        maxNumber = std::max(maxNumber, number);
+
+        bool tmp = name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0;
+        if (tmp || (number > 0 && live.count(name) == 0)) {
+            fs::remove(entry.path());
+        }
+    }
+
+    {
+        std::unique_lock lock(mutex_);
+        segments_ = std::move(loaded);
+    }
+
+    std::lock_guard lock(maintenanceMutex_);
+    directory_ = directory;
+    nextSegmentId_ = maxNumber + 1;
+    flushInterval_ = options.flushInterval;
+    maxSegments_ = std::max<size_t>(options.maxSegments, 1);
+    bloomBitsPerKey_ = options.bloomBitsPerKey;
+
+    if (!maintenance_.joinable()) {
+        maintenance_ = std::thread(&FingerprintIndex::maintenanceLoop, this);
+    }
+}
+
+void FingerprintIndex::add(const std::string& taskId, int submissionId,
+                           const std::string& studentName,
+                           const std::vector<uint64_t>& fingerprints) {
+    add(taskId, submissionId, studentName, fingerprints, fingerprints.size());
+}
+
+void FingerprintIndex::add(const std::string& taskId, int submissionId,
+                           const std::string& studentName,
+                           const std::vector<uint64_t>& fingerprints, size_t fingerprintCount) {
+    std::unique_lock lock(mutex_);
+
+    if (containsLocked(taskId, submissionId)) {
+        return;
+    }
+
+    TaskIndex& task = tasks_[taskId];
+    SubmissionMeta& meta = task.submissions[submissionId];
+    meta.studentName = studentName;
+    meta.fingerprintCount = fingerprintCount;
+
+    for (uint64_t fp : fingerprints) {
+        task.postings[fp].add(static_cast<uint32_t>(submissionId));
+    }
+}
+
+std::vector<Candidate> FingerprintIndex::query(const std::string& taskId,
+                                               const std::vector<uint64_t>& fingerprints,
+                                               size_t minShared) const {
+    std::shared_lock lock(mutex_);
+
+    std::vector<Candidate> result;
+
+    std::vector<const TaskIndex*> memtables;
+    for (const Memtable* memtable : {&tasks_, frozen_.get()}) {
+        if (!memtable) {
+            continue;
+        }
+        auto taskIt = memtable->find(taskId);
+        if (taskIt != memtable->end()) {
+            memtables.push_back(&taskIt->second);
+        }
+    }
+
+    std::vector<std::pair<const Segment*, SegmentTaskRef>> segments;
+    for (const auto& segment : segments_) {
+        SegmentTaskRef task = segment->findTask(taskId);
+        if (task) {
+            segments.emplace_back(segment.get(), task);
+        }
+    }
+    uint64_t probes = 0;
+    uint64_t rejected = 0;
+    uint64_t falsePositives = 0;
+
+    // Список отпечатка — части из изменяемой части и сегментов;
+    // работа лежит ровно в одной из них, так что счётчики складываются
+    struct Lists {
+        size_t size = 0;
+        size_t first = 0;
+        size_t last = 0;
+    };
+    std::vector<PostingView> parts;
+    std::vector<Lists> lists;
+    lists.reserve(fingerprints.size());
+
+    for (uint64_t fp : fingerprints) {
+        Lists list;
+        list.first = parts.size();
+        for (const TaskIndex* task : memtables) {
+            auto postingIt = task->postings.find(fp);
+            if (postingIt != task->postings.end()) {
+                parts.push_back(postingIt->second.view());
+            }
+        }
+        // Большинство отпечатков новой работы не встречалось раньше:
+        // фильтр Блума отсекает их до бинарного поиска по ключам сегмента
+        for (const auto& [segment, task] : segments) {
+            ++probes;
+            if (!segment->mayContain(task, fp)) {
+                ++rejected;
+                continue;
+            }
+            PostingView view = segment->find(task, fp);
+            if (view.empty()) {
+                ++falsePositives;
+                continue;
+            }
+            parts.push_back(view);
+        }
+        list.last = parts.size();
+        for (size_t i = list.first; i < list.last; ++i) {
+            list.size += parts[i].size();
+        }
+        if (list.size > 0) {
+            lists.push_back(list);
+        }
+    }
+
+    segmentProbes_.fetch_add(probes, std::memory_order_relaxed);
+    bloomRejected_.fetch_add(rejected, std::memory_order_relaxed);
+    bloomFalsePositives_.fetch_add(falsePositives, std::memory_order_relaxed);
+
+    minShared = std::max<size_t>(minShared, 1);
+    if (lists.size() < minShared) {
+        return result;
+    }
+
+    // DivideSkip: работа с minShared совпадениями встречается не более чем
+    // в longCount длинных списках, значит в коротких - хотя бы в
+    // minShared - longCount. Короткие сканируем, длинные только проверяем
+    std::sort(lists.begin(), lists.end(), [](const Lists& a, const Lists& b) {
+        return a.size < b.size;
+    });
+    size_t longCount = minShared - 1;
+    size_t shortCount = lists.size() - longCount;
+
+    std::unordered_map<uint32_t, size_t> hits;
+    for (size_t i = 0; i < shortCount; ++i) {
+        for (size_t p = lists[i].first; p < lists[i].last; ++p) {
+            parts[p].forEach([&hits](uint32_t id) { ++hits[id]; });
+        }
+    }
+
+    if (longCount > 0) {
+        size_t shortThreshold = minShared - longCount;
+        std::vector<uint32_t> candidates;
+        for (const auto& [id, shared] : hits) {
+            if (shared >= shortThreshold) {
+                candidates.push_back(id);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (size_t i = shortCount; i < lists.size() && !candidates.empty(); ++i) {
+            for (size_t p = lists[i].first; p < lists[i].last; ++p) {
+                for (uint32_t id : parts[p].intersect(candidates)) {
+                    ++hits[id];
+                }
+            }
+        }
+    }
+
+    result.reserve(hits.size());
+    for (const auto& [id, shared] : hits) {
+        if (shared < minShared) {
+            continue;
+        }
+
+        SegmentSubmission meta;
+        if (!findSubmissionLocked(taskId, static_cast<int>(id), meta)) {
+            continue;
+        }
+
+        Candidate c;
+        c.submissionId = static_cast<int>(id);
+        c.studentName = meta.studentName;
+        c.sharedFingerprints = shared;
+        c.fingerprintCount = meta.fingerprintCount;
+        result.push_back(c);
+    }
+
+    std::sort(result.begin(), result.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.sharedFingerprints != b.sharedFingerprints) {
+            return a.sharedFingerprints > b.sharedFingerprints;
+        }
+        return a.submissionId < b.submissionId;
+    });
+
+    return result;
+}
+
+size_t FingerprintIndex::submissionCount() const {
+    std::shared_lock lock(mutex_);
+
+    size_t count = 0;
+    for (const Memtable* memtable : {&tasks_, frozen_.get()}) {
+        if (!memtable) {
+            continue;
+        }
+        for (const auto& [taskId, task] : *memtable) {
+            count += task.submissions.size();
+        }
+    }
+    for (const auto& segment : segments_) {
+        count += segment->submissionCount();
+    }
+    return count;
+}
+
+size_t FingerprintIndex::memoryUsage() const {
+    std::shared_lock lock(mutex_);
+
+    // Узел хэш-таблицы: ключ, объект списка, указатель next и корзина
+    constexpr size_t kNodeBytes = sizeof(uint64_t) + sizeof(PostingList) + 2 * sizeof(void*);
+
+    size_t bytes = 0;
+    for (const Memtable* memtable : {&tasks_, frozen_.get()}) {
+        if (!memtable) {
+            continue;
+        }
+        for (const auto& [taskId, task] : *memtable) {
+            bytes += task.postings.size() * kNodeBytes;
+            for (const auto& [fp, list] : task.postings) {
+                bytes += list.memoryUsage();
+            }
+        }
+    }
+    return bytes;
+}
+
+size_t FingerprintIndex::segmentCount() const {
+    std::shared_lock lock(mutex_);
+    return segments_.size();
+}
+
+size_t FingerprintIndex::diskUsage() const {
+    std::shared_lock lock(mutex_);
+
+    size_t bytes = 0;
+    for (const auto& segment : segments_) {
+        bytes += segment->fileSize();
+    }
+    return bytes;
+}
+
+IndexStats FingerprintIndex::stats() const {
+    IndexStats stats;
+    stats.submissions = submissionCount();
+    stats.memoryBytes = memoryUsage();
+    {
+        std::shared_lock lock(mutex_);
+        stats.segments = segments_.size();
+        for (const auto& segment : segments_) {
+            stats.diskBytes += segment->fileSize();
+            stats.bloomBytes += segment->bloomMemoryUsage();
+        }
+    }
+
+    stats.segmentProbes = segmentProbes_.load(std::memory_order_relaxed);
+    stats.bloomRejected = bloomRejected_.load(std::memory_order_relaxed);
+    stats.bloomFalsePositives = bloomFalsePositives_.load(std::memory_order_relaxed);
+    uint64_t absent = stats.bloomRejected + stats.bloomFalsePositives;
+    if (absent > 0) {
+        stats.falsePositiveRate = static_cast<double>(stats.bloomFalsePositives) / static_cast<double>(absent);
+    }
+    return stats;
+}
+
+bool FingerprintIndex::flush() {
+    std::lock_guard maintenance(maintenanceMutex_);
+    if (directory_.empty()) {
+        return false;
+    }
+
+    // Сначала повторяем неудавшийся прошлый сброс, затем сбрасываем
+    // текущую часть: после возврата на диске всё, что добавлено до вызова
+    bool flushed = false;
+    for (int pass = 0; pass < 2; ++pass) {
+        std::shared_ptr<const Memtable> frozen;
+        bool retry = false;
+        {
+            std::unique_lock lock(mutex_);
+            retry = frozen_ != nullptr;
+            if (!frozen_) {
+                if (tasks_.empty()) {
+                    break;
+                }
+                frozen_ = std::make_shared<const Memtable>(std::move(tasks_));
+                tasks_.clear();
+            }
+            frozen = frozen_;
+        }
+
+        std::string path = nextSegmentPath();
+        writeSegment(path, *frozen);
+        auto segment = Segment::open(path);
+
+        SegmentList updated;
+        {
+            std::shared_lock lock(mutex_);
+            updated = segments_;
+        }
+        updated.push_back(segment);
+        writeManifest(updated);
+
+        {
+            std::unique_lock lock(mutex_);
+            segments_ = std::move(updated);
+            frozen_.reset();
+        }
+
+        std::cout << "[FingerprintIndex] Flushed " << segment->submissionCount() << " submissions to "
+                  << path << " (" << segment->fileSize() / 1024 << " KiB)" << std::endl;
+        flushed = true;
+        if (!retry) {
+            break;
+        }
+    }
+    return flushed;
+}
+
+bool FingerprintIndex::compact() {
+    std::lock_guard maintenance(maintenanceMutex_);
+    if (directory_.empty()) {
+        return false;
+    }
+
+    // Сегменты меняет только сброс, а он ждёт на maintenanceMutex_
+    SegmentList inputs;
+    {
+        std::shared_lock lock(mutex_);
+        inputs = segments_;
+    }
+    if (inputs.size() < 2) {
+        return false;
+    }
+
+    // Сливаем подряд идущие сегменты с наименьшим суммарным размером, ровно
+    // столько, чтобы осталось maxSegments_: большие сегменты не
+    // переписываются при каждом сбросе. Порядок сегментов сохраняется
+    size_t run = std::max<size_t>(inputs.size() + 1 - std::min(maxSegments_, inputs.size()), 2);
+    size_t first = 0;
+    size_t bestSize = 0;
+    size_t windowSize = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        windowSize += inputs[i]->fileSize();
+        if (i >= run) {
+            windowSize -= inputs[i - run]->fileSize();
+        }
+        if (i + 1 >= run && (i + 1 == run || windowSize < bestSize)) {
+            first = i + 1 - run;
+            bestSize = windowSize;
+        }
+    }
+    SegmentList merging(inputs.begin() + first, inputs.begin() + first + run);
+
+    std::string path = nextSegmentPath();
+    mergeSegments(path, merging);
+    auto merged = Segment::open(path);
+
+    SegmentList updated(inputs.begin(), inputs.begin() + first);
+    updated.push_back(merged);
+    updated.insert(updated.end(), inputs.begin() + first + run, inputs.end());
+    writeManifest(updated);
+
+    {
+        std::unique_lock lock(mutex_);
+        segments_ = std::move(updated);
+    }
+
+    // Отображения живут, пока на сегмент есть ссылки; файлы уже можно удалить
+    for (const auto& segment : merging) {
+        std::remove(segment->path().c_str());
+    }
+
+    std::cout << "[FingerprintIndex] Merged " << merging.size() << " segments into " << path
+              << " (" << merged->fileSize() / 1024 << " KiB)" << std::endl;
+    return true;
+}
+
+bool FingerprintIndex::containsLocked(const std::string& taskId, int submissionId) const {
+    SegmentSubmission ignored;
+    return findSubmissionLocked(taskId, submissionId, ignored);
+}
+
+bool FingerprintIndex::findSubmissionLocked(const std::string& taskId, int submissionId,
+                                            SegmentSubmission& out) const {
+    for (const Memtable* memtable : {&tasks_, frozen_.get()}) {
+        if (!memtable) {
+            continue;
+        }
+        auto taskIt = memtable->find(taskId);
+        if (taskIt == memtable->end()) {
+            continue;
+        }
+        auto it = taskIt->second.submissions.find(submissionId);
+        if (it != taskIt->second.submissions.end()) {
+            out.submissionId = submissionId;
+            out.studentName = it->second.studentName;
+            out.fingerprintCount = it->second.fingerprintCount;
+            return true;
+        }
+    }
+
+    for (const auto& segment : segments_) {
+        if (segment->findSubmission(taskId, submissionId, out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FingerprintIndex::writeSegment(const std::string& path, const Memtable& memtable) const {
+    std::vector<std::string> taskIds;
+    for (const auto& [taskId, task] : memtable) {
+        taskIds.push_back(taskId);
+    }
+    std::sort(taskIds.begin(), taskIds.end());
+
+    SegmentWriter writer(path, bloomBitsPerKey_);
+    for (const auto& taskId : taskIds) {
+        const TaskIndex& task = memtable.at(taskId);
+        writer.beginTask(taskId);
+
+        std::vector<int> ids;
+        for (const auto& [id, meta] : task.submissions) {
+            ids.push_back(id);
+        }
+        std::sort(ids.begin(), ids.end());
+        for (int id : ids) {
+            const SubmissionMeta& meta = task.submissions.at(id);
+            writer.addSubmission({id, meta.studentName, meta.fingerprintCount});
+        }
+
+        std::vector<uint64_t> fingerprints;
+        fingerprints.reserve(task.postings.size());
+        for (const auto& [fp, list] : task.postings) {
+            fingerprints.push_back(fp);
+        }
+        std::sort(fingerprints.begin(), fingerprints.end());
+        for (uint64_t fp : fingerprints) {
+            writer.addPosting(fp, task.postings.at(fp).view());
+        }
+    }
+    writer.finish();
+}
+
+void FingerprintIndex::mergeSegments(const std::string& path, const SegmentList& inputs) const {
+    std::set<std::string> taskIds;
+    for (const auto& segment : inputs) {
+        for (auto& taskId : segment->taskIds()) {
+            taskIds.insert(std::move(taskId));
+        }
+    }
+
+    SegmentWriter writer(path, bloomBitsPerKey_);
+    for (const auto& taskId : taskIds) {
+        writer.beginTask(taskId);
+
+        std::vector<SegmentSubmission> submissions;
+        std::vector<std::pair<uint64_t, PostingView>> postings;
+        for (const auto& segment : inputs) {
+            for (auto& submission : segment->submissions(taskId)) {
+                submissions.push_back(std::move(submission));
+            }
+            for (const auto& posting : segment->postings(taskId)) {
+                postings.push_back(posting);
+            }
+        }
+
+        std::sort(submissions.begin(), submissions.end(),
+                  [](const SegmentSubmission& a, const SegmentSubmission& b) {
+                      return a.submissionId < b.submissionId;
+                  });
+        for (const auto& submission : submissions) {
+            writer.addSubmission(submission);
+        }
+
+        std::stable_sort(postings.begin(), postings.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        // Списки одного отпечатка из разных сегментов не пересекаются:
+        // объединяем и перекодируем, единственный копируем как есть
+        for (size_t i = 0; i < postings.size();) {
+            size_t end = i + 1;
+            while (end < postings.size() && postings[end].first == postings[i].first) {
+                ++end;
+            }
+
+            if (end - i == 1) {
+                writer.addPosting(postings[i].first, postings[i].second);
+            } else {
+                std::vector<uint32_t> ids;
+                for (size_t p = i; p < end; ++p) {
+                    std::vector<uint32_t> part = postings[p].second.decode();
+                    ids.insert(ids.end(), part.begin(), part.end());
+                }
+                std::sort(ids.begin(), ids.end());
+
+                PostingList list;
+                for (uint32_t id : ids) {
+                    list.add(id);
+                }
+                writer.addPosting(postings[i].first, list.view());
+            }
+            i = end;
+        }
+    }
+    writer.finish();
+}
+
+void FingerprintIndex::writeManifest(const SegmentList& segments) const {
+    namespace fs = std::filesystem;
+
+    std::string content;
+    for (const auto& segment : segments) {
+        content += fs::path(segment->path()).filename().string() + "\n";
+    }
+
+    std::string path = (fs::path(directory_) / kManifestName).string();
+    std::string tmpPath = path + ".tmp";
+
+    FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Cannot write " + tmpPath);
+    }
+    bool ok = std::fwrite(content.data(), 1, content.size(), file) == content.size() &&
+              std::fflush(file) == 0 && ::fsync(fileno(file)) == 0;
+    std::fclose(file);
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+std::string FingerprintIndex::nextSegmentPath() {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s%06llu%s", kSegmentPrefix,
+                  static_cast<unsigned long long>(nextSegmentId_++), kSegmentSuffix);
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+void FingerprintIndex::maintenanceLoop() {
+    std::unique_lock lock(stopMutex_);
+    while (!stopCv_.wait_for(lock, flushInterval_, [this] { return stopping_; })) {
+        lock.unlock();
+        try {
+            flush();
+            if (segmentCount() > maxSegments_) {
+                compact();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[FingerprintIndex] Maintenance failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+}
@@ -0,0 +1,151 @@
+#ifndef FINGERPRINTINDEX_H
+#define FINGERPRINTINDEX_H
+
+#include "postinglist.h"
+#include "segment.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace indexing {
+
+// Ранее проиндексированная работа, разделяющая отпечатки с запросом
+struct Candidate {
+  int submissionId = 0;
+  std::string studentName;
+  size_t sharedFingerprints = 0;
+  size_t fingerprintCount = 0;
+};
+
+// Хранение индекса на диске
+struct IndexStorageOptions {
+  std::string directory;
+  std::chrono::seconds flushInterval{30};
+  size_t maxSegments = 8;     // больше — сегменты сливаются
+  size_t bloomBitsPerKey = 10;
+};
+
+// Состояние индекса для мониторинга
+struct IndexStats {
+  size_t submissions = 0;
+  size_t segments = 0;
+  size_t memoryBytes = 0;   // изменяемая часть в куче
+  size_t diskBytes = 0;     // файлы сегментов
+  size_t bloomBytes = 0;    // фильтры Блума сегментов
+  uint64_t segmentProbes = 0;       // поиски отпечатка в сегментах
+  uint64_t bloomRejected = 0;       // отсечены фильтром без поиска по ключам
+  uint64_t bloomFalsePositives = 0; // фильтр пропустил, а отпечатка нет
+  double falsePositiveRate = 0.0;   // доля пропущенных среди отсутствующих
+};
+
+// Инвертированный индекс: отпечаток -> работы задания, в которых он встречается.
+// Поиск стоит O(суммы длин списков для отпечатков запроса) и не зависит
+// от числа работ в задании. Списки хранятся сжатыми (PostingList).
+//
+// С каталогом (open) индекс устроен как LSM: новые работы попадают в
+// небольшую изменяемую часть в памяти, она периодически сбрасывается
+// в неизменяемый файл-сегмент (Segment, mmap), фоновый поток сливает
+// сегменты. Список живых сегментов — в файле MANIFEST.
+class FingerprintIndex {
+public:
+  FingerprintIndex() = default;
+  ~FingerprintIndex();
+
+  FingerprintIndex(const FingerprintIndex&) = delete;
+  FingerprintIndex& operator=(const FingerprintIndex&) = delete;
+
+  // Хранить индекс в каталоге: загрузить сегменты и запустить фоновый
+  // сброс раз в flushInterval; когда сегментов больше maxSegments, они сливаются
+  void open(const IndexStorageOptions& options);
+
+  // Добавить отпечатки работы (повторное добавление игнорируется)
+  void add(const std::string& taskId, int submissionId,
+           const std::string& studentName, const std::vector<uint64_t>& fingerprints);
+
+  // То же для части отпечатков (шард): fingerprintCount — число отпечатков
+  // всей работы, оно возвращается в Candidate::fingerprintCount
+  void add(const std::string& taskId, int submissionId, const std::string& studentName,
+           const std::vector<uint64_t>& fingerprints, size_t fingerprintCount);
+
+  // Работы задания, разделяющие с запросом не меньше minShared отпечатков,
+  // по убыванию числа совпадений. При minShared > 1 самые длинные списки
+  // не сканируются целиком, а только проверяются для найденных кандидатов
+  std::vector<Candidate> query(const std::string& taskId,
+                               const std::vector<uint64_t>& fingerprints,
+                               size_t minShared = 1) const;
+
+  size_t submissionCount() const;
+
+  // Память под списки отпечатков, байт (оценка)
+  size_t memoryUsage() const;
+
+  size_t segmentCount() const;
+  size_t diskUsage() const;
+  IndexStats stats() const;
+
+  // Сбросить изменяемую часть в новый сегмент: после возврата на диске всё,
+  // что добавлено до вызова. false — если нечего сбрасывать или нет каталога
+  bool flush();
+
+  // Слить самые маленькие подряд идущие сегменты так, чтобы их осталось
+  // не больше maxSegments (хотя бы два в один); false — если сливать нечего
+  bool compact();
+
+private:
+  struct SubmissionMeta {
+    std::string studentName;
+    size_t fingerprintCount = 0;
+  };
+
+  struct TaskIndex {
+    std::unordered_map<uint64_t, PostingList> postings;
+    std::unordered_map<int, SubmissionMeta> submissions;
+  };
+
+  using Memtable = std::unordered_map<std::string, TaskIndex>;
+  using SegmentList = std::vector<std::shared_ptr<const Segment>>;
+
+  bool containsLocked(const std::string& taskId, int submissionId) const;
+  bool findSubmissionLocked(const std::string& taskId, int submissionId, SegmentSubmission& out) const;
+
+  void writeSegment(const std::string& path, const Memtable& memtable) const;
+  void mergeSegments(const std::string& path, const SegmentList& inputs) const;
+  void writeManifest(const SegmentList& segments) const;
+  std::string nextSegmentPath();
+  void maintenanceLoop();
+
+  mutable std::shared_mutex mutex_;
+  Memtable tasks_;                          // изменяемая часть
+  std::shared_ptr<const Memtable> frozen_;  // записывается в сегмент
+  SegmentList segments_;
+
+  // Сброс и слияние выполняются по одному
+  std::mutex maintenanceMutex_;
+  std::string directory_;
+  uint64_t nextSegmentId_ = 1;
+  size_t maxSegments_ = 8;
+  size_t bloomBitsPerKey_ = 10;
+
+  mutable std::atomic<uint64_t> segmentProbes_{0};
+  mutable std::atomic<uint64_t> bloomRejected_{0};
+  mutable std::atomic<uint64_t> bloomFalsePositives_{0};
+
+  std::chrono::seconds flushInterval_{30};
+  std::thread maintenance_;
+  std::mutex stopMutex_;
+  std::condition_variable stopCv_;
+  bool stopping_ = false;
+};
+
+}
+
+#endif //FINGERPRINTINDEX_H
@@ -0,0 +1,100 @@
+#include "hashindex.h"
+#include <cstring>
+#include <mutex>
+
+namespace indexing {
+
+namespace {
+
+constexpr size_t kInitialSlots = 1024;
+
+}
+
+HashIndex::HashIndex()
+    : slots_(kInitialSlots)
+{}
+
+void HashIndex::add(const models::Sha256& hash, int submissionId, const std::string& studentName) {
+    std::unique_lock lock(mutex_);
+
+    if ((size_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    Entry entry{submissionId, internStudent(studentName)};
+    Slot& slot = slots_[slotOf(hash)];
+
+    if (slot.first.submissionId == kNoSubmission) {
+        slot.key = hash;
+        slot.first = entry;
+        ++size_;
+        return;
+    }
+
+    if (entry.submissionId < slot.first.submissionId) {
+        // Прежняя первая работа — самая ранняя среди остальных студентов
+        if (entry.student != slot.first.student) {
+            slot.other = slot.first;
+        }
+        slot.first = entry;
+    } else if (entry.student != slot.first.student &&
+               (slot.other.submissionId == kNoSubmission ||
+                entry.submissionId < slot.other.submissionId)) {
+        slot.other = entry;
+    }
+}
+
+std::optional<int> HashIndex::findOriginal(const models::Sha256& hash, int submissionId,
+                                           const std::string& studentName) const {
+    std::shared_lock lock(mutex_);
+
+    const Slot& slot = slots_[slotOf(hash)];
+    if (slot.first.submissionId == kNoSubmission || slot.first.submissionId >= submissionId) {
+        return std::nullopt;
+    }
+
+    auto student = studentIds_.find(studentName);
+    if (student == studentIds_.end() || student->second != slot.first.student) {
+        return slot.first.submissionId;
+    }
+    if (slot.other.submissionId != kNoSubmission && slot.other.submissionId < submissionId) {
+        return slot.other.submissionId;
+    }
+    return std::nullopt;
+}
+
+size_t HashIndex::size() const {
+    std::shared_lock lock(mutex_);
+    return size_;
+}
+
+size_t HashIndex::slotOf(const models::Sha256& hash) const {
+    uint64_t start;
+    std::memcpy(&start, hash.data(), sizeof(start));
+
+    size_t mask = slots_.size() - 1;
+    size_t i = static_cast<size_t>(start) & mask;
+    // Ячейка с этим ключом или первая пустая: пустые есть всегда
+    while (slots_[i].first.submissionId != kNoSubmission && slots_[i].key != hash) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+uint32_t HashIndex::internStudent(const std::string& studentName) {
+    auto it = studentIds_.try_emplace(studentName, static_cast<uint32_t>(studentIds_.size())).first;
+    return it->second;
+}
+
+void HashIndex::grow() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+
+    for (const Slot& slot : old) {
+        if (slot.first.submissionId != kNoSubmission) {
+            slots_[slotOf(slot.key)] = slot;
+        }
+    }
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include "../models/filehash.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace indexing {
+
+// Индекс точных копий: SHA-256 файла -> самые ранние работы с этим хэшем.
+// Открытая адресация с линейным пробированием по 32-байтовым ключам;
+// SHA-256 распределён равномерно, поэтому номер ячейки — его первые 8 байт.
+//
+// На хэш хранятся две работы: самая ранняя и самая ранняя работа другого
+// студента. Этого хватает, чтобы для любого запроса найти самую раннюю
+// более старую работу другого студента — как поиск по всем работам с хэшем.
+class HashIndex {
+public:
+  HashIndex();
+
+  // Добавить работу (повторное добавление ничего не меняет)
+  void add(const models::Sha256& hash, int submissionId, const std::string& studentName);
+
+  // Самая ранняя работа другого студента с тем же хэшем и меньшим submission_id
+  std::optional<int> findOriginal(const models::Sha256& hash, int submissionId,
+                                  const std::string& studentName) const;
+
+  size_t size() const;
+
+private:
+  static constexpr int kNoSubmission = -1;
+
+  struct Entry {
+    int submissionId = kNoSubmission;
+    uint32_t student = 0;  // номер в studentIds_
+  };
+
+  struct Slot {
+    models::Sha256 key{};
+    Entry first;  // самая ранняя работа; kNoSubmission — ячейка пуста
+    Entry other;  // самая ранняя работа другого студента, чем у first
+  };
+
+  size_t slotOf(const models::Sha256& hash) const;
+  uint32_t internStudent(const std::string& studentName);
+  void grow();
+
+  mutable std::shared_mutex mutex_;
+  std::vector<Slot> slots_;  // размер — степень двойки, заполнено не больше половины
+  size_t size_ = 0;
+  std::unordered_map<std::string, uint32_t> studentIds_;
+};
+
+}
+
+#endif //HASHINDEX_H
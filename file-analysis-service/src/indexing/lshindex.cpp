@@ -0,0 +1,138 @@
+#include "lshindex.h"
+#include "snapshot.h"
+#include "../similarity/minhash.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace indexing {
+
+LshIndex::LshIndex(size_t bands)
+    : bands_(std::max<size_t>(bands, 1))
+{}
+
+void LshIndex::add(const std::string& taskId, int submissionId,
+                   const std::string& studentName, const std::vector<uint32_t>& signature) {
+    if (signature.size() < bands_) {
+        return;
+    }
+
+    std::unique_lock lock(mutex_);
+    insert(tasks_[taskId], submissionId, studentName, signature);
+}
+
+std::vector<LshCandidate> LshIndex::query(const std::string& taskId,
+                                          const std::vector<uint32_t>& signature) const {
+    std::vector<LshCandidate> result;
+    if (signature.size() < bands_) {
+        return result;
+    }
+
+    std::shared_lock lock(mutex_);
+
+    auto taskIt = tasks_.find(taskId);
+    if (taskIt == tasks_.end() || taskIt->second.buckets.empty()) {
+        return result;
+    }
+    const TaskIndex& task = taskIt->second;
+
+    std::unordered_set<int> seen;
+    for (size_t band = 0; band < bands_; ++band) {
+        auto bucketIt = task.buckets[band].find(bandKey(signature, band));
+        if (bucketIt == task.buckets[band].end()) {
+            continue;
+        }
+
+        for (int id : bucketIt->second) {
+            if (!seen.insert(id).second) {
+                continue;
+            }
+
+            const SubmissionEntry& entry = task.submissions.at(id);
+
+            LshCandidate c;
+            c.submissionId = id;
+            c.studentName = entry.studentName;
+            c.estimatedJaccard = similarity::MinHash::estimateJaccard(signature, entry.signature);
+            result.push_back(c);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const LshCandidate& a, const LshCandidate& b) {
+        if (a.estimatedJaccard != b.estimatedJaccard) {
+            return a.estimatedJaccard > b.estimatedJaccard;
+        }
+        return a.submissionId < b.submissionId;
+    });
+
+    return result;
+}
+
+void LshIndex::save(SnapshotWriter& out) const {
+    std::shared_lock lock(mutex_);
+
+    out.u64(bands_);
+    out.u64(tasks_.size());
+    for (const auto& [taskId, task] : tasks_) {
+        out.string(taskId);
+        out.u64(task.submissions.size());
+        for (const auto& [id, entry] : task.submissions) {
+            out.i32(id);
+            out.string(entry.studentName);
+            out.u32s(entry.signature);
+        }
+    }
+}
+
+void LshIndex::load(SnapshotReader& in) {
+    if (in.u64() != bands_) {
+        throw std::runtime_error("LSH snapshot has a different number of bands");
+    }
+
+    std::unordered_map<std::string, TaskIndex> tasks;
+    for (uint64_t t = in.u64(); t > 0; --t) {
+        TaskIndex& task = tasks[in.string()];
+        for (uint64_t n = in.u64(); n > 0; --n) {
+            int id = in.i32();
+            std::string studentName = in.string();
+            insert(task, id, studentName, in.u32s());
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    tasks_ = std::move(tasks);
+}
+
+void LshIndex::insert(TaskIndex& task, int submissionId, const std::string& studentName,
+                      const std::vector<uint32_t>& signature) {
+    auto [it, inserted] = task.submissions.try_emplace(submissionId);
+    if (!inserted) {
+        return;
+    }
+
+    it->second.studentName = studentName;
+    it->second.signature = signature;
+
+    if (task.buckets.empty()) {
+        task.buckets.resize(bands_);
+    }
+
+    for (size_t band = 0; band < bands_; ++band) {
+        task.buckets[band][bandKey(signature, band)].push_back(submissionId);
+    }
+}
+
+uint64_t LshIndex::bandKey(const std::vector<uint32_t>& signature, size_t band) const {
+    size_t rows = signature.size() / bands_;
+
+    // FNV-1a по значениям полосы
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = band * rows; i < (band + 1) * rows; ++i) {
+        h ^= signature[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+}
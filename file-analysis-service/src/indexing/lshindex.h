@@ -0,0 +1,65 @@
+#ifndef LSHINDEX_H
+#define LSHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace indexing {
+
+class SnapshotReader;
+class SnapshotWriter;
+
+// Кандидат из LSH с оценкой сходства по MinHash
+struct LshCandidate {
+  int submissionId = 0;
+  std::string studentName;
+  double estimatedJaccard = 0.0;
+};
+
+// Banded LSH над MinHash-сигнатурами: сигнатура режется на bands полос
+// по rows значений, работы с совпавшей полосой попадают в кандидаты.
+// Поиск стоит O(bands) обращений к хэш-таблицам.
+class LshIndex {
+public:
+  explicit LshIndex(size_t bands = 32);
+
+  // Добавить сигнатуру работы (повторное добавление игнорируется)
+  void add(const std::string& taskId, int submissionId,
+           const std::string& studentName, const std::vector<uint32_t>& signature);
+
+  // Кандидаты задания, по убыванию оценки сходства
+  std::vector<LshCandidate> query(const std::string& taskId,
+                                  const std::vector<uint32_t>& signature) const;
+
+  // Снимок: сигнатуры работ, корзины пересобираются при загрузке.
+  // load заменяет содержимое индекса
+  void save(SnapshotWriter& out) const;
+  void load(SnapshotReader& in);
+
+private:
+  struct SubmissionEntry {
+    std::string studentName;
+    std::vector<uint32_t> signature;
+  };
+
+  struct TaskIndex {
+    std::vector<std::unordered_map<uint64_t, std::vector<int>>> buckets;
+    std::unordered_map<int, SubmissionEntry> submissions;
+  };
+
+  void insert(TaskIndex& task, int submissionId, const std::string& studentName,
+              const std::vector<uint32_t>& signature);
+  uint64_t bandKey(const std::vector<uint32_t>& signature, size_t band) const;
+
+  size_t bands_;
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, TaskIndex> tasks_;
+};
+
+}
+
+#endif //LSHINDEX_H
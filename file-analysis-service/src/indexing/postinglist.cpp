@@ -0,0 +1,203 @@
+#include "postinglist.h"
+#include "simd/streamvbyte.h"
+#include <algorithm>
+
+namespace indexing {
+
+namespace {
+
+void appendVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+}
+
+PostingView::PostingView(const PostingSkip* skips, size_t blockCount, const uint8_t* data,
+                         size_t dataBytes, const uint8_t* tail, size_t tailBytes, size_t size)
+    : skips_(skips)
+    , blockCount_(blockCount)
+    , data_(data)
+    , dataBytes_(dataBytes)
+    , tail_(tail)
+    , tailBytes_(tailBytes)
+    , size_(size) {
+}
+
+std::vector<uint32_t> PostingView::decode() const {
+    std::vector<uint32_t> values(size_);
+
+    for (size_t b = 0; b < blockCount_; ++b) {
+        decodeBlock(b, values.data() + b * kBlockSize);
+    }
+    decodeTail(values.data() + blockCount_ * kBlockSize);
+    return values;
+}
+
+std::vector<uint32_t> PostingView::intersect(const std::vector<uint32_t>& sortedIds) const {
+    std::vector<uint32_t> result;
+    if (sortedIds.empty() || size_ == 0) {
+        return result;
+    }
+
+    size_t block = 0;
+    size_t decodedBlock = blockCount_;
+    uint32_t buffer[kBlockSize];
+
+    size_t i = 0;
+    while (i < sortedIds.size() && block < blockCount_) {
+        uint32_t id = sortedIds[i];
+
+        // Галоп по skip-указателям: шаги 1, 2, 4, ... затем бинарный поиск
+        if (skips_[block].last < id) {
+            size_t step = 1;
+            size_t low = block + 1;
+            size_t high = low;
+            while (high < blockCount_ && skips_[high].last < id) {
+                low = high + 1;
+                step *= 2;
+                high = block + step;
+            }
+            high = std::min(high + 1, blockCount_);
+            block = std::lower_bound(skips_ + low, skips_ + high, id,
+                                     [](const PostingSkip& s, uint32_t v) { return s.last < v; })
+                    - skips_;
+            if (block >= blockCount_) {
+                break;
+            }
+        }
+
+        if (decodedBlock != block) {
+            decodeBlock(block, buffer);
+            decodedBlock = block;
+        }
+        if (std::binary_search(buffer, buffer + kBlockSize, id)) {
+            result.push_back(id);
+        }
+        ++i;
+    }
+
+    if (i < sortedIds.size() && tailBytes_ > 0) {
+        std::vector<uint32_t> tail(size_ - blockCount_ * kBlockSize);
+        decodeTail(tail.data());
+        for (; i < sortedIds.size(); ++i) {
+            if (std::binary_search(tail.begin(), tail.end(), sortedIds[i])) {
+                result.push_back(sortedIds[i]);
+            }
+        }
+    }
+
+    return result;
+}
+
+void PostingView::decodeBlock(size_t block, uint32_t* out) const {
+    uint32_t base = block > 0 ? skips_[block - 1].last : 0;
+    simd::streamVByteDecodeDelta(data_ + skips_[block].offset, kBlockSize, base, out);
+}
+
+void PostingView::decodeTail(uint32_t* out) const {
+    uint32_t previous = blockCount_ > 0 ? skips_[blockCount_ - 1].last : 0;
+    uint32_t delta = 0;
+    int shift = 0;
+    for (size_t i = 0; i < tailBytes_; ++i) {
+        uint8_t byte = tail_[i];
+        delta |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (byte & 0x80) {
+            shift += 7;
+            continue;
+        }
+        previous += delta;
+        *out++ = previous;
+        delta = 0;
+        shift = 0;
+    }
+}
+
+void PostingList::add(uint32_t id) {
+    if (size_ > 0 && id <= last_) {
+        // Редкий случай (параллельный анализ): вставка в середину — пересборка
+        std::vector<uint32_t> values = decode();
+        auto it = std::lower_bound(values.begin(), values.end(), id);
+        if (it != values.end() && *it == id) {
+            return;
+        }
+        values.insert(it, id);
+        rebuild(values);
+        return;
+    }
+
+    appendVarint(tail_, id - last_);
+    last_ = id;
+    ++size_;
+
+    if (size_ % kBlockSize == 0) {
+        uint32_t values[kBlockSize];
+        view().decodeTail(values);
+        appendBlock(values);
+        tail_.clear();
+        tail_.shrink_to_fit();
+    }
+}
+
+PostingView PostingList::view() const {
+    const auto* tail = reinterpret_cast<const uint8_t*>(tail_.data());
+    if (!blocks_) {
+        return PostingView(nullptr, 0, nullptr, 0, tail, tail_.size(), size_);
+    }
+    return PostingView(blocks_->skips.data(), blocks_->skips.size(), blocks_->data.data(),
+                       blocks_->data.size() - simd::kStreamVByteOverread, tail, tail_.size(), size_);
+}
+
+size_t PostingList::memoryUsage() const {
+    size_t bytes = tail_.capacity() > 15 ? tail_.capacity() : 0;
+    if (blocks_) {
+        bytes += sizeof(Blocks) + blocks_->skips.capacity() * sizeof(PostingSkip) + blocks_->data.capacity();
+    }
+    return bytes;
+}
+
+void PostingList::appendBlock(const uint32_t* values) {
+    if (!blocks_) {
+        blocks_ = std::make_unique<Blocks>();
+    }
+
+    uint32_t base = blocks_->skips.empty() ? 0 : blocks_->skips.back().last;
+
+    // Запас для декодера в конце буфера держим всегда
+    auto& data = blocks_->data;
+    size_t offset = data.empty() ? 0 : data.size() - simd::kStreamVByteOverread;
+    data.resize(offset + simd::streamVByteMaxBytes(kBlockSize) + simd::kStreamVByteOverread);
+    size_t written = simd::streamVByteEncodeDelta(values, kBlockSize, base, data.data() + offset);
+    data.resize(offset + written + simd::kStreamVByteOverread);
+    std::fill(data.end() - simd::kStreamVByteOverread, data.end(), 0);
+
+    blocks_->skips.push_back({values[kBlockSize - 1], static_cast<uint32_t>(offset)});
+}
+
+void PostingList::rebuild(const std::vector<uint32_t>& values) {
+    blocks_.reset();
+    tail_.clear();
+    size_ = 0;
+    last_ = 0;
+
+    size_t fullBlocks = values.size() / kBlockSize;
+    for (size_t b = 0; b < fullBlocks; ++b) {
+        appendBlock(values.data() + b * kBlockSize);
+    }
+    size_ = static_cast<uint32_t>(fullBlocks * kBlockSize);
+    last_ = fullBlocks > 0 ? values[fullBlocks * kBlockSize - 1] : 0;
+
+    for (size_t i = fullBlocks * kBlockSize; i < values.size(); ++i) {
+        appendVarint(tail_, values[i] - last_);
+        last_ = values[i];
+        ++size_;
+    }
+    if (blocks_) {
+        blocks_->data.shrink_to_fit();
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+#ifndef POSTINGLIST_H
+#define POSTINGLIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace indexing {
+
+// Skip-указатель блока: последнее значение и начало блока в данных
+struct PostingSkip {
+  uint32_t last;
+  uint32_t offset;
+};
+
+// Список id только для чтения поверх чужой памяти: блоков PostingList
+// или сегмента на диске (формат один и тот же).
+// За данными должно быть не меньше kStreamVByteOverread доступных байт.
+class PostingView {
+public:
+  static constexpr size_t kBlockSize = 128;
+
+  PostingView() = default;
+  PostingView(const PostingSkip* skips, size_t blockCount, const uint8_t* data, size_t dataBytes,
+              const uint8_t* tail, size_t tailBytes, size_t size);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Все id по возрастанию
+  std::vector<uint32_t> decode() const;
+
+  template <typename F>
+  void forEach(F&& f) const {
+    std::vector<uint32_t> values = decode();
+    for (uint32_t v : values) {
+      f(v);
+    }
+  }
+
+  // Какие из отсортированных ids есть в списке: галоп по skip-указателям,
+  // декодируются только блоки, в которые попадает запрос
+  std::vector<uint32_t> intersect(const std::vector<uint32_t>& sortedIds) const;
+
+  // Значения после полных блоков (size() % kBlockSize штук)
+  void decodeTail(uint32_t* out) const;
+
+  const PostingSkip* skips() const { return skips_; }
+  size_t blockCount() const { return blockCount_; }
+  const uint8_t* data() const { return data_; }
+  size_t dataBytes() const { return dataBytes_; }
+  const uint8_t* tail() const { return tail_; }
+  size_t tailBytes() const { return tailBytes_; }
+
+private:
+  void decodeBlock(size_t block, uint32_t* out) const;
+
+  const PostingSkip* skips_ = nullptr;
+  size_t blockCount_ = 0;
+  const uint8_t* data_ = nullptr;
+  size_t dataBytes_ = 0;
+  const uint8_t* tail_ = nullptr;
+  size_t tailBytes_ = 0;
+  size_t size_ = 0;
+};
+
+// Сжатый список работ для одного отпечатка: возрастающие id.
+// Полные блоки по kBlockSize значений хранятся в StreamVByte (разности,
+// SIMD-декодирование), для каждого блока есть skip-указатель.
+// Хвост короче блока — varint-разности в std::string: короткие списки
+// (а их большинство) умещаются в SSO и не требуют отдельного выделения памяти.
+class PostingList {
+public:
+  static constexpr size_t kBlockSize = PostingView::kBlockSize;
+
+  // Добавить id; обычно id растут, вставка в середину тоже поддерживается
+  void add(uint32_t id);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  PostingView view() const;
+
+  std::vector<uint32_t> decode() const { return view().decode(); }
+
+  template <typename F>
+  void forEach(F&& f) const {
+    view().forEach(std::forward<F>(f));
+  }
+
+  std::vector<uint32_t> intersect(const std::vector<uint32_t>& sortedIds) const {
+    return view().intersect(sortedIds);
+  }
+
+  // Занимаемая память (без самого объекта)
+  size_t memoryUsage() const;
+
+private:
+  struct Blocks {
+    std::vector<PostingSkip> skips;
+    // Код блоков плюс kStreamVByteOverread байт запаса для декодера
+    std::vector<uint8_t> data;
+  };
+
+  void appendBlock(const uint32_t* values);
+  void rebuild(const std::vector<uint32_t>& values);
+
+  std::unique_ptr<Blocks> blocks_;
+  std::string tail_;
+  uint32_t size_ = 0;
+  uint32_t last_ = 0;
+};
+
+}
+
+#endif //POSTINGLIST_H
@@ -0,0 +1,403 @@
+#include "segment.h"
+#include "simd/streamvbyte.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace indexing {
+
+namespace detail {
+
+constexpr char kSegmentMagic[8] = {'A', 'F', 'S', 'E', 'G', 'M', 'N', 'T'};
+constexpr uint32_t kSegmentVersion = 2;
+
+struct SegmentHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t taskCount;
+  uint64_t submissionCount;
+  uint64_t keyCount;
+  uint64_t tasksOffset;
+  uint64_t submissionsOffset;
+  uint64_t keysOffset;
+  uint64_t stringsOffset;
+  uint64_t bloomOffset;
+  uint64_t bloomBlocks;
+  uint64_t postingsOffset;
+  uint64_t fileSize;
+};
+
+struct SegmentTask {
+  uint32_t nameOffset;
+  uint32_t nameLength;
+  uint64_t firstSubmission;
+  uint64_t submissionCount;
+  uint64_t firstKey;
+  uint64_t keyCount;
+};
+
+struct SegmentSubmissionEntry {
+  int32_t submissionId;
+  uint32_t fingerprintCount;
+  uint32_t nameOffset;
+  uint32_t nameLength;
+};
+
+// Список: skip-указатели, блоки StreamVByte, varint-хвост (смещение от начала списков)
+struct SegmentKey {
+  uint64_t fingerprint;
+  uint64_t offset;
+  uint32_t size;
+  uint32_t blockCount;
+  uint32_t dataBytes;
+  uint32_t tailBytes;
+};
+
+}
+
+namespace {
+
+using detail::SegmentHeader;
+using detail::SegmentKey;
+using detail::SegmentSubmissionEntry;
+using detail::SegmentTask;
+
+template <typename T>
+void appendRaw(std::vector<uint8_t>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// Выравнивание секций и списков: skip-указатели читаются прямо из mmap
+size_t align8(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+}
+
+std::shared_ptr<const Segment> Segment::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open segment " + path);
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SegmentHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Segment too small: " + path);
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot mmap segment " + path);
+    }
+
+    std::shared_ptr<Segment> segment(new Segment());
+    segment->path_ = path;
+    segment->base_ = static_cast<const uint8_t*>(mapped);
+    segment->size_ = size;
+
+    const auto* header = reinterpret_cast<const SegmentHeader*>(segment->base_);
+    if (std::memcmp(header->magic, detail::kSegmentMagic, sizeof(header->magic)) != 0 ||
+        header->version != detail::kSegmentVersion || header->fileSize != size) {
+        throw std::runtime_error("Bad segment header: " + path);
+    }
+
+    // Секции идут подряд и помещаются в файл
+    if (header->tasksOffset + header->taskCount * sizeof(SegmentTask) > header->submissionsOffset ||
+        header->submissionsOffset + header->submissionCount * sizeof(SegmentSubmissionEntry) >
+            header->keysOffset ||
+        header->keysOffset + header->keyCount * sizeof(SegmentKey) > header->stringsOffset ||
+        header->stringsOffset > header->bloomOffset ||
+        header->bloomOffset + header->bloomBlocks * BloomFilterView::kBlockBytes > header->postingsOffset ||
+        header->postingsOffset + simd::kStreamVByteOverread > size) {
+        throw std::runtime_error("Corrupted segment layout: " + path);
+    }
+
+    segment->header_ = header;
+    segment->tasks_ = reinterpret_cast<const SegmentTask*>(segment->base_ + header->tasksOffset);
+    segment->submissions_ = reinterpret_cast<const SegmentSubmissionEntry*>(
+        segment->base_ + header->submissionsOffset);
+    segment->keys_ = reinterpret_cast<const SegmentKey*>(segment->base_ + header->keysOffset);
+    segment->strings_ = reinterpret_cast<const char*>(segment->base_ + header->stringsOffset);
+    segment->postings_ = segment->base_ + header->postingsOffset;
+    segment->bloom_ = BloomFilterView(
+        reinterpret_cast<const uint32_t*>(segment->base_ + header->bloomOffset), header->bloomBlocks);
+
+    // Поиск по ключам — случайный доступ, упреждающее чтение не нужно
+    ::madvise(mapped, size, MADV_RANDOM);
+
+    return segment;
+}
+
+Segment::~Segment() {
+    if (base_) {
+        ::munmap(const_cast<uint8_t*>(base_), size_);
+    }
+}
+
+size_t Segment::submissionCount() const {
+    return header_->submissionCount;
+}
+
+SegmentTaskRef Segment::findTask(const std::string& taskId) const {
+    const SegmentTask* first = tasks_;
+    const SegmentTask* last = tasks_ + header_->taskCount;
+    const SegmentTask* it = std::lower_bound(first, last, taskId,
+                                             [this](const SegmentTask& task, const std::string& id) {
+                                                 return std::string_view(strings_ + task.nameOffset,
+                                                                         task.nameLength) < id;
+                                             });
+    if (it == last || std::string_view(strings_ + it->nameOffset, it->nameLength) != taskId) {
+        return {};
+    }
+    return {it, taskHash(taskId)};
+}
+
+bool Segment::mayContain(const SegmentTaskRef& task, uint64_t fingerprint) const {
+    return task && bloom_.mayContain(bloomKey(task.hash, fingerprint));
+}
+
+PostingView Segment::find(const SegmentTaskRef& task, uint64_t fingerprint) const {
+    if (!task) {
+        return {};
+    }
+
+    const SegmentKey* first = keys_ + task.entry->firstKey;
+    const SegmentKey* last = first + task.entry->keyCount;
+    const SegmentKey* it = std::lower_bound(first, last, fingerprint,
+                                            [](const SegmentKey& key, uint64_t fp) {
+                                                return key.fingerprint < fp;
+                                            });
+    if (it == last || it->fingerprint != fingerprint) {
+        return {};
+    }
+    return postingAt(*it);
+}
+
+uint64_t Segment::taskHash(const std::string& taskId) {
+    // FNV-1a: значение записано в файл и не должно зависеть от сборки
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : taskId) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t Segment::bloomKey(uint64_t taskHash, uint64_t fingerprint) {
+    // splitmix64: отпечатки разных заданий не должны делить биты фильтра
+    uint64_t x = fingerprint ^ taskHash;
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+bool Segment::contains(const std::string& taskId, int submissionId) const {
+    SegmentSubmission ignored;
+    return findSubmission(taskId, submissionId, ignored);
+}
+
+bool Segment::findSubmission(const std::string& taskId, int submissionId, SegmentSubmission& out) const {
+    SegmentTaskRef task = findTask(taskId);
+    if (!task) {
+        return false;
+    }
+
+    const SegmentSubmissionEntry* first = submissions_ + task.entry->firstSubmission;
+    const SegmentSubmissionEntry* last = first + task.entry->submissionCount;
+    const SegmentSubmissionEntry* it = std::lower_bound(
+        first, last, submissionId,
+        [](const SegmentSubmissionEntry& entry, int id) { return entry.submissionId < id; });
+    if (it == last || it->submissionId != submissionId) {
+        return false;
+    }
+
+    out.submissionId = it->submissionId;
+    out.studentName = name(it->nameOffset, it->nameLength);
+    out.fingerprintCount = it->fingerprintCount;
+    return true;
+}
+
+std::vector<std::string> Segment::taskIds() const {
+    std::vector<std::string> result;
+    result.reserve(header_->taskCount);
+    for (uint32_t i = 0; i < header_->taskCount; ++i) {
+        result.push_back(name(tasks_[i].nameOffset, tasks_[i].nameLength));
+    }
+    return result;
+}
+
+std::vector<SegmentSubmission> Segment::submissions(const std::string& taskId) const {
+    std::vector<SegmentSubmission> result;
+    SegmentTaskRef task = findTask(taskId);
+    if (!task) {
+        return result;
+    }
+
+    result.reserve(task.entry->submissionCount);
+    for (uint64_t i = 0; i < task.entry->submissionCount; ++i) {
+        const SegmentSubmissionEntry& entry = submissions_[task.entry->firstSubmission + i];
+        result.push_back({entry.submissionId, name(entry.nameOffset, entry.nameLength),
+                          entry.fingerprintCount});
+    }
+    return result;
+}
+
+std::vector<std::pair<uint64_t, PostingView>> Segment::postings(const std::string& taskId) const {
+    std::vector<std::pair<uint64_t, PostingView>> result;
+    SegmentTaskRef task = findTask(taskId);
+    if (!task) {
+        return result;
+    }
+
+    result.reserve(task.entry->keyCount);
+    for (uint64_t i = 0; i < task.entry->keyCount; ++i) {
+        const SegmentKey& key = keys_[task.entry->firstKey + i];
+        result.emplace_back(key.fingerprint, postingAt(key));
+    }
+    return result;
+}
+
+std::string Segment::name(uint32_t offset, uint32_t length) const {
+    return std::string(strings_ + offset, length);
+}
+
+PostingView Segment::postingAt(const SegmentKey& key) const {
+    const uint8_t* start = postings_ + key.offset;
+    const auto* skips = reinterpret_cast<const PostingSkip*>(start);
+    const uint8_t* data = start + key.blockCount * sizeof(PostingSkip);
+    const uint8_t* tail = data + key.dataBytes;
+    return PostingView(skips, key.blockCount, data, key.dataBytes, tail, key.tailBytes, key.size);
+}
+
+SegmentWriter::SegmentWriter(std::string path, size_t bloomBitsPerKey)
+    : path_(std::move(path))
+    , bloomBitsPerKey_(bloomBitsPerKey) {
+}
+
+void SegmentWriter::beginTask(const std::string& taskId) {
+    SegmentTask task {};
+    task.nameOffset = addString(taskId);
+    task.nameLength = static_cast<uint32_t>(taskId.size());
+    task.firstSubmission = submissionCount_;
+    task.firstKey = keyCount_;
+    appendRaw(tasks_, task);
+    ++taskCount_;
+    currentTaskHash_ = Segment::taskHash(taskId);
+}
+
+void SegmentWriter::addSubmission(const SegmentSubmission& submission) {
+    SegmentSubmissionEntry entry {};
+    entry.submissionId = submission.submissionId;
+    entry.fingerprintCount = static_cast<uint32_t>(submission.fingerprintCount);
+    entry.nameOffset = addString(submission.studentName);
+    entry.nameLength = static_cast<uint32_t>(submission.studentName.size());
+    appendRaw(submissions_, entry);
+    ++submissionCount_;
+
+    auto* task = reinterpret_cast<SegmentTask*>(tasks_.data() + tasks_.size() - sizeof(SegmentTask));
+    ++task->submissionCount;
+}
+
+void SegmentWriter::addPosting(uint64_t fingerprint, const PostingView& postings) {
+    postings_.resize(align8(postings_.size()));
+
+    SegmentKey key {};
+    key.fingerprint = fingerprint;
+    key.offset = postings_.size();
+    key.size = static_cast<uint32_t>(postings.size());
+    key.blockCount = static_cast<uint32_t>(postings.blockCount());
+    key.dataBytes = static_cast<uint32_t>(postings.dataBytes());
+    key.tailBytes = static_cast<uint32_t>(postings.tailBytes());
+    appendRaw(keys_, key);
+    ++keyCount_;
+    bloomKeys_.push_back(Segment::bloomKey(currentTaskHash_, fingerprint));
+
+    const auto* skips = reinterpret_cast<const uint8_t*>(postings.skips());
+    postings_.insert(postings_.end(), skips, skips + postings.blockCount() * sizeof(PostingSkip));
+    postings_.insert(postings_.end(), postings.data(), postings.data() + postings.dataBytes());
+    postings_.insert(postings_.end(), postings.tail(), postings.tail() + postings.tailBytes());
+
+    auto* task = reinterpret_cast<SegmentTask*>(tasks_.data() + tasks_.size() - sizeof(SegmentTask));
+    ++task->keyCount;
+}
+
+size_t SegmentWriter::finish() {
+    // Запас в конце для векторного декодера
+    postings_.resize(postings_.size() + simd::kStreamVByteOverread, 0);
+
+    BloomFilter bloom(bloomKeys_.size(), bloomBitsPerKey_);
+    for (uint64_t key : bloomKeys_) {
+        bloom.insert(key);
+    }
+    size_t bloomBytes = bloom.blockCount() * BloomFilterView::kBlockBytes;
+
+    SegmentHeader header {};
+    std::memcpy(header.magic, detail::kSegmentMagic, sizeof(header.magic));
+    header.version = detail::kSegmentVersion;
+    header.taskCount = taskCount_;
+    header.submissionCount = submissionCount_;
+    header.keyCount = keyCount_;
+    header.tasksOffset = align8(sizeof(SegmentHeader));
+    header.submissionsOffset = align8(header.tasksOffset + tasks_.size());
+    header.keysOffset = align8(header.submissionsOffset + submissions_.size());
+    header.stringsOffset = align8(header.keysOffset + keys_.size());
+    header.bloomOffset = align8(header.stringsOffset + strings_.size());
+    header.bloomBlocks = bloom.blockCount();
+    header.postingsOffset = align8(header.bloomOffset + bloomBytes);
+    header.fileSize = header.postingsOffset + postings_.size();
+
+    std::vector<uint8_t> file(header.fileSize, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::copy(tasks_.begin(), tasks_.end(), file.begin() + header.tasksOffset);
+    std::copy(submissions_.begin(), submissions_.end(), file.begin() + header.submissionsOffset);
+    std::copy(keys_.begin(), keys_.end(), file.begin() + header.keysOffset);
+    std::copy(strings_.begin(), strings_.end(), file.begin() + header.stringsOffset);
+    std::memcpy(file.data() + header.bloomOffset, bloom.data(), bloomBytes);
+    std::copy(postings_.begin(), postings_.end(), file.begin() + header.postingsOffset);
+
+    std::string tmpPath = path_ + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create segment " + tmpPath);
+    }
+    bool ok = writeAll(fd, file.data(), file.size()) && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tmpPath.c_str(), path_.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot write segment " + path_);
+    }
+
+    return file.size();
+}
+
+uint32_t SegmentWriter::addString(const std::string& value) {
+    auto offset = static_cast<uint32_t>(strings_.size());
+    strings_ += value;
+    return offset;
+}
+
+}
@@ -0,0 +1,129 @@
+#ifndef SEGMENT_H
+#define SEGMENT_H
+
+#include "bloomfilter.h"
+#include "postinglist.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace indexing {
+
+namespace detail {
+struct SegmentHeader;
+struct SegmentTask;
+struct SegmentKey;
+struct SegmentSubmissionEntry;
+}
+
+// Работа, записанная в сегмент
+struct SegmentSubmission {
+  int submissionId = 0;
+  std::string studentName;
+  size_t fingerprintCount = 0;
+};
+
+// Задание внутри сегмента, найденное один раз на запрос
+struct SegmentTaskRef {
+  const detail::SegmentTask* entry = nullptr;
+  uint64_t hash = 0;
+
+  explicit operator bool() const { return entry != nullptr; }
+};
+
+// Неизменяемый сегмент индекса отпечатков на диске, открытый через mmap.
+// Файл:  заголовок | задания | работы | ключи | строки | фильтр Блума | списки
+// Задания отсортированы по имени, внутри задания работы — по id,
+// ключи — по отпечатку; списки в формате PostingView, поэтому читаются
+// прямо из отображённой памяти (рабочий набор держит page cache).
+// Числа записаны в порядке байт машины (little-endian).
+class Segment {
+public:
+  // Открыть файл; при неверном формате бросает std::runtime_error
+  static std::shared_ptr<const Segment> open(const std::string& path);
+
+  ~Segment();
+  Segment(const Segment&) = delete;
+  Segment& operator=(const Segment&) = delete;
+
+  const std::string& path() const { return path_; }
+  size_t fileSize() const { return size_; }
+  size_t submissionCount() const;
+
+  SegmentTaskRef findTask(const std::string& taskId) const;
+
+  // Фильтр Блума по парам (задание, отпечаток): false — отпечатка точно нет
+  bool mayContain(const SegmentTaskRef& task, uint64_t fingerprint) const;
+
+  // Список работ для отпечатка задания; пустой, если отпечатка нет
+  PostingView find(const SegmentTaskRef& task, uint64_t fingerprint) const;
+
+  size_t bloomMemoryUsage() const { return bloom_.memoryUsage(); }
+
+  // Ключ фильтра Блума для отпечатка задания
+  static uint64_t taskHash(const std::string& taskId);
+  static uint64_t bloomKey(uint64_t taskHash, uint64_t fingerprint);
+
+  bool contains(const std::string& taskId, int submissionId) const;
+  bool findSubmission(const std::string& taskId, int submissionId, SegmentSubmission& out) const;
+
+  // Обход для слияния сегментов
+  std::vector<std::string> taskIds() const;
+  std::vector<SegmentSubmission> submissions(const std::string& taskId) const;
+  std::vector<std::pair<uint64_t, PostingView>> postings(const std::string& taskId) const;
+
+private:
+  Segment() = default;
+
+  std::string name(uint32_t offset, uint32_t length) const;
+  PostingView postingAt(const detail::SegmentKey& key) const;
+
+  std::string path_;
+  const uint8_t* base_ = nullptr;
+  size_t size_ = 0;
+
+  const detail::SegmentHeader* header_ = nullptr;
+  const detail::SegmentTask* tasks_ = nullptr;
+  const detail::SegmentSubmissionEntry* submissions_ = nullptr;
+  const detail::SegmentKey* keys_ = nullptr;
+  const char* strings_ = nullptr;
+  const uint8_t* postings_ = nullptr;
+  BloomFilterView bloom_;
+};
+
+// Построение файла сегмента: задания по возрастанию имени, внутри —
+// сначала работы по возрастанию id, затем списки по возрастанию отпечатка.
+// finish() пишет во временный файл, делает fsync и переименовывает.
+class SegmentWriter {
+public:
+  explicit SegmentWriter(std::string path, size_t bloomBitsPerKey = 10);
+
+  void beginTask(const std::string& taskId);
+  void addSubmission(const SegmentSubmission& submission);
+  void addPosting(uint64_t fingerprint, const PostingView& postings);
+
+  // Возвращает размер файла
+  size_t finish();
+
+private:
+  uint32_t addString(const std::string& value);
+
+  std::string path_;
+  size_t bloomBitsPerKey_;
+  uint64_t currentTaskHash_ = 0;
+  std::vector<uint64_t> bloomKeys_;
+  std::vector<uint8_t> tasks_;
+  std::vector<uint8_t> submissions_;
+  std::vector<uint8_t> keys_;
+  std::string strings_;
+  std::vector<uint8_t> postings_;
+  uint32_t taskCount_ = 0;
+  uint64_t submissionCount_ = 0;
+  uint64_t keyCount_ = 0;
+};
+
+}
+
+#endif //SEGMENT_H
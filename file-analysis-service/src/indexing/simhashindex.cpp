@@ -0,0 +1,131 @@
+#include "simhashindex.h"
+#include "snapshot.h"
+#include "../similarity/simhash.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace indexing {
+
+SimHashIndex::SimHashIndex(int maxDistance)
+    : maxDistance_(std::clamp(maxDistance, 0, 63))
+    , blocks_(static_cast<size_t>(maxDistance_) + 1)
+{}
+
+void SimHashIndex::add(const std::string& taskId, int submissionId,
+                       const std::string& studentName, uint64_t simhash) {
+    std::unique_lock lock(mutex_);
+    insert(tasks_[taskId], submissionId, studentName, simhash);
+}
+
+std::vector<SimHashCandidate> SimHashIndex::query(const std::string& taskId, uint64_t simhash) const {
+    std::shared_lock lock(mutex_);
+
+    std::vector<SimHashCandidate> result;
+
+    auto taskIt = tasks_.find(taskId);
+    if (taskIt == tasks_.end() || taskIt->second.tables.empty()) {
+        return result;
+    }
+    const TaskIndex& task = taskIt->second;
+
+    std::unordered_set<int> seen;
+    for (size_t block = 0; block < blocks_; ++block) {
+        auto it = task.tables[block].find(blockKey(simhash, block));
+        if (it == task.tables[block].end()) {
+            continue;
+        }
+
+        for (const Entry& entry : it->second) {
+            int distance = similarity::SimHash::hammingDistance(simhash, entry.simhash);
+            if (distance > maxDistance_ || !seen.insert(entry.submissionId).second) {
+                continue;
+            }
+
+            SimHashCandidate c;
+            c.submissionId = entry.submissionId;
+            c.studentName = task.students.at(entry.submissionId);
+            c.distance = distance;
+            result.push_back(c);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const SimHashCandidate& a, const SimHashCandidate& b) {
+        if (a.distance != b.distance) {
+            return a.distance < b.distance;
+        }
+        return a.submissionId < b.submissionId;
+    });
+
+    return result;
+}
+
+void SimHashIndex::save(SnapshotWriter& out) const {
+    std::shared_lock lock(mutex_);
+
+    out.i32(maxDistance_);
+    out.u64(tasks_.size());
+    for (const auto& [taskId, task] : tasks_) {
+        out.string(taskId);
+        out.u64(task.students.size());
+        if (task.tables.empty()) {
+            continue;
+        }
+        // Работа лежит в каждой таблице, так что первая даёт все SimHash-и
+        for (const auto& [key, entries] : task.tables[0]) {
+            for (const Entry& entry : entries) {
+                out.i32(entry.submissionId);
+                out.string(task.students.at(entry.submissionId));
+                out.u64(entry.simhash);
+            }
+        }
+    }
+}
+
+void SimHashIndex::load(SnapshotReader& in) {
+    if (in.i32() != maxDistance_) {
+        throw std::runtime_error("SimHash snapshot has a different distance");
+    }
+
+    std::unordered_map<std::string, TaskIndex> tasks;
+    for (uint64_t t = in.u64(); t > 0; --t) {
+        TaskIndex& task = tasks[in.string()];
+        for (uint64_t n = in.u64(); n > 0; --n) {
+            int id = in.i32();
+            std::string studentName = in.string();
+            insert(task, id, studentName, in.u64());
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    tasks_ = std::move(tasks);
+}
+
+void SimHashIndex::insert(TaskIndex& task, int submissionId, const std::string& studentName,
+                          uint64_t simhash) {
+    if (!task.students.try_emplace(submissionId, studentName).second) {
+        return;
+    }
+
+    if (task.tables.empty()) {
+        task.tables.resize(blocks_);
+    }
+
+    for (size_t block = 0; block < blocks_; ++block) {
+        task.tables[block][blockKey(simhash, block)].push_back({submissionId, simhash});
+    }
+}
+
+uint64_t SimHashIndex::blockKey(uint64_t simhash, size_t block) const {
+    // Блоки почти равной ширины: первые (64 % blocks_) на бит шире
+    size_t base = 64 / blocks_;
+    size_t extra = 64 % blocks_;
+    size_t width = base + (block < extra ? 1 : 0);
+    size_t offset = block * base + std::min(block, extra);
+
+    uint64_t mask = width >= 64 ? ~0ULL : ((1ULL << width) - 1);
+    return (simhash >> offset) & mask;
+}
+
+}
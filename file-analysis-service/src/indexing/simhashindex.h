@@ -0,0 +1,68 @@
+#ifndef SIMHASHINDEX_H
+#define SIMHASHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace indexing {
+
+class SnapshotReader;
+class SnapshotWriter;
+
+// Работа в пределах заданного расстояния Хэмминга от запроса
+struct SimHashCandidate {
+  int submissionId = 0;
+  std::string studentName;
+  int distance = 0;
+};
+
+// Multi-index по SimHash (Manku, Jain, Das Sarma).
+// 64 бита делятся на maxDistance + 1 блоков; по принципу Дирихле у двух
+// хэшей на расстоянии <= maxDistance хотя бы один блок совпадает точно.
+// Для каждого блока своя таблица, поэтому поиск проверяет только
+// работы с совпавшим блоком, а не всё задание.
+class SimHashIndex {
+public:
+  explicit SimHashIndex(int maxDistance = 3);
+
+  // Добавить SimHash работы (повторное добавление игнорируется)
+  void add(const std::string& taskId, int submissionId,
+           const std::string& studentName, uint64_t simhash);
+
+  // Все работы задания на расстоянии <= maxDistance, по возрастанию расстояния
+  std::vector<SimHashCandidate> query(const std::string& taskId, uint64_t simhash) const;
+
+  int maxDistance() const { return maxDistance_; }
+
+  // Снимок: SimHash-и работ, таблицы блоков пересобираются при загрузке.
+  // load заменяет содержимое индекса
+  void save(SnapshotWriter& out) const;
+  void load(SnapshotReader& in);
+
+private:
+  struct Entry {
+    int submissionId;
+    uint64_t simhash;
+  };
+
+  struct TaskIndex {
+    std::vector<std::unordered_map<uint64_t, std::vector<Entry>>> tables;
+    std::unordered_map<int, std::string> students;
+  };
+
+  void insert(TaskIndex& task, int submissionId, const std::string& studentName, uint64_t simhash);
+  uint64_t blockKey(uint64_t simhash, size_t block) const;
+
+  int maxDistance_;
+  size_t blocks_;
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, TaskIndex> tasks_;
+};
+
+}
+
+#endif //SIMHASHINDEX_H
@@ -0,0 +1,119 @@
+#include "similaritygraph.h"
+#include "snapshot.h"
+#include <algorithm>
+#include <mutex>
+
+namespace indexing {
+
+namespace {
+
+void sortByScore(std::vector<SimilarityEdge>& edges) {
+    std::sort(edges.begin(), edges.end(), [](const SimilarityEdge& a, const SimilarityEdge& b) {
+        if (a.similarityPercent != b.similarityPercent) {
+            return a.similarityPercent > b.similarityPercent;
+        }
+        return a.submissionId < b.submissionId;
+    });
+}
+
+}
+
+void SimilarityGraph::addRow(const std::string& taskId, int submissionId,
+                             const std::vector<SimilarityEdge>& row) {
+    std::unique_lock lock(mutex_);
+
+    Adjacency& task = tasks_[taskId];
+    auto& own = task[submissionId];
+
+    for (const auto& edge : row) {
+        if (edge.submissionId == submissionId) {
+            continue;
+        }
+        own.push_back(edge);
+        task[edge.submissionId].push_back({submissionId, edge.similarityPercent, edge.verified});
+        ++edges_;
+    }
+}
+
+std::vector<SimilarityEdge> SimilarityGraph::neighbours(const std::string& taskId, int submissionId) const {
+    std::shared_lock lock(mutex_);
+
+    std::vector<SimilarityEdge> result;
+    auto taskIt = tasks_.find(taskId);
+    if (taskIt != tasks_.end()) {
+        auto it = taskIt->second.find(submissionId);
+        if (it != taskIt->second.end()) {
+            result = it->second;
+        }
+    }
+    lock.unlock();
+
+    sortByScore(result);
+    return result;
+}
+
+std::unordered_map<int, std::vector<SimilarityEdge>> SimilarityGraph::task(const std::string& taskId) const {
+    std::shared_lock lock(mutex_);
+
+    Adjacency result;
+    auto taskIt = tasks_.find(taskId);
+    if (taskIt != tasks_.end()) {
+        result = taskIt->second;
+    }
+    lock.unlock();
+
+    for (auto& [id, edges] : result) {
+        sortByScore(edges);
+    }
+    return result;
+}
+
+size_t SimilarityGraph::edgeCount() const {
+    std::shared_lock lock(mutex_);
+    return edges_;
+}
+
+void SimilarityGraph::save(SnapshotWriter& out) const {
+    std::shared_lock lock(mutex_);
+
+    out.u64(tasks_.size());
+    for (const auto& [taskId, adjacency] : tasks_) {
+        out.string(taskId);
+        out.u64(adjacency.size());
+        for (const auto& [id, edges] : adjacency) {
+            out.i32(id);
+            out.u64(edges.size());
+            for (const auto& edge : edges) {
+                out.i32(edge.submissionId);
+                out.f64(edge.similarityPercent);
+                out.u8(edge.verified ? 1 : 0);
+            }
+        }
+    }
+}
+
+void SimilarityGraph::load(SnapshotReader& in) {
+    std::unordered_map<std::string, Adjacency> tasks;
+    size_t edges = 0;
+
+    for (uint64_t t = in.u64(); t > 0; --t) {
+        Adjacency& adjacency = tasks[in.string()];
+        for (uint64_t n = in.u64(); n > 0; --n) {
+            auto& row = adjacency[in.i32()];
+            row.resize(in.u64());
+            for (auto& edge : row) {
+                edge.submissionId = in.i32();
+                edge.similarityPercent = in.f64();
+                edge.verified = in.u8() != 0;
+            }
+            edges += row.size();
+        }
+    }
+
+    // Каждое ребро хранится в обоих направлениях
+    std::unique_lock lock(mutex_);
+    tasks_ = std::move(tasks);
+    edges_ = edges / 2;
+}
+
+}
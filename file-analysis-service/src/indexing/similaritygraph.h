@@ -0,0 +1,53 @@
+#ifndef SIMILARITYGRAPH_H
+#define SIMILARITYGRAPH_H
+
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace indexing {
+
+class SnapshotReader;
+class SnapshotWriter;
+
+// Соседняя работа в матрице сходства
+struct SimilarityEdge {
+  int submissionId = 0;
+  double similarityPercent = 0.0;
+  bool verified = false;
+};
+
+// Разреженная матрица сходства задания в памяти: списки смежности,
+// только пары выше порога. Новая работа добавляет свою строку и столбец
+// за O(длины строки), чтение не пересчитывает ничего.
+class SimilarityGraph {
+public:
+  // Строка новой работы; рёбра сохраняются в обе стороны
+  void addRow(const std::string& taskId, int submissionId,
+              const std::vector<SimilarityEdge>& row);
+
+  // Соседи работы по убыванию сходства
+  std::vector<SimilarityEdge> neighbours(const std::string& taskId, int submissionId) const;
+
+  // Соседи всех работ задания (по убыванию сходства) одной блокировкой
+  std::unordered_map<int, std::vector<SimilarityEdge>> task(const std::string& taskId) const;
+
+  size_t edgeCount() const;
+
+  // Снимок списков смежности; load заменяет содержимое графа
+  void save(SnapshotWriter& out) const;
+  void load(SnapshotReader& in);
+
+private:
+  using Adjacency = std::unordered_map<int, std::vector<SimilarityEdge>>;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, Adjacency> tasks_;
+  size_t edges_ = 0;
+};
+
+}
+
+#endif //SIMILARITYGRAPH_H
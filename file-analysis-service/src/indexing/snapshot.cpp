@@ -0,0 +1,238 @@
+#include "snapshot.h"
+#include "simd/crc32c.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace indexing {
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'A', 'F', 'S', 'N', 'A', 'P', 'S', 'H'};
+// Версия 2: вместо id последнего отчёта — номер транзакции его завершения
+constexpr uint32_t kSnapshotVersion = 2;
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t checksum;  // CRC-32C данных после заголовка
+  uint64_t payloadSize;
+  uint64_t paramsHash;
+  int64_t lastCompletedXid;
+  int64_t lastBaseFileId;
+  int64_t createdAt;
+  uint64_t indexSubmissions;
+};
+
+}
+
+void SnapshotWriter::u8(uint8_t value) {
+    data_.push_back(value);
+}
+
+void SnapshotWriter::u32(uint32_t value) {
+    raw(&value, sizeof(value));
+}
+
+void SnapshotWriter::u64(uint64_t value) {
+    raw(&value, sizeof(value));
+}
+
+void SnapshotWriter::i32(int32_t value) {
+    raw(&value, sizeof(value));
+}
+
+void SnapshotWriter::f64(double value) {
+    raw(&value, sizeof(value));
+}
+
+void SnapshotWriter::string(const std::string& value) {
+    u64(value.size());
+    raw(value.data(), value.size());
+}
+
+void SnapshotWriter::u32s(const std::vector<uint32_t>& values) {
+    u64(values.size());
+    raw(values.data(), values.size() * sizeof(uint32_t));
+}
+
+void SnapshotWriter::u64s(const std::vector<uint64_t>& values) {
+    u64(values.size());
+    raw(values.data(), values.size() * sizeof(uint64_t));
+}
+
+void SnapshotWriter::raw(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size)
+    : data_(data)
+    , size_(size) {
+}
+
+uint8_t SnapshotReader::u8() {
+    uint8_t value;
+    raw(&value, sizeof(value));
+    return value;
+}
+
+uint32_t SnapshotReader::u32() {
+    uint32_t value;
+    raw(&value, sizeof(value));
+    return value;
+}
+
+uint64_t SnapshotReader::u64() {
+    uint64_t value;
+    raw(&value, sizeof(value));
+    return value;
+}
+
+int32_t SnapshotReader::i32() {
+    int32_t value;
+    raw(&value, sizeof(value));
+    return value;
+}
+
+double SnapshotReader::f64() {
+    double value;
+    raw(&value, sizeof(value));
+    return value;
+}
+
+std::string SnapshotReader::string() {
+    size_t size = count(1);
+    std::string value(reinterpret_cast<const char*>(data_ + position_), size);
+    position_ += size;
+    return value;
+}
+
+std::vector<uint32_t> SnapshotReader::u32s() {
+    std::vector<uint32_t> values(count(sizeof(uint32_t)));
+    raw(values.data(), values.size() * sizeof(uint32_t));
+    return values;
+}
+
+std::vector<uint64_t> SnapshotReader::u64s() {
+    std::vector<uint64_t> values(count(sizeof(uint64_t)));
+    raw(values.data(), values.size() * sizeof(uint64_t));
+    return values;
+}
+
+void SnapshotReader::raw(void* out, size_t size) {
+    if (size > size_ - position_) {
+        throw std::runtime_error("Snapshot truncated");
+    }
+    std::memcpy(out, data_ + position_, size);
+    position_ += size;
+}
+
+// Длина массива с проверкой, что он помещается в оставшиеся данные
+size_t SnapshotReader::count(size_t elementSize) {
+    uint64_t n = u64();
+    if (n > (size_ - position_) / elementSize) {
+        throw std::runtime_error("Snapshot truncated");
+    }
+    return static_cast<size_t>(n);
+}
+
+void writeSnapshotFile(const std::string& path, const SnapshotInfo& info,
+                       const std::vector<uint8_t>& payload) {
+    SnapshotHeader header {};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.checksum = simd::crc32c(0, payload.data(), payload.size());
+    header.payloadSize = payload.size();
+    header.paramsHash = info.paramsHash;
+    header.lastCompletedXid = info.lastCompletedXid;
+    header.lastBaseFileId = info.lastBaseFileId;
+    header.createdAt = info.createdAt;
+    header.indexSubmissions = info.indexSubmissions;
+
+    std::string tmpPath = path + ".tmp";
+    FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Cannot create snapshot " + tmpPath);
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(payload.data(), 1, payload.size(), file) == payload.size() &&
+              std::fflush(file) == 0 && ::fsync(fileno(file)) == 0;
+    std::fclose(file);
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot write snapshot " + path);
+    }
+}
+
+std::unique_ptr<MappedSnapshot> MappedSnapshot::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return nullptr;
+        }
+        throw std::runtime_error("Cannot open snapshot " + path);
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Snapshot too small: " + path);
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot mmap snapshot " + path);
+    }
+
+    std::unique_ptr<MappedSnapshot> snapshot(new MappedSnapshot());
+    snapshot->base_ = static_cast<const uint8_t*>(mapped);
+    snapshot->size_ = size;
+
+    // Снимок читается целиком и один раз
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+
+    SnapshotHeader header;
+    std::memcpy(&header, snapshot->base_, sizeof(header));
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a snapshot: " + path);
+    }
+    if (header.version != kSnapshotVersion) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version));
+    }
+    if (header.payloadSize != size - sizeof(header)) {
+        throw std::runtime_error("Snapshot size mismatch: " + path);
+    }
+
+    snapshot->payload_ = snapshot->base_ + sizeof(header);
+    snapshot->payloadSize_ = header.payloadSize;
+    if (simd::crc32c(0, snapshot->payload_, snapshot->payloadSize_) != header.checksum) {
+        throw std::runtime_error("Snapshot checksum mismatch: " + path);
+    }
+
+    snapshot->info_.paramsHash = header.paramsHash;
+    snapshot->info_.lastCompletedXid = header.lastCompletedXid;
+    snapshot->info_.lastBaseFileId = header.lastBaseFileId;
+    snapshot->info_.createdAt = header.createdAt;
+    snapshot->info_.indexSubmissions = header.indexSubmissions;
+    return snapshot;
+}
+
+MappedSnapshot::~MappedSnapshot() {
+    if (base_) {
+        ::munmap(const_cast<uint8_t*>(base_), size_);
+    }
+}
+
+SnapshotReader MappedSnapshot::reader() const {
+    return SnapshotReader(payload_, payloadSize_);
+}
+
+}
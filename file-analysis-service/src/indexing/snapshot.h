@@ -0,0 +1,100 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace indexing {
+
+// Сериализация структур в памяти для снимка: значения подряд,
+// в порядке байт машины (little-endian), без выравнивания
+class SnapshotWriter {
+public:
+  void u8(uint8_t value);
+  void u32(uint32_t value);
+  void u64(uint64_t value);
+  void i32(int32_t value);
+  void f64(double value);
+  void string(const std::string& value);
+  void u32s(const std::vector<uint32_t>& values);
+  void u64s(const std::vector<uint64_t>& values);
+
+  const std::vector<uint8_t>& data() const { return data_; }
+
+private:
+  void raw(const void* data, size_t size);
+
+  std::vector<uint8_t> data_;
+};
+
+// Чтение снимка; выход за границы — std::runtime_error
+class SnapshotReader {
+public:
+  SnapshotReader(const uint8_t* data, size_t size);
+
+  uint8_t u8();
+  uint32_t u32();
+  uint64_t u64();
+  int32_t i32();
+  double f64();
+  std::string string();
+  std::vector<uint32_t> u32s();
+  std::vector<uint64_t> u64s();
+
+  bool atEnd() const { return position_ == size_; }
+
+private:
+  void raw(void* out, size_t size);
+  size_t count(size_t elementSize);
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+// Что уже учтено в снимке: отчёты, завершённые транзакциями не позже
+// lastCompletedXid, и файлы-заготовки с id не больше lastBaseFileId.
+// Остальные догоняются из БД при старте
+struct SnapshotInfo {
+  uint64_t paramsHash = 0;      // параметры алгоритмов, при которых снят снимок
+  int64_t lastCompletedXid = 0;
+  int64_t lastBaseFileId = 0;
+  int64_t createdAt = 0;        // unix time
+  uint64_t indexSubmissions = 0; // работ в индексе отпечатков на момент снимка
+};
+
+// Файл снимка: заголовок (магия, версия, SnapshotInfo, CRC-32C данных) и данные.
+// Пишется во временный файл с fsync и атомарно переименовывается.
+void writeSnapshotFile(const std::string& path, const SnapshotInfo& info,
+                       const std::vector<uint8_t>& payload);
+
+// Снимок, открытый через mmap; open проверяет версию и контрольную сумму
+class MappedSnapshot {
+public:
+  // nullptr, если файла нет; std::runtime_error, если он повреждён
+  static std::unique_ptr<MappedSnapshot> open(const std::string& path);
+
+  ~MappedSnapshot();
+  MappedSnapshot(const MappedSnapshot&) = delete;
+  MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+  const SnapshotInfo& info() const { return info_; }
+  size_t size() const { return size_; }
+  SnapshotReader reader() const;
+
+private:
+  MappedSnapshot() = default;
+
+  const uint8_t* base_ = nullptr;
+  size_t size_ = 0;
+  const uint8_t* payload_ = nullptr;
+  size_t payloadSize_ = 0;
+  SnapshotInfo info_;
+};
+
+}
+
+#endif //SNAPSHOT_H
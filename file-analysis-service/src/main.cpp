@@ -1,10 +1,22 @@
 #include "config/config.h"
 #include "db/database.h"
 #include "repository/reportrepository.h"
+#include "repository/jobrepository.h"
 #include "clients/fileserviceclient.h"
+#include "concurrency/threadpool.h"
+#include "concurrency/scheduler.h"
+#include "indexing/fingerprintindex.h"
+#include "indexing/hashindex.h"
+#include "indexing/lshindex.h"
+#include "indexing/simhashindex.h"
+#include "indexing/similaritygraph.h"
+#include "indexing/boilerplatefilter.h"
+#include "sharding/shardedindex.h"
 #include "service/analysisservice.h"
+#include "service/analysisqueue.h"
 #include "handlers/analysishandlers.h"
 #include "httplib.h"
+#include <chrono>
 #include <iostream>
 
 int main() {
@@ -21,14 +33,79 @@ int main() {
     // 3. Создаём слои приложения
     repository::ReportRepository reportRepo(database);
     clients::FileServiceClient fileClient(cfg.server().fileServiceUrl);
-    service::AnalysisService analysisService(reportRepo, fileClient);
-    handlers::AnalysisHandlers analysisHandlers(analysisService, fileClient);
+    indexing::HashIndex hashIndex;
+    indexing::FingerprintIndex fingerprintIndex;
+    if (!cfg.analysis().indexDir.empty()) {
+        indexing::IndexStorageOptions storage;
+        storage.directory = cfg.analysis().indexDir;
+        storage.flushInterval = std::chrono::seconds(cfg.analysis().indexFlushSeconds);
+        storage.maxSegments = cfg.analysis().indexMaxSegments;
+        storage.bloomBitsPerKey = cfg.analysis().bloomBitsPerKey;
+        fingerprintIndex.open(storage);
+        std::cout << "[Main] Fingerprint index segments: " << fingerprintIndex.segmentCount()
+                  << " (" << fingerprintIndex.submissionCount() << " submissions, "
+                  << fingerprintIndex.diskUsage() / 1024 << " KiB) in "
+                  << cfg.analysis().indexDir << std::endl;
+    }
+    indexing::LshIndex lshIndex(cfg.analysis().lshBands);
+    indexing::SimHashIndex simhashIndex(cfg.analysis().simhashMaxDistance);
+    indexing::SimilarityGraph similarityGraph;
+    indexing::BoilerplateFilter boilerplateFilter(cfg.analysis().boilerplateMaxDf,
+                                                  cfg.analysis().boilerplateMinSubmissions);
+    concurrency::ThreadPool workerPool(cfg.analysis().workerThreads);
+    std::cout << "[Main] Worker threads: " << workerPool.size() << std::endl;
+    sharding::ShardMap shardMap(cfg.shard().shardId, cfg.shard().shardCount);
+    sharding::ShardedIndex shardedIndex(fingerprintIndex, shardMap, cfg.shard().peers, workerPool);
+    if (shardMap.shardCount() > 1) {
+        std::cout << "[Main] Fingerprint index shard " << shardMap.shardId() << " of "
+                  << shardMap.shardCount() << std::endl;
+    }
+    service::AnalysisService analysisService(reportRepo, fileClient, hashIndex, fingerprintIndex,
+                                             shardedIndex, lshIndex, simhashIndex,
+                                             similarityGraph, boilerplateFilter, workerPool,
+                                             cfg.analysis());
 
-    // 4. Настраиваем HTTP сервер
+    // 4. Восстанавливаем индексы: из снимка, если он есть, иначе из БД.
+    // Индекс копий собирается из хэшей отчётов, поэтому сначала старые
+    // хэши по сырым байтам заменяются хэшами канонической формы
+    size_t rehashed = analysisService.normalizeStoredHashes();
+    if (rehashed > 0) {
+        std::cout << "[Main] Rehashed " << rehashed << " submissions analyzed before normalization" << std::endl;
+    }
+    size_t restored = analysisService.restoreIndex();
+    std::cout << "[Main] Similarity indexes restored: " << restored << " submissions, "
+              << similarityGraph.edgeCount() << " matrix pairs" << std::endl;
+    std::cout << "[Main] Fingerprint postings in memory: " << fingerprintIndex.memoryUsage() / 1024
+              << " KiB" << std::endl;
+    analysisService.startSnapshots(std::chrono::seconds(cfg.analysis().snapshotSeconds));
+
+    // У очереди своё соединение: захват и продление аренд не ждут за
+    // долгими запросами к отчётам
+    db::Database queueDatabase(cfg.database().connectionString());
+    repository::JobRepository jobRepo(queueDatabase);
+
+    service::QueueOptions queueOptions;
+    queueOptions.workers = cfg.analysis().queueWorkers;
+    queueOptions.capacity = cfg.analysis().queueCapacity;
+    queueOptions.agingStep = std::chrono::milliseconds(cfg.analysis().queueAgingMs);
+    queueOptions.lease = std::chrono::seconds(cfg.analysis().queueLeaseSeconds);
+    queueOptions.maxAttempts = cfg.analysis().queueMaxAttempts;
+    queueOptions.retryDelay = std::chrono::seconds(cfg.analysis().queueRetrySeconds);
+    queueOptions.pollInterval = std::chrono::milliseconds(cfg.analysis().queuePollMs);
+
+    concurrency::Scheduler scheduler(queueOptions.workers, queueOptions.agingStep);
+    service::AnalysisQueue analysisQueue(analysisService, jobRepo, scheduler, queueOptions);
+    std::cout << "[Main] Analysis queue worker " << analysisQueue.owner() << ": "
+              << queueOptions.workers << " workers, capacity " << queueOptions.capacity
+              << ", aging step " << queueOptions.agingStep.count() << " ms, lease "
+              << queueOptions.lease.count() << " s" << std::endl;
+    handlers::AnalysisHandlers analysisHandlers(analysisService, analysisQueue, scheduler, fileClient);
+
+    // 5. Настраиваем HTTP сервер
     httplib::Server server;
     analysisHandlers.registerRoutes(server);
 
-    // 5. Запускаем
+    // 6. Запускаем
     std::cout << "[Main] File Analysis Service starting on port " << cfg.server().port << std::endl;
     server.listen("0.0.0.0", cfg.server().port);
 
@@ -0,0 +1,42 @@
+#ifndef ANALYSISJOB_H
+#define ANALYSISJOB_H
+
+#include "filehash.h"
+#include <chrono>
+#include <optional>
+#include <string>
+
+namespace models {
+
+// Строка analysis_jobs: запрос на анализ работы и состояние его выполнения
+struct AnalysisJob {
+  int id = 0;
+  int reportId = 0;       // отчёт pending; после завершения — итоговый отчёт
+  int submissionId = 0;
+  std::string taskId;
+  std::string studentName;
+  Sha256 fileHash{};
+  std::string filename;
+  int priority = 0;       // concurrency::Priority
+  std::string status;     // queued, running, completed, failed
+  int attempts = 0;
+  int maxAttempts = 0;
+  std::string lastError;
+  // Сколько задание ждёт с постановки (created_at) к моменту чтения строки
+  std::chrono::milliseconds queuedFor{0};
+
+  // Итог анализа из отчёта, когда задание завершено
+  bool isPlagiarism = false;
+  double similarityPercent = 0.0;
+  std::optional<int> originalSubmissionId;
+};
+
+// Право на выполнение задания: только владелец аренды может его завершить
+struct JobLease {
+  int jobId = 0;
+  std::string owner;
+};
+
+}
+
+#endif //ANALYSISJOB_H
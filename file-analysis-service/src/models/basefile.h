@@ -0,0 +1,19 @@
+#ifndef BASEFILE_H
+#define BASEFILE_H
+
+#include <string>
+
+namespace models {
+
+// Файл-заготовка задания (стартовый код от преподавателя)
+struct BaseFile {
+  int id = 0;
+  std::string taskId;
+  std::string filename;
+  std::string content;
+  std::string createdAt;
+};
+
+}
+
+#endif //BASEFILE_H
@@ -0,0 +1,22 @@
+#ifndef FILEHASH_H
+#define FILEHASH_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace models {
+
+// SHA-256 канонической формы файла в двоичном виде
+using Sha256 = std::array<uint8_t, 32>;
+
+// Хэш файла работы из отчёта — для восстановления индекса копий
+struct FileHashEntry {
+  int submissionId = 0;
+  std::string studentName;
+  Sha256 hash{};
+};
+
+}
+
+#endif //FILEHASH_H
@@ -1,6 +1,7 @@
 #ifndef REPORT_H
 #define REPORT_H
 
+#include "filehash.h"
 #include <string>
 #include <optional>
 
@@ -15,6 +16,7 @@ struct Report {
   double similarityPercent = 0.0;
   std::optional<int> originalSubmissionId;
   std::string status;
+  std::optional<Sha256> fileHash;  // только для записи: индекс копий
   std::string createdAt;
   std::string completedAt;
 };
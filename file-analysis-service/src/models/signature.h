@@ -0,0 +1,28 @@
+#ifndef SIGNATURE_H
+#define SIGNATURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace models {
+
+// Сигнатуры содержимого работы, хранятся рядом с отчётом
+struct Signature {
+  std::vector<uint64_t> fingerprints;
+  std::vector<uint32_t> minhash;
+  uint64_t simhash = 0;
+};
+
+// Сигнатура вместе с данными работы — для восстановления индексов при старте
+struct SubmissionSignature {
+  int64_t completedXid = 0;  // транзакция, завершившая отчёт
+  int submissionId = 0;
+  std::string taskId;
+  std::string studentName;
+  Signature signature;
+};
+
+}
+
+#endif //SIGNATURE_H
@@ -0,0 +1,20 @@
+#ifndef SIMILARITYPAIR_H
+#define SIMILARITYPAIR_H
+
+#include <string>
+
+namespace models {
+
+// Ребро разреженной матрицы сходства задания: новая работа и более ранняя
+struct SimilarityPair {
+  std::string taskId;
+  int submissionId = 0;
+  int otherSubmissionId = 0;
+  double similarityPercent = 0.0;
+  // true — сходство посчитано точной проверкой, false — оценка по отпечаткам
+  bool verified = false;
+};
+
+}
+
+#endif //SIMILARITYPAIR_H
@@ -0,0 +1,244 @@
+#include "jobrepository.h"
+#include <algorithm>
+
+namespace repository {
+
+namespace {
+
+// Столбцы задания; у claim и enqueue итог отчёта — NULL. Возраст задания
+// считается по часам БД, чтобы не зависеть от расхождения часов процессов
+const char* const kJobColumns =
+    "j.id, j.report_id, j.submission_id, j.task_id, j.student_name, j.file_hash, j.filename, "
+    "j.priority, j.status, j.attempts, j.max_attempts, j.last_error, "
+    "(EXTRACT(EPOCH FROM NOW() - j.created_at) * 1000)::bigint";
+
+const char* const kNoResult = "NULL::boolean, NULL::numeric, NULL::integer";
+
+std::string seconds(std::chrono::seconds value) {
+    return "interval '1 second' * " + std::to_string(value.count());
+}
+
+// Завершить отчёты заданий, для которых попыток больше не будет
+void failReports(pqxx::work& txn, const pqxx::result& jobs) {
+    for (const auto& row : jobs) {
+        if (row[1].as<std::string>() == "failed") {
+            txn.exec("UPDATE reports SET status = 'failed', completed_at = NOW() "
+                     "WHERE id = " + std::to_string(row[0].as<int>()) + " AND status = 'pending'");
+        }
+    }
+}
+
+}
+
+JobRepository::JobRepository(db::Database& database)
+    : db_(database)
+{}
+
+std::optional<models::AnalysisJob> JobRepository::enqueue(const models::AnalysisJob& job, size_t capacity) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    // Предел мягкий: параллельные enqueue могут его чуть превысить
+    pqxx::result queued = txn.exec("SELECT count(*) FROM analysis_jobs WHERE status = 'queued'");
+    if (queued[0][0].as<size_t>() >= capacity) {
+        return std::nullopt;
+    }
+
+    pqxx::result report = txn.exec(
+        "INSERT INTO reports (submission_id, task_id, student_name, status) "
+        "VALUES (" + std::to_string(job.submissionId) + ", "
+                   + txn.quote(job.taskId) + ", "
+                   + txn.quote(job.studentName) + ", 'pending') "
+        "RETURNING id");
+
+    std::string query =
+        "INSERT INTO analysis_jobs AS j (report_id, submission_id, task_id, student_name, file_hash, "
+        "filename, priority, max_attempts) "
+        "VALUES (" + std::to_string(report[0][0].as<int>()) + ", "
+                   + std::to_string(job.submissionId) + ", "
+                   + txn.quote(job.taskId) + ", "
+                   + txn.quote(job.studentName) + ", "
+                   + txn.quote_raw(job.fileHash.data(), job.fileHash.size()) + ", "
+                   + txn.quote(job.filename) + ", "
+                   + std::to_string(job.priority) + ", "
+                   + std::to_string(job.maxAttempts) + ") "
+        "RETURNING " + std::string(kJobColumns) + ", " + kNoResult;
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    return rowToJob(result[0]);
+}
+
+std::vector<models::AnalysisJob> JobRepository::claim(const std::string& owner, size_t limit,
+                                                      std::chrono::seconds lease,
+                                                      std::chrono::milliseconds agingStep) {
+    if (limit == 0) {
+        return {};
+    }
+
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    // Сначала класс с учётом старения: задание приоритета p, прождавшее
+    // n * agingStep, соперничает с классом p - n, как в планировщике. Внутри
+    // класса — честно по заданиям: task_rank — место работы в очереди своего
+    // задания, поэтому сначала берутся головы всех заданий, затем вторые
+    // работы, а всплеск загрузок по одному заданию не вытесняет остальные.
+    // Оконная функция не совместима с FOR UPDATE, поэтому ранги считаются в
+    // подзапросе, а блокируются только строки analysis_jobs; занятые
+    // другими пропускаются
+    std::string step = std::to_string(agingStep.count());
+    std::string agedClass = agingStep.count() > 0
+        ? "GREATEST(priority - FLOOR(EXTRACT(EPOCH FROM NOW() - available_at) * 1000 / " + step +
+              ")::int, 0)"
+        : std::string("priority");
+    std::string query =
+        "UPDATE analysis_jobs AS j SET status = 'running', attempts = j.attempts + 1, "
+        "lease_owner = " + txn.quote(owner) + ", "
+        "lease_until = NOW() + " + seconds(lease) + ", updated_at = NOW() "
+        "FROM (SELECT q.id FROM analysis_jobs q "
+        "      JOIN (SELECT id, aged_class, row_number() OVER (PARTITION BY aged_class, task_id "
+        "                                                      ORDER BY available_at, id) AS task_rank "
+        "            FROM (SELECT id, task_id, available_at, " + agedClass + " AS aged_class "
+        "                  FROM analysis_jobs "
+        "                  WHERE status = 'queued' AND available_at <= NOW()) AS aged) AS ranked "
+        "        ON ranked.id = q.id "
+        "      WHERE q.status = 'queued' "
+        "      ORDER BY ranked.aged_class, ranked.task_rank, "
+        "               q.available_at + q.priority * interval '1 millisecond' * " + step + ", q.id "
+        "      LIMIT " + std::to_string(limit) + " "
+        "      FOR UPDATE OF q SKIP LOCKED) AS next "
+        "WHERE j.id = next.id "
+        "RETURNING " + std::string(kJobColumns) + ", " + kNoResult;
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::AnalysisJob> jobs;
+    jobs.reserve(result.size());
+    for (const auto& row : result) {
+        jobs.push_back(rowToJob(row));
+    }
+    // Старые раньше: RETURNING порядок не сохраняет
+    std::sort(jobs.begin(), jobs.end(), [](const auto& a, const auto& b) { return a.id < b.id; });
+    return jobs;
+}
+
+size_t JobRepository::renewLeases(const std::string& owner, std::chrono::seconds lease) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    pqxx::result result = txn.exec(
+        "UPDATE analysis_jobs SET lease_until = NOW() + " + seconds(lease) + " "
+        "WHERE status = 'running' AND lease_owner = " + txn.quote(owner));
+    txn.commit();
+
+    return result.affected_rows();
+}
+
+size_t JobRepository::requeueExpired() {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    // Попытка уже засчитана при захвате
+    pqxx::result expired = txn.exec(
+        "UPDATE analysis_jobs SET "
+        "status = CASE WHEN attempts >= max_attempts THEN 'failed' ELSE 'queued' END, "
+        "last_error = 'lease expired', lease_owner = NULL, lease_until = NULL, "
+        "available_at = NOW(), updated_at = NOW() "
+        "WHERE status = 'running' AND lease_until < NOW() "
+        "RETURNING report_id, status");
+    failReports(txn, expired);
+    txn.commit();
+
+    return expired.size();
+}
+
+bool JobRepository::retryOrFail(const models::JobLease& lease, const std::string& error,
+                                std::chrono::seconds retryDelay) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    pqxx::result result = txn.exec(
+        "UPDATE analysis_jobs SET "
+        "status = CASE WHEN attempts >= max_attempts THEN 'failed' ELSE 'queued' END, "
+        "last_error = " + txn.quote(error) + ", lease_owner = NULL, lease_until = NULL, "
+        "available_at = NOW() + " + seconds(retryDelay) + " * power(2, attempts - 1), "
+        "updated_at = NOW() "
+        "WHERE id = " + std::to_string(lease.jobId) + " AND status = 'running' "
+        "AND lease_owner = " + txn.quote(lease.owner) + " "
+        "RETURNING report_id, status");
+    failReports(txn, result);
+    txn.commit();
+
+    return !result.empty();
+}
+
+std::optional<models::AnalysisJob> JobRepository::findById(int jobId) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT " + std::string(kJobColumns) + ", "
+        "r.is_plagiarism, r.similarity_percent, r.original_submission_id "
+        "FROM analysis_jobs j "
+        "LEFT JOIN reports r ON r.id = j.report_id AND j.status = 'completed' "
+        "WHERE j.id = " + std::to_string(jobId);
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    if (result.empty()) {
+        return std::nullopt;
+    }
+    return rowToJob(result[0]);
+}
+
+size_t JobRepository::queuedCount() {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    pqxx::result result = txn.exec("SELECT count(*) FROM analysis_jobs WHERE status = 'queued'");
+    txn.commit();
+
+    return result[0][0].as<size_t>();
+}
+
+models::AnalysisJob JobRepository::rowToJob(const pqxx::row& row) {
+    models::AnalysisJob job;
+    job.id = row[0].as<int>();
+    job.reportId = row[1].as<int>();
+    job.submissionId = row[2].as<int>();
+    job.taskId = row[3].as<std::string>();
+    job.studentName = row[4].as<std::string>();
+
+    pqxx::binarystring hash(row[5]);
+    if (hash.size() == job.fileHash.size()) {
+        std::copy(hash.data(), hash.data() + hash.size(), job.fileHash.begin());
+    }
+
+    job.filename = row[6].as<std::string>();
+    job.priority = row[7].as<int>();
+    job.status = row[8].as<std::string>();
+    job.attempts = row[9].as<int>();
+    job.maxAttempts = row[10].as<int>();
+    if (!row[11].is_null()) {
+        job.lastError = row[11].as<std::string>();
+    }
+    if (!row[12].is_null()) {
+        job.queuedFor = std::chrono::milliseconds(std::max<int64_t>(row[12].as<int64_t>(), 0));
+    }
+
+    if (!row[13].is_null()) {
+        job.isPlagiarism = row[13].as<bool>();
+        job.similarityPercent = row[14].as<double>();
+        if (!row[15].is_null()) {
+            job.originalSubmissionId = row[15].as<int>();
+        }
+    }
+
+    return job;
+}
+
+}
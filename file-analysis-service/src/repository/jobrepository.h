@@ -0,0 +1,67 @@
+#ifndef JOBREPOSITORY_H
+#define JOBREPOSITORY_H
+
+#include "../db/database.h"
+#include "../models/analysisjob.h"
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace repository {
+
+// Аренда задания истекла и его забрал другой обработчик
+class LeaseLost : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+// Очередь анализа в таблице analysis_jobs. Обработчиков (потоков и процессов)
+// может быть сколько угодно: задания разбираются через FOR UPDATE SKIP LOCKED,
+// взятое задание арендуется на lease и продлевается, пока обработчик жив.
+class JobRepository {
+public:
+  explicit JobRepository(db::Database& database);
+
+  // Завести отчёт pending и задание к нему в одной транзакции;
+  // nullopt — в очереди уже capacity заданий
+  std::optional<models::AnalysisJob> enqueue(const models::AnalysisJob& job, size_t capacity);
+
+  // Взять до limit готовых заданий. Порядок — как у планировщика: сначала
+  // класс приоритета, который за каждые agingStep ожидания повышается на
+  // один, внутри класса — задания по кругу (сначала первые работы каждого
+  // задания, потом вторые...)
+  std::vector<models::AnalysisJob> claim(const std::string& owner, size_t limit,
+                                         std::chrono::seconds lease,
+                                         std::chrono::milliseconds agingStep);
+
+  // Продлить аренду всех заданий владельца; возвращает их число
+  size_t renewLeases(const std::string& owner, std::chrono::seconds lease);
+
+  // Задания с истёкшей арендой вернуть в очередь (или завершить failed,
+  // если попытки кончились); возвращает их число
+  size_t requeueExpired();
+
+  // Попытка не удалась: задание снова в очереди через retryDelay * 2^(попытка - 1)
+  // или failed вместе с отчётом. false — аренда уже не наша
+  bool retryOrFail(const models::JobLease& lease, const std::string& error,
+                   std::chrono::seconds retryDelay);
+
+  std::optional<models::AnalysisJob> findById(int jobId);
+
+  // Сколько заданий ждёт в очереди
+  size_t queuedCount();
+
+private:
+  models::AnalysisJob rowToJob(const pqxx::row& row);
+
+  db::Database& db_;
+  std::mutex mutex_;  // одно соединение на все потоки
+};
+
+}
+
+#endif //JOBREPOSITORY_H
@@ -1,43 +1,233 @@
 #include "reportrepository.h"
+#include "jobrepository.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace repository {
 
+namespace {
+
+// Сигнатуры хранятся в BYTEA как little-endian значения подряд
+template <typename T>
+std::string encodeValues(const std::vector<T>& values) {
+    std::string bytes(values.size() * sizeof(T), '\0');
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t b = 0; b < sizeof(T); ++b) {
+            bytes[i * sizeof(T) + b] = static_cast<char>((static_cast<uint64_t>(values[i]) >> (8 * b)) & 0xff);
+        }
+    }
+    return bytes;
+}
+
+template <typename T>
+std::vector<T> decodeValues(const pqxx::field& field) {
+    if (field.is_null()) {
+        return {};
+    }
+
+    pqxx::binarystring bytes(field);
+    const unsigned char* data = bytes.data();
+
+    std::vector<T> values(bytes.size() / sizeof(T));
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint64_t value = 0;
+        for (size_t b = 0; b < sizeof(T); ++b) {
+            value |= static_cast<uint64_t>(data[i * sizeof(T) + b]) << (8 * b);
+        }
+        values[i] = static_cast<T>(value);
+    }
+    return values;
+}
+
+std::string quoteBytes(pqxx::work& txn, const std::string& bytes) {
+    return txn.quote_raw(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size());
+}
+
+// Строки матрицы сходства одной вставкой
+void insertPairs(pqxx::work& txn, const std::vector<models::SimilarityPair>& pairs) {
+    if (pairs.empty()) {
+        return;
+    }
+
+    std::string pairsQuery =
+        "INSERT INTO similarity_pairs (task_id, submission_id, other_submission_id, "
+        "similarity_percent, verified) VALUES ";
+
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        const auto& p = pairs[i];
+        if (i > 0) {
+            pairsQuery += ", ";
+        }
+        pairsQuery += "(" + txn.quote(p.taskId) + ", "
+                          + std::to_string(p.submissionId) + ", "
+                          + std::to_string(p.otherSubmissionId) + ", "
+                          + std::to_string(p.similarityPercent) + ", "
+                          + (p.verified ? "true" : "false") + ")";
+    }
+
+    pairsQuery += " ON CONFLICT (submission_id, other_submission_id) DO UPDATE "
+                  "SET similarity_percent = EXCLUDED.similarity_percent, "
+                  "verified = EXCLUDED.verified";
+    txn.exec(pairsQuery);
+}
+
+// Номер текущей транзакции (xid8) как BIGINT; назначается, если его ещё нет
+const char* const kCurrentXid = "pg_current_xact_id()::text::bigint";
+
+std::string range(int64_t after, int64_t before) {
+    return "completed_xid > " + std::to_string(after) + " AND completed_xid < " +
+           std::to_string(before);
+}
+
+}
+
 ReportRepository::ReportRepository(db::Database& database)
     : db_(database)
 {}
 
-int ReportRepository::create(const models::Report& report) {
+int64_t ReportRepository::complete(int reportId, const models::Report& report,
+                                   const models::Signature& signature,
+                                   const std::vector<models::SimilarityPair>& pairs,
+                                   const std::optional<models::JobLease>& lease) {
+    std::lock_guard lock(mutex_);
     pqxx::work txn(db_.connection());
 
+    // Строка задания блокируется до конца транзакции: вернуть его в очередь
+    // по истечении аренды, пока отчёт записывается, нельзя
+    if (lease) {
+        pqxx::result owned = txn.exec(
+            "UPDATE analysis_jobs SET status = 'completed', lease_owner = NULL, "
+            "lease_until = NULL, updated_at = NOW() "
+            "WHERE id = " + std::to_string(lease->jobId) + " AND status = 'running' "
+            "AND lease_owner = " + txn.quote(lease->owner) + " "
+            "RETURNING id");
+        if (owned.empty()) {
+            throw LeaseLost("Lease on job " + std::to_string(lease->jobId) + " was lost");
+        }
+    }
+
     std::string origIdValue = report.originalSubmissionId
         ? std::to_string(*report.originalSubmissionId)
         : "NULL";
 
+    std::string fileHashValue = report.fileHash
+        ? txn.quote_raw(report.fileHash->data(), report.fileHash->size())
+        : "NULL";
+
+    // Id отчёта остаётся прежним: его уже знают задание и клиенты.
+    // Порядок завершения для догона индексов — номер этой транзакции
     std::string query =
-        "INSERT INTO reports (submission_id, task_id, student_name, is_plagiarism, "
-        "similarity_percent, original_submission_id, status, completed_at) "
-        "VALUES (" + std::to_string(report.submissionId) + ", "
-                   + txn.quote(report.taskId) + ", "
-                   + txn.quote(report.studentName) + ", "
-                   + (report.isPlagiarism ? "true" : "false") + ", "
-                   + std::to_string(report.similarityPercent) + ", "
-                   + origIdValue + ", "
-                   + txn.quote(report.status) + ", NOW()) "
-        "RETURNING id";
+        "UPDATE reports SET completed_xid = " + std::string(kCurrentXid) + ", "
+        "is_plagiarism = " + std::string(report.isPlagiarism ? "true" : "false") + ", "
+        "similarity_percent = " + std::to_string(report.similarityPercent) + ", "
+        "original_submission_id = " + origIdValue + ", "
+        "status = " + txn.quote(report.status) + ", "
+        "file_hash = " + fileHashValue + ", "
+        "fingerprints = " + quoteBytes(txn, encodeValues(signature.fingerprints)) + ", "
+        "minhash = " + quoteBytes(txn, encodeValues(signature.minhash)) + ", "
+        "simhash = " + std::to_string(static_cast<int64_t>(signature.simhash)) + ", "
+        "completed_at = NOW() "
+        "WHERE id = " + std::to_string(reportId) + " AND status = 'pending' "
+        "RETURNING completed_xid";
 
     pqxx::result result = txn.exec(query);
+    if (result.empty()) {
+        throw std::runtime_error("Pending report " + std::to_string(reportId) + " not found");
+    }
+    int64_t completedXid = result[0][0].as<int64_t>();
+
+    insertPairs(txn, pairs);
+
     txn.commit();
 
-    return result[0][0].as<int>();
+    return completedXid;
+}
+
+BatchCompletion ReportRepository::createBatch(const std::vector<models::Report>& reports,
+                                              const std::vector<models::Signature>& signatures,
+                                              const std::vector<models::SimilarityPair>& pairs) {
+    if (reports.size() != signatures.size()) {
+        throw std::invalid_argument("Each report needs a signature");
+    }
+    if (reports.empty()) {
+        return {};
+    }
+
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "INSERT INTO reports (submission_id, task_id, student_name, is_plagiarism, "
+        "similarity_percent, original_submission_id, status, file_hash, fingerprints, minhash, simhash, "
+        "completed_at, completed_xid) VALUES ";
+
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const auto& report = reports[i];
+        const auto& signature = signatures[i];
+        if (i > 0) {
+            query += ", ";
+        }
+
+        std::string origIdValue = report.originalSubmissionId
+            ? std::to_string(*report.originalSubmissionId)
+            : "NULL";
+        std::string fileHashValue = report.fileHash
+            ? txn.quote_raw(report.fileHash->data(), report.fileHash->size())
+            : "NULL";
+
+        query += "(" + std::to_string(report.submissionId) + ", "
+                     + txn.quote(report.taskId) + ", "
+                     + txn.quote(report.studentName) + ", "
+                     + (report.isPlagiarism ? "true" : "false") + ", "
+                     + std::to_string(report.similarityPercent) + ", "
+                     + origIdValue + ", "
+                     + txn.quote(report.status) + ", "
+                     + fileHashValue + ", "
+                     + quoteBytes(txn, encodeValues(signature.fingerprints)) + ", "
+                     + quoteBytes(txn, encodeValues(signature.minhash)) + ", "
+                     + std::to_string(static_cast<int64_t>(signature.simhash)) + ", NOW(), "
+                     + kCurrentXid + ")";
+    }
+    query += " RETURNING submission_id, id, completed_xid";
+
+    pqxx::result inserted = txn.exec(query);
+    insertPairs(txn, pairs);
+    txn.commit();
+
+    // Работы пакета различны, поэтому id сопоставляются по submission_id
+    std::unordered_map<int, int> idBySubmission;
+    for (const auto& row : inserted) {
+        idBySubmission[row[0].as<int>()] = row[1].as<int>();
+    }
+    BatchCompletion batch;
+    batch.reportIds.reserve(reports.size());
+    for (const auto& report : reports) {
+        batch.reportIds.push_back(idBySubmission.at(report.submissionId));
+    }
+    batch.completedXid = inserted[0][2].as<int64_t>();
+    return batch;
+}
+
+int64_t ReportRepository::completionHorizon() {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    pqxx::result result = txn.exec("SELECT pg_snapshot_xmin(pg_current_snapshot())::text::bigint");
+    txn.commit();
+
+    return result[0][0].as<int64_t>();
 }
 
 std::optional<models::Report> ReportRepository::findBySubmissionId(int submissionId) {
+    std::lock_guard lock(mutex_);
     pqxx::work txn(db_.connection());
 
     std::string query =
         "SELECT id, submission_id, task_id, student_name, is_plagiarism, "
         "similarity_percent, original_submission_id, status, created_at, completed_at "
-        "FROM reports WHERE submission_id = " + std::to_string(submissionId);
+        "FROM reports WHERE submission_id = " + std::to_string(submissionId) + " "
+        "ORDER BY created_at DESC, id DESC LIMIT 1";
 
     pqxx::result result = txn.exec(query);
     txn.commit();
@@ -50,6 +240,7 @@ std::optional<models::Report> ReportRepository::findBySubmissionId(int submissio
 }
 
 std::vector<models::Report> ReportRepository::findByTaskId(const std::string& taskId) {
+    std::lock_guard lock(mutex_);
     pqxx::work txn(db_.connection());
 
     std::string query =
@@ -71,6 +262,295 @@ std::vector<models::Report> ReportRepository::findByTaskId(const std::string& ta
     return reports;
 }
 
+std::vector<models::SubmissionSignature> ReportRepository::findAllSignatures(int64_t before) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT submission_id, task_id, student_name, fingerprints, minhash, simhash, completed_xid "
+        "FROM reports WHERE completed_xid < " + std::to_string(before) + " "
+        "AND fingerprints IS NOT NULL "
+        "ORDER BY submission_id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::SubmissionSignature> signatures;
+    signatures.reserve(result.size());
+
+    for (const auto& row : result) {
+        signatures.push_back(rowToSignature(row));
+    }
+
+    return signatures;
+}
+
+std::vector<models::SimilarityPair> ReportRepository::findAllSimilarityPairs(int64_t before) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT task_id, submission_id, other_submission_id, similarity_percent, verified "
+        "FROM similarity_pairs "
+        "WHERE submission_id IN (SELECT submission_id FROM reports WHERE completed_xid < " +
+        std::to_string(before) + ") "
+        "ORDER BY submission_id ASC, other_submission_id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::SimilarityPair> pairs;
+    pairs.reserve(result.size());
+
+    for (const auto& row : result) {
+        pairs.push_back(rowToSimilarityPair(row));
+    }
+
+    return pairs;
+}
+
+std::vector<models::SubmissionSignature> ReportRepository::findSignaturesAfter(int64_t after,
+                                                                              int64_t before) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT submission_id, task_id, student_name, fingerprints, minhash, simhash, completed_xid "
+        "FROM reports WHERE " + range(after, before) + " AND fingerprints IS NOT NULL "
+        "ORDER BY completed_xid ASC, submission_id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::SubmissionSignature> signatures;
+    signatures.reserve(result.size());
+
+    for (const auto& row : result) {
+        signatures.push_back(rowToSignature(row));
+    }
+
+    return signatures;
+}
+
+std::vector<models::SimilarityPair> ReportRepository::findSimilarityPairsAfter(int64_t after,
+                                                                               int64_t before) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT task_id, submission_id, other_submission_id, similarity_percent, verified "
+        "FROM similarity_pairs "
+        "WHERE submission_id IN (SELECT submission_id FROM reports WHERE " +
+        range(after, before) + ") "
+        "ORDER BY submission_id ASC, other_submission_id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::SimilarityPair> pairs;
+    pairs.reserve(result.size());
+
+    for (const auto& row : result) {
+        pairs.push_back(rowToSimilarityPair(row));
+    }
+
+    return pairs;
+}
+
+std::vector<models::FileHashEntry> ReportRepository::findAllFileHashes() {
+    return findFileHashes("file_hash IS NOT NULL");
+}
+
+std::vector<models::FileHashEntry> ReportRepository::findFileHashesAfter(int64_t after, int64_t before) {
+    return findFileHashes(range(after, before) + " AND file_hash IS NOT NULL");
+}
+
+std::vector<models::FileHashEntry> ReportRepository::findRawFileHashes() {
+    return findFileHashes("file_hash IS NOT NULL AND NOT hash_normalized");
+}
+
+void ReportRepository::updateFileHash(int submissionId, const models::Sha256& hash) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "UPDATE reports SET file_hash = " + txn.quote_raw(hash.data(), hash.size()) + ", "
+        "hash_normalized = TRUE "
+        "WHERE submission_id = " + std::to_string(submissionId) + " AND NOT hash_normalized";
+
+    txn.exec(query);
+    txn.commit();
+}
+
+std::vector<models::FileHashEntry> ReportRepository::findFileHashes(const std::string& condition) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT submission_id, student_name, file_hash "
+        "FROM reports WHERE " + condition;
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::FileHashEntry> hashes;
+    hashes.reserve(result.size());
+
+    for (const auto& row : result) {
+        pqxx::binarystring bytes(row[2]);
+        models::FileHashEntry entry;
+        if (bytes.size() != entry.hash.size()) {
+            continue;
+        }
+        entry.submissionId = row[0].as<int>();
+        entry.studentName = row[1].as<std::string>();
+        std::copy(bytes.data(), bytes.data() + bytes.size(), entry.hash.begin());
+        hashes.push_back(std::move(entry));
+    }
+
+    return hashes;
+}
+
+int ReportRepository::createBaseFile(const models::BaseFile& baseFile) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "INSERT INTO base_files (task_id, filename, content) "
+        "VALUES (" + txn.quote(baseFile.taskId) + ", "
+                   + txn.quote(baseFile.filename) + ", "
+                   + txn.quote(baseFile.content) + ") "
+        "RETURNING id";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    return result[0][0].as<int>();
+}
+
+std::vector<models::BaseFile> ReportRepository::findAllBaseFiles() {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT id, task_id, filename, content, created_at "
+        "FROM base_files ORDER BY id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::BaseFile> files;
+    files.reserve(result.size());
+
+    for (const auto& row : result) {
+        files.push_back(rowToBaseFile(row));
+    }
+
+    return files;
+}
+
+std::vector<models::BaseFile> ReportRepository::findBaseFilesAfter(int baseFileId) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT id, task_id, filename, content, created_at "
+        "FROM base_files WHERE id > " + std::to_string(baseFileId) + " ORDER BY id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::BaseFile> files;
+    files.reserve(result.size());
+
+    for (const auto& row : result) {
+        files.push_back(rowToBaseFile(row));
+    }
+
+    return files;
+}
+
+std::vector<models::BaseFile> ReportRepository::findBaseFilesByTask(const std::string& taskId) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT id, task_id, filename, content, created_at "
+        "FROM base_files WHERE task_id = " + txn.quote(taskId) + " "
+        "ORDER BY id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::BaseFile> files;
+    files.reserve(result.size());
+
+    for (const auto& row : result) {
+        files.push_back(rowToBaseFile(row));
+    }
+
+    return files;
+}
+
+std::vector<models::SubmissionSignature> ReportRepository::findSignaturesByTask(const std::string& taskId) {
+    std::lock_guard lock(mutex_);
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT submission_id, task_id, student_name, fingerprints, minhash, simhash, completed_xid "
+        "FROM reports WHERE task_id = " + txn.quote(taskId) + " AND fingerprints IS NOT NULL "
+        "ORDER BY submission_id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::SubmissionSignature> signatures;
+    signatures.reserve(result.size());
+
+    for (const auto& row : result) {
+        signatures.push_back(rowToSignature(row));
+    }
+
+    return signatures;
+}
+
+models::SubmissionSignature ReportRepository::rowToSignature(const pqxx::row& row) {
+    models::SubmissionSignature s;
+    s.submissionId = row[0].as<int>();
+    s.taskId = row[1].as<std::string>();
+    s.studentName = row[2].as<std::string>();
+
+    s.signature.fingerprints = decodeValues<uint64_t>(row[3]);
+    s.signature.minhash = decodeValues<uint32_t>(row[4]);
+
+    if (!row[5].is_null()) {
+        s.signature.simhash = static_cast<uint64_t>(row[5].as<int64_t>());
+    }
+    s.completedXid = row[6].is_null() ? 0 : row[6].as<int64_t>();
+
+    return s;
+}
+
+models::SimilarityPair ReportRepository::rowToSimilarityPair(const pqxx::row& row) {
+    models::SimilarityPair p;
+    p.taskId = row[0].as<std::string>();
+    p.submissionId = row[1].as<int>();
+    p.otherSubmissionId = row[2].as<int>();
+    p.similarityPercent = row[3].as<double>();
+    p.verified = row[4].as<bool>();
+    return p;
+}
+
+models::BaseFile ReportRepository::rowToBaseFile(const pqxx::row& row) {
+    models::BaseFile f;
+    f.id = row[0].as<int>();
+    f.taskId = row[1].as<std::string>();
+    f.filename = row[2].as<std::string>();
+    f.content = row[3].as<std::string>();
+    f.createdAt = row[4].as<std::string>();
+    return f;
+}
+
 models::Report ReportRepository::rowToReport(const pqxx::row& row) {
     models::Report r;
     r.id = row[0].as<int>();
@@ -3,29 +3,99 @@
 
 #include "../db/database.h"
 #include "../models/report.h"
+#include "../models/signature.h"
+#include "../models/similaritypair.h"
+#include "../models/basefile.h"
+#include "../models/filehash.h"
+#include "../models/analysisjob.h"
+#include <mutex>
 #include <vector>
 #include <optional>
 #include <pqxx/pqxx>
 
 namespace repository {
 
+// Записанный пакет: id отчётов в порядке запроса и транзакция записи
+struct BatchCompletion {
+  std::vector<int> reportIds;
+  int64_t completedXid = 0;
+};
+
+// Порядок завершения отчётов — completed_xid, номер транзакции, в которой
+// отчёт завершён. Id отчёта при этом не меняется. Отчёты с completed_xid
+// ниже горизонта (completionHorizon) уже видны все: транзакции с меньшими
+// номерами закончены, а новые получат номера не меньше горизонта. Поэтому
+// догон по диапазону completed_xid ничего не пропускает
 class ReportRepository {
 public:
   explicit ReportRepository(db::Database& database);
 
-  // Создать новый отчёт
-  int create(const models::Report& report);
+  // Записать результат анализа вместе с сигнатурами содержимого и строкой
+  // матрицы сходства — в одной транзакции. Возвращает completed_xid отчёта.
+  // С lease задание завершается в той же транзакции, и отчёт записывается,
+  // только если аренда ещё наша (иначе LeaseLost): ровно один отчёт на задание
+  int64_t complete(int reportId, const models::Report& report, const models::Signature& signature,
+                   const std::vector<models::SimilarityPair>& pairs = {},
+                   const std::optional<models::JobLease>& lease = std::nullopt);
+
+  // Записать пакет завершённых отчётов одной вставкой, строки матрицы —
+  // второй, в одной транзакции
+  BatchCompletion createBatch(const std::vector<models::Report>& reports,
+                              const std::vector<models::Signature>& signatures,
+                              const std::vector<models::SimilarityPair>& pairs);
 
-  // Найти по ID submission
+  // Наименьший номер ещё не законченной транзакции записи
+  int64_t completionHorizon();
+
+  // Последний отчёт по ID submission
   std::optional<models::Report> findBySubmissionId(int submissionId);
 
   // Найти все отчёты по заданию
   std::vector<models::Report> findByTaskId(const std::string& taskId);
 
+  // Сигнатуры отчётов, завершённых до горизонта before (для восстановления
+  // индексов), по submission_id
+  std::vector<models::SubmissionSignature> findAllSignatures(int64_t before);
+
+  // Пары матрицы сходства тех же отчётов (для восстановления графа),
+  // упорядоченные по submission_id
+  std::vector<models::SimilarityPair> findAllSimilarityPairs(int64_t before);
+
+  // То же для отчётов с completed_xid из (after, before) — догнать снимок при
+  // старте и новые отчёты. Сигнатуры в порядке завершения, пары по submission_id
+  std::vector<models::SubmissionSignature> findSignaturesAfter(int64_t after, int64_t before);
+  std::vector<models::SimilarityPair> findSimilarityPairsAfter(int64_t after, int64_t before);
+
+  // Хэши файлов всех работ (для восстановления индекса копий)
+  std::vector<models::FileHashEntry> findAllFileHashes();
+  std::vector<models::FileHashEntry> findFileHashesAfter(int64_t after, int64_t before);
+
+  // Хэши, посчитанные по сырым байтам файла (отчёты до нормализации),
+  // и их замена хэшем канонической формы во всех отчётах работы
+  std::vector<models::FileHashEntry> findRawFileHashes();
+  void updateFileHash(int submissionId, const models::Sha256& hash);
+
+  // Сохранить файл-заготовку задания
+  int createBaseFile(const models::BaseFile& baseFile);
+
+  // Файлы-заготовки (все или одного задания), по порядку добавления
+  std::vector<models::BaseFile> findAllBaseFiles();
+  std::vector<models::BaseFile> findBaseFilesByTask(const std::string& taskId);
+  std::vector<models::BaseFile> findBaseFilesAfter(int baseFileId);
+
+  // Сигнатуры работ одного задания
+  std::vector<models::SubmissionSignature> findSignaturesByTask(const std::string& taskId);
+
 private:
+  std::vector<models::FileHashEntry> findFileHashes(const std::string& condition);
   models::Report rowToReport(const pqxx::row& row);
+  models::SubmissionSignature rowToSignature(const pqxx::row& row);
+  models::SimilarityPair rowToSimilarityPair(const pqxx::row& row);
+  models::BaseFile rowToBaseFile(const pqxx::row& row);
 
   db::Database& db_;
+  // Соединение одно, а обращаются к нему потоки HTTP-сервера и очереди анализа
+  std::mutex mutex_;
 };
 
 }
@@ -0,0 +1,249 @@
+#include "analysisqueue.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+namespace service {
+
+namespace {
+
+std::string makeOwner() {
+    char host[256] = {};
+    if (gethostname(host, sizeof(host) - 1) != 0) {
+        host[0] = '\0';
+    }
+    std::random_device random;
+    std::ostringstream owner;
+    owner << (host[0] ? host : "analysis") << ":" << getpid() << ":" << std::hex << random();
+    return owner.str();
+}
+
+JobStatus parseStatus(const std::string& status) {
+    if (status == "running") return JobStatus::Running;
+    if (status == "completed") return JobStatus::Completed;
+    if (status == "failed") return JobStatus::Failed;
+    return JobStatus::Pending;
+}
+
+AnalysisJob toJob(const models::AnalysisJob& row) {
+    AnalysisJob job;
+    job.id = row.id;
+    job.submissionId = row.submissionId;
+    job.priority = static_cast<concurrency::Priority>(
+        std::clamp(row.priority, 0, static_cast<int>(concurrency::kPriorityCount) - 1));
+    job.status = parseStatus(row.status);
+    job.attempts = row.attempts;
+    job.error = row.lastError;
+
+    if (job.status == JobStatus::Completed) {
+        AnalyzeResult result;
+        result.reportId = row.reportId;
+        result.submissionId = row.submissionId;
+        result.isPlagiarism = row.isPlagiarism;
+        result.similarityPercent = row.similarityPercent;
+        result.originalSubmissionId = row.originalSubmissionId;
+        result.status = "completed";
+        job.result = result;
+    }
+    return job;
+}
+
+}
+
+const char* jobStatusName(JobStatus status) {
+    switch (status) {
+        case JobStatus::Pending: return "pending";
+        case JobStatus::Running: return "running";
+        case JobStatus::Completed: return "completed";
+        case JobStatus::Failed: return "failed";
+    }
+    return "pending";
+}
+
+AnalysisQueue::AnalysisQueue(AnalysisService& service, repository::JobRepository& jobs,
+                             concurrency::Scheduler& scheduler, const QueueOptions& options)
+    : service_(service)
+    , jobs_(jobs)
+    , scheduler_(scheduler)
+    , options_(options)
+    , owner_(makeOwner())
+{
+    options_.workers = std::max<size_t>(options_.workers, 1);
+    options_.capacity = std::max<size_t>(options_.capacity, 1);
+    options_.maxAttempts = std::max<size_t>(options_.maxAttempts, 1);
+    claimer_ = std::thread(&AnalysisQueue::claimLoop, this);
+}
+
+AnalysisQueue::~AnalysisQueue() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    claimer_.join();
+
+    // Взятые, но не начатые задания вернутся в очередь по истечении аренды
+    scheduler_.shutdown();
+}
+
+std::optional<AnalysisJob> AnalysisQueue::submit(const AnalyzeRequest& request,
+                                                 concurrency::Priority priority) {
+    models::AnalysisJob row;
+    row.submissionId = request.submissionId;
+    row.taskId = request.taskId;
+    row.studentName = request.studentName;
+    row.fileHash = request.fileHash;
+    row.filename = request.filename;
+    row.priority = static_cast<int>(priority);
+    row.maxAttempts = static_cast<int>(options_.maxAttempts);
+
+    auto created = jobs_.enqueue(row, options_.capacity);
+    if (!created) {
+        return std::nullopt;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        notified_ = true;
+    }
+    wake_.notify_one();
+
+    return toJob(*created);
+}
+
+std::optional<AnalysisJob> AnalysisQueue::job(int jobId) {
+    auto row = jobs_.findById(jobId);
+    if (!row) {
+        return std::nullopt;
+    }
+    return toJob(*row);
+}
+
+size_t AnalysisQueue::depth() {
+    return jobs_.queuedCount();
+}
+
+const std::string& AnalysisQueue::owner() const {
+    return owner_;
+}
+
+void AnalysisQueue::claimLoop() {
+    auto leaseCheckInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(options_.lease) / 3;
+    auto nextLeaseCheck = std::chrono::steady_clock::now();
+
+    while (true) {
+        size_t free;
+        {
+            std::lock_guard lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            free = options_.workers - std::min(inFlight_, options_.workers);
+        }
+
+        try {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= nextLeaseCheck) {
+                maintain();
+                nextLeaseCheck = now + leaseCheckInterval;
+            }
+
+            // Чужие отчёты — в индексы до анализа новых работ
+            service_.syncIndexes();
+
+            auto jobs = jobs_.claim(owner_, free, options_.lease, options_.agingStep);
+            auto claimed = std::chrono::steady_clock::now();
+            for (const auto& job : jobs) {
+                {
+                    std::lock_guard lock(mutex_);
+                    ++inFlight_;
+                }
+                try {
+                    // Ожидание считается с постановки в очередь, а не с захвата
+                    scheduler_.submit(toJob(job).priority, job.taskId, [this, job] { run(job); },
+                                      claimed - job.queuedFor);
+                } catch (...) {
+                    // Аренда истечёт, и задание вернётся в очередь
+                    std::lock_guard lock(mutex_);
+                    --inFlight_;
+                    throw;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[AnalysisQueue] Claim loop error: " << e.what() << std::endl;
+        }
+
+        std::unique_lock lock(mutex_);
+        wake_.wait_for(lock, options_.pollInterval, [this] { return stopping_ || notified_; });
+        notified_ = false;
+    }
+}
+
+void AnalysisQueue::maintain() {
+    jobs_.renewLeases(owner_, options_.lease);
+
+    size_t requeued = jobs_.requeueExpired();
+    if (requeued > 0) {
+        std::cout << "[AnalysisQueue] Jobs with expired leases returned to the queue: "
+                  << requeued << std::endl;
+    }
+}
+
+void AnalysisQueue::run(const models::AnalysisJob& job) {
+    AnalyzeRequest request;
+    request.submissionId = job.submissionId;
+    request.taskId = job.taskId;
+    request.studentName = job.studentName;
+    request.fileHash = job.fileHash;
+    request.filename = job.filename;
+
+    // Копия файла, который уже анализируется, только оставляет продолжение:
+    // обработчик освобождается сразу, а задание завершит анализ первой копии.
+    // Аренда такого задания продлевается вместе с остальными
+    models::JobLease lease{job.id, owner_};
+    service_.analyze(job.reportId, request, lease,
+                     [this, job, lease](std::exception_ptr error, const AnalyzeResult&) {
+                         if (error) {
+                             fail(job, lease, error);
+                         }
+                     });
+
+    {
+        std::lock_guard lock(mutex_);
+        --inFlight_;
+        notified_ = true;
+    }
+    wake_.notify_one();
+}
+
+void AnalysisQueue::fail(const models::AnalysisJob& job, const models::JobLease& lease,
+                         std::exception_ptr error) {
+    std::string message;
+    try {
+        std::rethrow_exception(error);
+    } catch (const repository::LeaseLost& e) {
+        // Задание уже у другого обработчика: его отчёт запишет он
+        std::cerr << "[AnalysisQueue] " << e.what() << std::endl;
+        return;
+    } catch (const std::exception& e) {
+        message = e.what();
+    } catch (...) {
+        message = "unknown error";
+    }
+
+    std::cerr << "[AnalysisQueue] Analysis of submission " << job.submissionId
+              << " failed (attempt " << job.attempts << " of " << job.maxAttempts
+              << "): " << message << std::endl;
+    try {
+        jobs_.retryOrFail(lease, message, options_.retryDelay);
+    } catch (const std::exception& retryError) {
+        // Аренда истечёт, и задание вернётся в очередь само
+        std::cerr << "[AnalysisQueue] Failed to reschedule job " << job.id
+                  << ": " << retryError.what() << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,103 @@
+#ifndef ANALYSISQUEUE_H
+#define ANALYSISQUEUE_H
+
+#include "analysisservice.h"
+#include "../concurrency/scheduler.h"
+#include "../repository/jobrepository.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace service {
+
+enum class JobStatus {
+  Pending,
+  Running,
+  Completed,
+  Failed
+};
+
+const char* jobStatusName(JobStatus status);
+
+struct AnalysisJob {
+  int id = 0;
+  int submissionId = 0;
+  concurrency::Priority priority = concurrency::Priority::Interactive;
+  JobStatus status = JobStatus::Pending;
+  int attempts = 0;
+  std::optional<AnalyzeResult> result;  // для Completed
+  std::string error;                    // последняя ошибка; для Failed — причина
+};
+
+struct QueueOptions {
+  size_t workers = 2;                        // сколько работ процесс анализирует одновременно
+  size_t capacity = 1000;                    // сколько заданий может ждать в очереди
+  std::chrono::milliseconds agingStep{5000}; // старение, как у планировщика
+  std::chrono::seconds lease{60};            // аренда задания без продления
+  size_t maxAttempts = 3;
+  std::chrono::seconds retryDelay{5};        // пауза перед повтором, удваивается
+  std::chrono::milliseconds pollInterval{500};
+};
+
+// Очередь анализа в таблице analysis_jobs. POST /analyze заводит отчёт pending
+// и задание одной транзакцией, а цикл захвата в каждом процессе анализа берёт
+// готовые задания (FOR UPDATE SKIP LOCKED), пока у процесса есть свободные
+// обработчики, и отдаёт их планировщику. Пока задание выполняется, его аренда
+// продлевается; задания упавшего процесса по истечении аренды возвращаются
+// в очередь. Ошибка анализа — повтор с паузой, после maxAttempts — failed.
+// Перезапуск ничего не теряет: задания ждут в БД.
+class AnalysisQueue {
+public:
+  AnalysisQueue(AnalysisService& service, repository::JobRepository& jobs,
+                concurrency::Scheduler& scheduler, const QueueOptions& options);
+  // Задания планировщика ссылаются на очередь, поэтому он останавливается;
+  // незавершённые задания доделает этот или другой процесс
+  ~AnalysisQueue();
+
+  AnalysisQueue(const AnalysisQueue&) = delete;
+  AnalysisQueue& operator=(const AnalysisQueue&) = delete;
+
+  // Завести отчёт pending и задание; nullopt — очередь полна
+  std::optional<AnalysisJob> submit(const AnalyzeRequest& request,
+                                    concurrency::Priority priority = concurrency::Priority::Interactive);
+
+  std::optional<AnalysisJob> job(int jobId);
+
+  // Сколько заданий ждут в очереди (во всех процессах)
+  size_t depth();
+
+  // Имя этого процесса в lease_owner
+  const std::string& owner() const;
+
+private:
+  void claimLoop();
+  // Продлить аренды, вернуть просроченные задания, догнать индексы
+  void maintain();
+  void run(const models::AnalysisJob& job);
+  // Анализ не удался: повтор с паузой или failed; чужая аренда — ничего
+  void fail(const models::AnalysisJob& job, const models::JobLease& lease,
+            std::exception_ptr error);
+
+  AnalysisService& service_;
+  repository::JobRepository& jobs_;
+  concurrency::Scheduler& scheduler_;
+  QueueOptions options_;
+  std::string owner_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  size_t inFlight_ = 0;  // задания, занимающие обработчик
+  bool notified_ = false;  // новое задание или свободный обработчик
+  bool stopping_ = false;
+
+  std::thread claimer_;
+};
+
+}
+
+#endif //ANALYSISQUEUE_H
@@ -1,60 +1,517 @@
 #include "analysisservice.h"
+#include "../similarity/simhash.h"
+#include "../indexing/snapshot.h"
+#include "../utils/hashutils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace service {
 
+namespace {
+
+Verifier parseVerifier(const std::string& name) {
+    if (name == "lcs") {
+        return Verifier::Lcs;
+    }
+    if (name == "edit") {
+        return Verifier::EditDistance;
+    }
+    if (name == "ncd") {
+        return Verifier::Ncd;
+    }
+    if (name != "gst") {
+        std::cerr << "[AnalysisService] Unknown verifier '" << name
+                  << "', falling back to gst" << std::endl;
+    }
+    return Verifier::Gst;
+}
+
+models::Report toReport(const AnalyzeRequest& request, const AnalyzeResult& result) {
+    models::Report report;
+    report.id = result.reportId;
+    report.submissionId = request.submissionId;
+    report.taskId = request.taskId;
+    report.studentName = request.studentName;
+    report.isPlagiarism = result.isPlagiarism;
+    report.similarityPercent = result.similarityPercent;
+    report.originalSubmissionId = result.originalSubmissionId;
+    report.status = result.status;
+    report.fileHash = request.fileHash;
+    return report;
+}
+
+const char* verifierName(Verifier verifier) {
+    switch (verifier) {
+        case Verifier::Lcs: return "LCS";
+        case Verifier::EditDistance: return "edit distance";
+        case Verifier::Ncd: return "NCD";
+        case Verifier::Gst: return "GST";
+    }
+    return "GST";
+}
+
+// Снимок годится только при тех же параметрах отпечатков и индексов
+uint64_t snapshotParamsHash(const config::AnalysisConfig& config) {
+    std::string params = "k=" + std::to_string(config.kgramSize) +
+                         ";w=" + std::to_string(config.windowSize) +
+                         ";perm=" + std::to_string(config.minhashPermutations) +
+                         ";bands=" + std::to_string(config.lshBands) +
+                         ";simhash=" + std::to_string(config.simhashMaxDistance) +
+                         ";maxdf=" + std::to_string(config.boilerplateMaxDf) +
+                         ";mindocs=" + std::to_string(config.boilerplateMinSubmissions);
+
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : params) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// По убыванию сходства, при равенстве — более ранняя работа
+bool higherScore(const Match& a, const Match& b) {
+    if (a.similarityPercent != b.similarityPercent) {
+        return a.similarityPercent > b.similarityPercent;
+    }
+    return a.submissionId < b.submissionId;
+}
+
+void raiseTo(std::atomic<int>& value, int candidate) {
+    int current = value.load();
+    while (current < candidate && !value.compare_exchange_weak(current, candidate)) {
+    }
+}
+
+}
+
 AnalysisService::AnalysisService(repository::ReportRepository& repo,
-                                   clients::FileServiceClient& fileClient)
+                                   clients::FileServiceClient& fileClient,
+                                   indexing::HashIndex& hashIndex,
+                                   indexing::FingerprintIndex& index,
+                                   sharding::ShardedIndex& shards,
+                                   indexing::LshIndex& lshIndex,
+                                   indexing::SimHashIndex& simhashIndex,
+                                   indexing::SimilarityGraph& graph,
+                                   indexing::BoilerplateFilter& boilerplate,
+                                   concurrency::ThreadPool& pool,
+                                   const config::AnalysisConfig& config)
     : repo_(repo)
     , fileClient_(fileClient)
-{}
+    , hashIndex_(hashIndex)
+    , index_(index)
+    , shards_(shards)
+    , lshIndex_(lshIndex)
+    , simhashIndex_(simhashIndex)
+    , graph_(graph)
+    , boilerplate_(boilerplate)
+    , pool_(pool)
+    , winnowing_(similarity::WinnowingParams{config.kgramSize, config.windowSize})
+    , minhash_(config.minhashPermutations)
+    , tiling_(config.gstMinMatch)
+    , ncd_(config.ncdSampleBytes)
+    , pairwise_(pool)
+    , plagiarismThreshold_(config.plagiarismThreshold)
+    , verifyTopN_(config.verifyTopN)
+    , matrixFloor_(config.matrixFloor)
+    , verifier_(parseVerifier(config.verifier))
+    , paramsHash_(snapshotParamsHash(config))
+{
+    if (!config.indexDir.empty()) {
+        snapshotPath_ = (std::filesystem::path(config.indexDir) / "snapshot.bin").string();
+    }
+}
 
-AnalyzeResult AnalysisService::analyze(const AnalyzeRequest& request) {
+AnalysisService::~AnalysisService() {
+    {
+        std::lock_guard lock(stopMutex_);
+        stopping_ = true;
+    }
+    stopCv_.notify_all();
+    if (snapshots_.joinable()) {
+        snapshots_.join();
+    }
+}
+
+void AnalysisService::analyze(int pendingReportId, const AnalyzeRequest& request,
+                              const std::optional<models::JobLease>& lease, AnalyzeCallback done) {
     std::cout << "[AnalysisService] Analyzing submission " << request.submissionId
-              << " with hash " << request.fileHash << std::endl;
+              << " with hash " << utils::HashUtils::toHex(request.fileHash) << std::endl;
 
-    // Ищем файлы с таким же хэшем
-    auto filesWithSameHash = fileClient_.findByHash(request.fileHash);
+    // Все алгоритмы сходства работают на нормализованном потоке токенов
+    tokenizer::Tokenizer tokenizer(tokenizer::detectLanguage(request.filename));
 
-    bool isPlagiarism = false;
-    std::optional<int> originalSubmissionId;
-    double similarityPercent = 0.0;
+    // Одинаковый файл, который уже анализируется (утёкшее решение за минуту
+    // загружают десятки студентов), не разбирается и не ищет кандидатов заново
+    std::shared_ptr<Flight> flight;
+    bool leading;
+    std::tie(flight, leading) = joinFlight({pendingReportId, request, lease, std::move(done)},
+                                           tokenizer.language());
+    if (!leading) {
+        std::cout << "[AnalysisService] Submission " << request.submissionId
+                  << " waits for the analysis of an identical submission" << std::endl;
+        return;
+    }
 
-    // Проверяем: есть ли более ранние сдачи от других студентов
-    for (const auto& file : filesWithSameHash) {
-        // Если файл загружен раньше и это другой студент
-        if (file.id < request.submissionId && file.studentName != request.studentName) {
-            isPlagiarism = true;
-            originalSubmissionId = file.id;
-            similarityPercent = 100.0;  // Полное совпадение хэша = 100%
+    std::exception_ptr error;
+    try {
+        fingerprint(*flight, request, tokenizer);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    land(*flight);
 
-            std::cout << "[AnalysisService] PLAGIARISM DETECTED! Original submission: "
-                      << file.id << " by " << file.studentName << std::endl;
-            break;
+    // Участники известны: индексы сходства опрашиваются один раз на всех,
+    // кроме случая, когда у каждого есть точная копия
+    try {
+        std::vector<std::pair<int, std::string>> works;
+        bool needSimilar = false;
+        for (const auto& member : flight->members) {
+            works.emplace_back(member.request.submissionId, member.request.studentName);
+            needSimilar = needSimilar || findCopies(member.request, nullptr).empty();
+        }
+        if (!error && needSimilar && !flight->signature.fingerprints.empty()) {
+            flight->similar = findSimilar(request.taskId, flight->signature, works);
         }
+    } catch (...) {
+        error = std::current_exception();
     }
 
-    // Создаём отчёт
-    models::Report report;
-    report.submissionId = request.submissionId;
-    report.taskId = request.taskId;
-    report.studentName = request.studentName;
-    report.isPlagiarism = isPlagiarism;
-    report.similarityPercent = similarityPercent;
-    report.originalSubmissionId = originalSubmissionId;
-    report.status = "completed";
+    auto finish = [&](const Participant& member) {
+        if (error) {
+            member.done(error, {});
+            return;
+        }
+        AnalyzeResult result;
+        try {
+            result = complete(*flight, member, tokenizer);
+        } catch (...) {
+            member.done(std::current_exception(), {});
+            return;
+        }
+        member.done(nullptr, result);
+    };
+
+    // Сначала своя работа, затем ждущие — параллельно, в пуле
+    finish(flight->members.front());
+    pool_.parallelFor(flight->members.size() - 1, [&](size_t i) {
+        finish(flight->members[i + 1]);
+    });
+}
+
+AnalyzeResult AnalysisService::complete(Flight& flight, const Participant& member,
+                                        const tokenizer::Tokenizer& tokenizer) {
+    const AnalyzeRequest& request = member.request;
+    if (&member != &flight.members.front()) {
+        std::cout << "[AnalysisService] Submission " << request.submissionId
+                  << " reuses analysis of identical submission "
+                  << flight.members.front().request.submissionId << std::endl;
+    }
+
+    // Дешёвые фильтры отбирают кандидатов, точное сравнение выбирает лучшего
+    std::vector<Match> verified = matchCandidates(flight, request, tokenizer);
+
+    // Участники полёта — точные копии друг друга. Оригинал работы — самая
+    // ранняя из них другого студента, если индексы не знают более ранней
+    for (const auto& other : flight.members) {
+        int submissionId = other.request.submissionId;
+        if (submissionId >= request.submissionId || other.request.studentName == request.studentName) {
+            continue;
+        }
+        bool known = std::any_of(verified.begin(), verified.end(), [&](const Match& m) {
+            return m.submissionId == submissionId;
+        });
+        if (!known) {
+            verified.push_back({submissionId, 100.0, !flight.tokens.empty()});
+        }
+    }
+    std::sort(verified.begin(), verified.end(), higherScore);
+    AnalyzeResult result = verdict(request, verified);
+
+    const auto& signature = flight.signature;
+    const auto& rawFingerprints = flight.rawFingerprints;
+    // Строка матрицы сходства сохраняется вместе с отчётом
+    auto row = similarityRow(request, signature, verified);
+    // В БД — все отпечатки: document frequency при старте считается заново
+    models::Signature stored = signature;
+    stored.fingerprints = rawFingerprints;
+
+    // Id отчёта не меняется при завершении. В индексы работа попадает из БД
+    // в порядке завершения вместе с отчётами других процессов: обычно сразу,
+    // а если раньше начатая запись ещё не закончилась — при следующем догоне
+    result.reportId = member.pendingReportId;
+    int64_t completedXid = repo_.complete(member.pendingReportId, toReport(request, result), stored,
+                                          row, member.lease);
+    syncIndexes();
+
+    shards_.publish(completedXid, request.taskId, request.submissionId, request.studentName,
+                    signature.fingerprints);
+    return result;
+}
+
+BatchResult AnalysisService::analyzeBatch(std::vector<AnalyzeRequest> requests) {
+    auto started = std::chrono::steady_clock::now();
+    BatchResult batch;
+    if (requests.empty()) {
+        return batch;
+    }
+
+    std::sort(requests.begin(), requests.end(), [](const AnalyzeRequest& a, const AnalyzeRequest& b) {
+        return a.submissionId < b.submissionId;
+    });
+    for (size_t i = 1; i < requests.size(); ++i) {
+        if (requests[i].submissionId == requests[i - 1].submissionId) {
+            throw std::invalid_argument("Duplicate submission_id " +
+                                        std::to_string(requests[i].submissionId) + " in batch");
+        }
+    }
+    size_t count = requests.size();
+
+    // Одинаковые файлы (тот же хэш и язык) читаются и разбираются один раз
+    struct ParsedFile {
+        size_t first;  // первая работа пакета с этим файлом
+        std::shared_ptr<const std::string> content;
+        std::vector<uint32_t> tokens;
+        std::vector<uint64_t> rawFingerprints;
+    };
+    std::map<std::pair<models::Sha256, tokenizer::Language>, size_t> distinct;
+    std::vector<ParsedFile> files;
+    std::vector<size_t> fileOf(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto key = std::make_pair(requests[i].fileHash, tokenizer::detectLanguage(requests[i].filename));
+        auto [it, inserted] = distinct.try_emplace(key, files.size());
+        if (inserted) {
+            files.push_back({i, nullptr, {}, {}});
+        }
+        fileOf[i] = it->second;
+    }
+    batch.distinctFiles = files.size();
+
+    std::cout << "[AnalysisService] Analyzing batch of " << count << " submissions ("
+              << files.size() << " distinct files)" << std::endl;
+
+    pool_.parallelFor(files.size(), [&](size_t f) {
+        ParsedFile& file = files[f];
+        const AnalyzeRequest& request = requests[file.first];
+        file.content = std::make_shared<const std::string>(
+            fileClient_.getFileContent(request.submissionId));
+        if (file.content->empty()) {
+            std::cerr << "[AnalysisService] Empty content for submission "
+                      << request.submissionId << ", fingerprinting skipped" << std::endl;
+            return;
+        }
+        tokenizer::Tokenizer tokenizer(tokenizer::detectLanguage(request.filename));
+        file.tokens = tokenizer.tokenize(*file.content);
+        file.rawFingerprints = winnowing_.fingerprints(file.tokens);
+    });
+
+    std::unordered_map<int, std::shared_ptr<const std::string>> contents;
+    for (size_t i = 0; i < count; ++i) {
+        contents[requests[i].submissionId] = files[fileOf[i]].content;
+    }
+
+    std::vector<models::Signature> signatures(count);
+    std::vector<std::vector<Match>> verified(count);
+    std::vector<std::vector<models::SimilarityPair>> rows(count);
+
+    // Общие индексы получают работы пакета только после записи в БД, а до
+    // неё работы пакета находят друг друга в overlay. Фильтр шаблонов
+    // видит document frequency уже записанных работ, как и одиночный анализ
+    BatchOverlay overlay;
+    for (size_t i = 0; i < count; ++i) {
+        const auto& raw = files[fileOf[i]].rawFingerprints;
+        if (!raw.empty()) {
+            signatures[i].fingerprints = boilerplate_.filter(requests[i].taskId, raw);
+            signatures[i].minhash = minhash_.signature(signatures[i].fingerprints);
+            signatures[i].simhash = similarity::SimHash::compute(signatures[i].fingerprints);
+        }
+        overlay.hashes.add(requests[i].fileHash, requests[i].submissionId, requests[i].studentName);
+        overlay.fingerprints.add(requests[i].taskId, requests[i].submissionId, requests[i].studentName,
+                                 signatures[i].fingerprints);
+    }
+
+    // Поиск не зависит от порядка: фильтры кандидатов и строка матрицы
+    // отбрасывают работы пакета с большим id
+    pool_.parallelFor(count, [&](size_t i) {
+        const AnalyzeRequest& request = requests[i];
+        tokenizer::Tokenizer tokenizer(tokenizer::detectLanguage(request.filename));
+        auto candidates = findCandidates(request, signatures[i], &overlay);
+        verified[i] = verifyCandidates(request.taskId, request.submissionId, tokenizer,
+                                       files[fileOf[i]].tokens, candidates, contents);
+        rows[i] = similarityRow(request, signatures[i], verified[i], &overlay);
+    });
+
+    std::vector<models::Report> reports;
+    std::vector<models::Signature> stored;
+    std::vector<models::SimilarityPair> pairs;
+    reports.reserve(count);
+    stored.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        // Копии из индексов и из пакета могут быть равны по 100%: оригинал — ранняя
+        std::sort(verified[i].begin(), verified[i].end(), higherScore);
+        AnalyzeResult result = verdict(requests[i], verified[i]);
+        reports.push_back(toReport(requests[i], result));
+        batch.results.push_back(result);
+
+        // В БД — все отпечатки: document frequency при старте считается заново
+        stored.push_back(signatures[i]);
+        stored.back().fingerprints = files[fileOf[i]].rawFingerprints;
+
+        pairs.insert(pairs.end(), rows[i].begin(), rows[i].end());
+    }
+
+    // Общие индексы получают работы пакета из БД, как и любые завершённые
+    // отчёты. Если запись не удалась, в индексах и на шардах ничего не осталось
+    repository::BatchCompletion completion = repo_.createBatch(reports, stored, pairs);
+    for (size_t i = 0; i < count; ++i) {
+        batch.results[i].reportId = completion.reportIds[i];
+    }
+    syncIndexes();
+
+    for (size_t i = 0; i < count; ++i) {
+        shards_.publish(completion.completedXid, requests[i].taskId, requests[i].submissionId,
+                        requests[i].studentName, signatures[i].fingerprints);
+    }
+
+    batch.elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    std::cout << "[AnalysisService] Batch of " << count << " submissions analyzed in "
+              << batch.elapsedMs << " ms" << std::endl;
+    return batch;
+}
+
+std::pair<std::shared_ptr<AnalysisService::Flight>, bool>
+AnalysisService::joinFlight(Participant participant, tokenizer::Language language) {
+    FlightKey key{participant.request.fileHash, participant.request.taskId, language};
+
+    std::lock_guard lock(flightsMutex_);
+    auto& flight = flights_[key];
+    bool leading = !flight;
+    if (leading) {
+        flight = std::make_shared<Flight>();
+        flight->key = key;
+    }
+    flight->members.push_back(std::move(participant));
+    return {flight, leading};
+}
+
+void AnalysisService::land(const Flight& flight) {
+    // Кто придёт после посадки, откроет новый полёт и увидит в индексах
+    // работы этого, если они к тому времени завершатся
+    {
+        std::lock_guard lock(flightsMutex_);
+        flights_.erase(flight.key);
+    }
+
+    if (flight.members.size() > 1) {
+        std::cout << "[AnalysisService] " << flight.members.size()
+                  << " identical submissions analyzed as one" << std::endl;
+    }
+}
+
+void AnalysisService::fingerprint(Flight& flight, const AnalyzeRequest& request,
+                                  const tokenizer::Tokenizer& tokenizer) {
+    std::string content = fileClient_.getFileContent(request.submissionId);
+    if (content.empty()) {
+        std::cerr << "[AnalysisService] Empty content for submission "
+                  << request.submissionId << ", fingerprinting skipped" << std::endl;
+        return;
+    }
+    flight.tokens = tokenizer.tokenize(content);
+
+    // Шаблонные отпечатки не участвуют ни в поиске, ни в индексах
+    flight.rawFingerprints = winnowing_.fingerprints(flight.tokens);
+    flight.signature.fingerprints = boilerplate_.filter(request.taskId, flight.rawFingerprints);
+    flight.signature.minhash = minhash_.signature(flight.signature.fingerprints);
+    flight.signature.simhash = similarity::SimHash::compute(flight.signature.fingerprints);
+}
+
+std::vector<Match> AnalysisService::matchCandidates(Flight& flight, const AnalyzeRequest& request,
+                                                    const tokenizer::Tokenizer& tokenizer) {
+    auto candidates = findCopies(request, nullptr);
+    if (candidates.empty()) {
+        candidates = flight.similar;
+    }
+    candidates = selectCandidates(request, std::move(candidates));
+
+    // Участник полёта, уже попавший в индексы, — точная копия: не сравнивается
+    std::unordered_set<int> members;
+    for (const auto& member : flight.members) {
+        members.insert(member.request.submissionId);
+    }
+
+    std::vector<Match> missing;
+    {
+        std::lock_guard lock(flight.mutex);
+        for (const auto& candidate : candidates) {
+            if (!members.count(candidate.submissionId) && !flight.verified.count(candidate.submissionId)) {
+                missing.push_back(candidate);
+            }
+        }
+    }
+
+    std::unordered_map<int, Match> own;
+    if (!missing.empty()) {
+        for (const auto& match : verifyCandidates(request.taskId, request.submissionId, tokenizer,
+                                                  flight.tokens, missing)) {
+            own.emplace(match.submissionId, match);
+        }
+    }
 
-    int reportId = repo_.create(report);
+    // Содержимое у всех участников одно, поэтому проверка годится всем;
+    // оценки фильтров (без проверки) остаются своими
+    std::vector<Match> result;
+    result.reserve(candidates.size());
+    std::lock_guard lock(flight.mutex);
+    for (const auto& [id, match] : own) {
+        if (match.verified) {
+            flight.verified.emplace(id, match);
+        }
+    }
+    for (const auto& candidate : candidates) {
+        if (members.count(candidate.submissionId)) {
+            result.push_back({candidate.submissionId, 100.0, !flight.tokens.empty()});
+            continue;
+        }
+        auto shared = flight.verified.find(candidate.submissionId);
+        result.push_back(shared != flight.verified.end() ? shared->second
+                                                         : own.at(candidate.submissionId));
+    }
+    std::sort(result.begin(), result.end(), higherScore);
+    return result;
+}
 
-    // Формируем результат
+AnalyzeResult AnalysisService::verdict(const AnalyzeRequest& request,
+                                       const std::vector<Match>& verified) const {
     AnalyzeResult result;
-    result.reportId = reportId;
+    result.reportId = 0;
     result.submissionId = request.submissionId;
-    result.isPlagiarism = isPlagiarism;
-    result.similarityPercent = similarityPercent;
-    result.originalSubmissionId = originalSubmissionId;
+    result.isPlagiarism = false;
+    result.similarityPercent = 0.0;
     result.status = "completed";
 
+    if (!verified.empty()) {
+        const Match& match = verified.front();
+        result.similarityPercent = match.similarityPercent;
+
+        if (result.similarityPercent >= plagiarismThreshold_) {
+            result.isPlagiarism = true;
+            result.originalSubmissionId = match.submissionId;
+
+            std::cout << "[AnalysisService] PLAGIARISM DETECTED! Original submission: "
+                      << match.submissionId << ", similarity " << result.similarityPercent
+                      << "%" << std::endl;
+        }
+    }
     return result;
 }
 
@@ -66,4 +523,753 @@ std::vector<models::Report> AnalysisService::getReportsByTask(const std::string&
     return repo_.findByTaskId(taskId);
 }
 
+SimilarityMatrix AnalysisService::similarityMatrix(const std::string& taskId, double minPercent) {
+    auto started = std::chrono::steady_clock::now();
+
+    SimilarityMatrix matrix;
+    matrix.taskId = taskId;
+
+    auto signatures = repo_.findSignaturesByTask(taskId);
+    pool_.parallelFor(signatures.size(), [&](size_t i) {
+        auto& fingerprints = signatures[i].signature.fingerprints;
+        fingerprints = boilerplate_.filter(taskId, fingerprints);
+    }, 16);
+
+    // Отпечатки задания переводятся в плотные 32-битные номера; отображение
+    // монотонное, поэтому множества остаются отсортированными
+    std::vector<uint64_t> universe;
+    for (const auto& s : signatures) {
+        universe.insert(universe.end(), s.signature.fingerprints.begin(), s.signature.fingerprints.end());
+    }
+    std::sort(universe.begin(), universe.end());
+    universe.erase(std::unique(universe.begin(), universe.end()), universe.end());
+
+    std::vector<std::vector<uint32_t>> sets(signatures.size());
+    pool_.parallelFor(signatures.size(), [&](size_t i) {
+        const auto& fingerprints = signatures[i].signature.fingerprints;
+        auto& set = sets[i];
+        set.reserve(fingerprints.size());
+        for (uint64_t fp : fingerprints) {
+            set.push_back(static_cast<uint32_t>(
+                std::lower_bound(universe.begin(), universe.end(), fp) - universe.begin()));
+        }
+    }, 16);
+
+    for (const auto& s : signatures) {
+        matrix.submissions.push_back({s.submissionId, s.studentName, s.signature.fingerprints.size()});
+    }
+
+    for (const auto& pair : pairwise_.compute(sets, minPercent / 100.0)) {
+        matrix.pairs.push_back({signatures[pair.first].submissionId,
+                                signatures[pair.second].submissionId,
+                                pair.sharedFingerprints,
+                                100.0 * pair.similarity});
+    }
+
+    matrix.elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+
+    std::cout << "[AnalysisService] Similarity matrix for task " << taskId << ": "
+              << signatures.size() << " submissions, " << matrix.pairs.size()
+              << " pairs >= " << minPercent << "% in " << matrix.elapsedMs << " ms" << std::endl;
+
+    return matrix;
+}
+
+indexing::IndexStats AnalysisService::indexStats() const {
+    return index_.stats();
+}
+
+std::vector<indexing::Candidate> AnalysisService::queryShard(const std::string& taskId,
+                                                             const std::vector<uint64_t>& fingerprints,
+                                                             size_t minShared) {
+    return index_.query(taskId, fingerprints, minShared);
+}
+
+void AnalysisService::addShardPostings(int64_t completedXid, const std::string& taskId, int submissionId,
+                                       const std::string& studentName,
+                                       const std::vector<uint64_t>& fingerprints,
+                                       size_t fingerprintCount) {
+    index_.add(taskId, submissionId, studentName, fingerprints, fingerprintCount);
+
+    // Отчёты до snapshotCompletedXid_ при старте не догоняются: работа,
+    // завершённая раньше, но пришедшая с другого узла после снимка, сразу
+    // сбрасывается на диск
+    if (completedXid <= snapshotCompletedXid_) {
+        index_.flush();
+    }
+}
+
+size_t AnalysisService::normalizeStoredHashes() {
+    auto raw = repo_.findRawFileHashes();
+    size_t updated = 0;
+    for (const auto& entry : raw) {
+        if (auto hash = fileClient_.getFileHash(entry.submissionId)) {
+            repo_.updateFileHash(entry.submissionId, *hash);
+            ++updated;
+        }
+    }
+    if (updated < raw.size()) {
+        std::cerr << "[AnalysisService] " << raw.size() - updated
+                  << " reports keep raw file hashes until the next start" << std::endl;
+    }
+    return updated;
+}
+
+size_t AnalysisService::restoreIndex() {
+    // Горизонт берётся до чтения хэшей: у всех отчётов, завершённых до него,
+    // хэши уже прочитаны, а более поздние догонит catchUp
+    int64_t horizon = repo_.completionHorizon();
+
+    // Хэши — по 32 байта на работу: читать их из БД дешевле, чем хранить в снимке
+    for (const auto& entry : repo_.findAllFileHashes()) {
+        hashIndex_.add(entry.hash, entry.submissionId, entry.studentName);
+    }
+    std::cout << "[AnalysisService] File hash index: " << hashIndex_.size()
+              << " distinct hashes" << std::endl;
+
+    if (!snapshotPath_.empty()) {
+        if (auto restored = restoreFromSnapshot(horizon)) {
+            return *restored;
+        }
+    }
+    return restoreFromReports(horizon);
+}
+
+size_t AnalysisService::restoreFromReports(int64_t horizon) {
+    for (const auto& baseFile : repo_.findAllBaseFiles()) {
+        registerBaseFile(baseFile);
+        raiseTo(lastBaseFileId_, baseFile.id);
+    }
+
+    // Работы идут по submission_id, поэтому фильтр видит ту же
+    // document frequency, что и при их анализе
+    auto signatures = repo_.findAllSignatures(horizon);
+    replaySignatures(signatures);
+    replaySimilarityPairs(repo_.findAllSimilarityPairs(horizon));
+    lastCompletedXid_ = horizon - 1;
+
+    std::cout << "[AnalysisService] Cold start: " << signatures.size()
+              << " submissions restored from reports" << std::endl;
+    return signatures.size();
+}
+
+std::optional<size_t> AnalysisService::restoreFromSnapshot(int64_t horizon) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::unique_ptr<indexing::MappedSnapshot> snapshot;
+    try {
+        snapshot = indexing::MappedSnapshot::open(snapshotPath_);
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisService] Snapshot not used: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+    if (!snapshot) {
+        return std::nullopt;
+    }
+
+    const auto& info = snapshot->info();
+    if (info.paramsHash != paramsHash_) {
+        std::cerr << "[AnalysisService] Snapshot was taken with other analysis parameters"
+                  << std::endl;
+        return std::nullopt;
+    }
+    // Индекс отпечатков живёт в сегментах: без них снимок неполон
+    if (index_.submissionCount() < info.indexSubmissions) {
+        std::cerr << "[AnalysisService] Fingerprint index segments are behind the snapshot"
+                  << std::endl;
+        return std::nullopt;
+    }
+
+    // Пустое состояние, чтобы откатиться, если снимок прочитан не до конца
+    indexing::SnapshotWriter pristine;
+    boilerplate_.save(pristine);
+    lshIndex_.save(pristine);
+    simhashIndex_.save(pristine);
+    graph_.save(pristine);
+
+    try {
+        auto in = snapshot->reader();
+        boilerplate_.load(in);
+        lshIndex_.load(in);
+        simhashIndex_.load(in);
+        graph_.load(in);
+        if (!in.atEnd()) {
+            throw std::runtime_error("trailing data in snapshot");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[AnalysisService] Snapshot not used: " << e.what() << std::endl;
+        indexing::SnapshotReader in(pristine.data().data(), pristine.data().size());
+        boilerplate_.load(in);
+        lshIndex_.load(in);
+        simhashIndex_.load(in);
+        graph_.load(in);
+        return std::nullopt;
+    }
+    lastBaseFileId_ = static_cast<int>(info.lastBaseFileId);
+    snapshotCompletedXid_ = info.lastCompletedXid;
+
+    // Догоняем то, что записано после снимка: заготовки, затем работы
+    // в порядке завершения
+    for (const auto& baseFile : repo_.findBaseFilesAfter(lastBaseFileId_)) {
+        registerBaseFile(baseFile);
+        raiseTo(lastBaseFileId_, baseFile.id);
+    }
+    auto signatures = repo_.findSignaturesAfter(info.lastCompletedXid, horizon);
+    replaySignatures(signatures);
+    replaySimilarityPairs(repo_.findSimilarityPairsAfter(info.lastCompletedXid, horizon));
+    lastCompletedXid_ = std::max(info.lastCompletedXid, horizon - 1);
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "[AnalysisService] Warm start from snapshot (" << snapshot->size() / 1024
+              << " KiB, transaction " << info.lastCompletedXid << ") in " << elapsedMs << " ms, "
+              << signatures.size() << " newer submissions replayed" << std::endl;
+
+    return index_.submissionCount();
+}
+
+size_t AnalysisService::syncIndexes() {
+    std::shared_lock apply(applyMutex_);
+    std::lock_guard completion(completionMutex_);
+    return catchUp();
+}
+
+size_t AnalysisService::catchUp() {
+    int64_t after = lastCompletedXid_;
+    int64_t horizon = repo_.completionHorizon();
+    if (horizon <= after + 1) {
+        return 0;
+    }
+
+    auto signatures = repo_.findSignaturesAfter(after, horizon);
+    if (!signatures.empty()) {
+        for (const auto& entry : repo_.findFileHashesAfter(after, horizon)) {
+            hashIndex_.add(entry.hash, entry.submissionId, entry.studentName);
+        }
+        replaySignatures(signatures);
+        replaySimilarityPairs(repo_.findSimilarityPairsAfter(after, horizon));
+    }
+    lastCompletedXid_ = horizon - 1;
+    return signatures.size();
+}
+
+void AnalysisService::replaySignatures(const std::vector<models::SubmissionSignature>& signatures) {
+    for (const auto& s : signatures) {
+        auto fingerprints = boilerplate_.filter(s.taskId, s.signature.fingerprints);
+
+        // Работы из сегментов индекса на диске add пропускает; у каждого
+        // шарда — только свой диапазон отпечатков
+        shards_.addLocal(s.taskId, s.submissionId, s.studentName, fingerprints);
+        lshIndex_.add(s.taskId, s.submissionId, s.studentName, s.signature.minhash);
+        if (!fingerprints.empty()) {
+            simhashIndex_.add(s.taskId, s.submissionId, s.studentName, s.signature.simhash);
+        }
+        boilerplate_.recordSubmission(s.taskId, s.signature.fingerprints);
+    }
+}
+
+void AnalysisService::replaySimilarityPairs(const std::vector<models::SimilarityPair>& pairs) {
+    // Строки матрицы идут по submission_id — собираем их целиком
+    for (size_t i = 0; i < pairs.size();) {
+        size_t end = i;
+        std::vector<indexing::SimilarityEdge> edges;
+        while (end < pairs.size() && pairs[end].submissionId == pairs[i].submissionId) {
+            edges.push_back({pairs[end].otherSubmissionId, pairs[end].similarityPercent,
+                             pairs[end].verified});
+            ++end;
+        }
+        graph_.addRow(pairs[i].taskId, pairs[i].submissionId, edges);
+        i = end;
+    }
+}
+
+bool AnalysisService::saveSnapshot() {
+    if (snapshotPath_.empty()) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    indexing::SnapshotWriter out;
+    indexing::SnapshotInfo info;
+    {
+        std::unique_lock lock(applyMutex_);
+        boilerplate_.save(out);
+        lshIndex_.save(out);
+        simhashIndex_.save(out);
+        graph_.save(out);
+        info.lastCompletedXid = lastCompletedXid_;
+        info.lastBaseFileId = lastBaseFileId_;
+        info.indexSubmissions = index_.submissionCount();
+        snapshotCompletedXid_ = lastCompletedXid_.load();
+    }
+    info.paramsHash = paramsHash_;
+    info.createdAt = static_cast<int64_t>(std::time(nullptr));
+
+    // Отпечатки снимок не копирует: всё, что в нём учтено, уже в сегментах
+    index_.flush();
+    indexing::writeSnapshotFile(snapshotPath_, info, out.data());
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "[AnalysisService] Snapshot saved: transaction " << info.lastCompletedXid << ", "
+              << out.data().size() / 1024 << " KiB in " << elapsedMs << " ms" << std::endl;
+    return true;
+}
+
+void AnalysisService::startSnapshots(std::chrono::seconds interval) {
+    if (snapshotPath_.empty() || interval.count() == 0 || snapshots_.joinable()) {
+        return;
+    }
+    snapshotInterval_ = interval;
+    snapshots_ = std::thread(&AnalysisService::snapshotLoop, this);
+}
+
+void AnalysisService::snapshotLoop() {
+    std::unique_lock lock(stopMutex_);
+    while (!stopCv_.wait_for(lock, snapshotInterval_, [this] { return stopping_; })) {
+        lock.unlock();
+        try {
+            saveSnapshot();
+        } catch (const std::exception& e) {
+            std::cerr << "[AnalysisService] Snapshot failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+BaseFileResult AnalysisService::addBaseFile(const std::string& taskId, const std::string& filename,
+                                            const std::string& content) {
+    models::BaseFile baseFile;
+    baseFile.taskId = taskId;
+    baseFile.filename = filename;
+    baseFile.content = content;
+
+    BaseFileResult result;
+    {
+        std::shared_lock apply(applyMutex_);
+        baseFile.id = repo_.createBaseFile(baseFile);
+        result.fingerprintCount = registerBaseFile(baseFile);
+        raiseTo(lastBaseFileId_, baseFile.id);
+    }
+    result.id = baseFile.id;
+
+    // Код заготовки вырезается до сжатия: размеры работ для NCD устарели
+    {
+        std::lock_guard lock(compressedMutex_);
+        compressedSizes_.clear();
+    }
+    result.taskId = taskId;
+    result.filename = filename;
+
+    std::cout << "[AnalysisService] Base file " << filename << " registered for task " << taskId
+              << ": " << result.fingerprintCount << " fingerprints excluded" << std::endl;
+
+    return result;
+}
+
+std::vector<models::BaseFile> AnalysisService::getBaseFiles(const std::string& taskId) {
+    return repo_.findBaseFilesByTask(taskId);
+}
+
+size_t AnalysisService::registerBaseFile(const models::BaseFile& baseFile) {
+    tokenizer::Tokenizer tokenizer(tokenizer::detectLanguage(baseFile.filename));
+    std::vector<uint32_t> tokens = tokenizer.tokenize(baseFile.content);
+    std::vector<uint64_t> fingerprints = winnowing_.fingerprints(tokens);
+
+    boilerplate_.addBaseFile(baseFile.taskId, fingerprints, std::move(tokens));
+    return fingerprints.size();
+}
+
+std::unordered_map<int, std::vector<indexing::SimilarityEdge>>
+AnalysisService::taskMatches(const std::string& taskId) {
+    return graph_.task(taskId);
+}
+
+std::vector<Match> AnalysisService::findCandidates(const AnalyzeRequest& request,
+                                                   const models::Signature& signature,
+                                                   const BatchOverlay* batch) {
+    auto candidates = findCopies(request, batch);
+    if (candidates.empty() && !signature.fingerprints.empty()) {
+        candidates = findSimilar(request.taskId, signature,
+                                 {{request.submissionId, request.studentName}}, batch);
+    }
+    return selectCandidates(request, std::move(candidates));
+}
+
+std::vector<Match> AnalysisService::findCopies(const AnalyzeRequest& request,
+                                               const BatchOverlay* batch) const {
+    std::vector<Match> copies;
+    if (auto original = hashIndex_.findOriginal(request.fileHash, request.submissionId,
+                                                request.studentName)) {
+        copies.push_back({*original, 100.0});
+    }
+    if (batch != nullptr) {
+        if (auto original = batch->hashes.findOriginal(request.fileHash, request.submissionId,
+                                                       request.studentName)) {
+            copies.push_back({*original, 100.0});
+        }
+    }
+    return copies;
+}
+
+std::vector<Match> AnalysisService::findSimilar(const std::string& taskId,
+                                                const models::Signature& signature,
+                                                const std::vector<std::pair<int, std::string>>& works,
+                                                const BatchOverlay* batch) {
+    // Запрос этапов — за всех сразу: до самой поздней работы, а студент
+    // отсекается, только если он у всех один
+    AnalyzeRequest probe;
+    probe.taskId = taskId;
+    probe.submissionId = 0;
+    probe.studentName = works.front().second;
+    for (const auto& [submissionId, studentName] : works) {
+        probe.submissionId = std::max(probe.submissionId, submissionId);
+        if (studentName != probe.studentName) {
+            probe.studentName.clear();
+        }
+    }
+
+    std::vector<Match> candidates;
+    auto satisfied = [&](const std::pair<int, std::string>& work) {
+        return std::any_of(candidates.begin(), candidates.end(), [&](const Match& m) {
+            return m.similarityPercent >= plagiarismThreshold_ && m.submissionId < work.first &&
+                   m.studentName != work.second;
+        });
+    };
+    auto take = [&](const std::vector<Match>& found) {
+        candidates.insert(candidates.end(), found.begin(), found.end());
+        return std::all_of(works.begin(), works.end(), satisfied);
+    };
+
+    // Этапы от дешёвых к дорогим: когда у каждой работы есть кандидат выше
+    // порога, дальше не идём. Работы пакета — в маленьком индексе в памяти,
+    // он дешевле всех этапов
+    if (batch != nullptr && take(findInBatch(probe, signature, *batch))) {
+        return candidates;
+    }
+
+    using Stage = std::vector<Match> (AnalysisService::*)(const AnalyzeRequest&,
+                                                          const models::Signature&);
+    const Stage stages[] = {
+        &AnalysisService::findBySimHash,
+        &AnalysisService::findByMinHash,
+        &AnalysisService::findByFingerprints,
+    };
+    for (Stage stage : stages) {
+        if (take((this->*stage)(probe, signature))) {
+            break;
+        }
+    }
+    return candidates;
+}
+
+std::vector<Match> AnalysisService::selectCandidates(const AnalyzeRequest& request,
+                                                     std::vector<Match> candidates) const {
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const Match& m) {
+                         return m.submissionId >= request.submissionId ||
+                                m.studentName == request.studentName;
+                     }),
+                     candidates.end());
+
+    // Один кандидат — одна оценка (лучшая), по убыванию оценки
+    std::sort(candidates.begin(), candidates.end(), [](const Match& a, const Match& b) {
+        if (a.submissionId != b.submissionId) {
+            return a.submissionId < b.submissionId;
+        }
+        return a.similarityPercent > b.similarityPercent;
+    });
+    candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                 [](const Match& a, const Match& b) {
+                                     return a.submissionId == b.submissionId;
+                                 }),
+                     candidates.end());
+    std::sort(candidates.begin(), candidates.end(), [](const Match& a, const Match& b) {
+        if (a.similarityPercent != b.similarityPercent) {
+            return a.similarityPercent > b.similarityPercent;
+        }
+        return a.submissionId < b.submissionId;
+    });
+
+    if (candidates.size() > verifyTopN_) {
+        candidates.resize(verifyTopN_);
+    }
+    return candidates;
+}
+
+std::vector<Match> AnalysisService::verifyCandidates(
+    const std::string& taskId, int submissionId, const tokenizer::Tokenizer& tokenizer,
+    const std::vector<uint32_t>& tokens, const std::vector<Match>& candidates,
+    const std::unordered_map<int, std::shared_ptr<const std::string>>& contents) {
+    // Код из заготовок вырезается из обеих работ до сравнения
+    auto baseTokens = boilerplate_.baseTokens(taskId);
+
+    // Пока своя работа очищается от заготовок (и сжимается для NCD),
+    // содержимое кандидатов скачивается и разбирается параллельно
+    std::vector<uint32_t> ownTokens;
+    std::string ownEncoded;
+    size_t ownCompressed = 0;
+    std::vector<std::optional<std::vector<uint32_t>>> originals(candidates.size());
+    pool_.invoke(
+        [&] {
+            // Без токенов сравнить нечего — остаётся оценка фильтра
+            if (tokens.empty()) {
+                return;
+            }
+            pool_.parallelFor(candidates.size(), [&](size_t c) {
+                int id = candidates[c].submissionId;
+                auto known = contents.find(id);
+                std::string original = known != contents.end() ? *known->second
+                                                               : fileClient_.getFileContent(id);
+                if (!original.empty()) {
+                    originals[c] = stripBaseCode(tokenizer.tokenize(original), baseTokens);
+                }
+            });
+        },
+        [&] {
+            ownTokens = stripBaseCode(tokens, baseTokens);
+            // Для NCD работа сжимается один раз на все пары, а размеры кандидатов
+            // берутся из кэша: пара стоит одного сжатия конкатенации
+            if (verifier_ == Verifier::Ncd && !candidates.empty()) {
+                ownEncoded = ncd_.encode(ownTokens);
+                ownCompressed = compressedSize(submissionId, ownEncoded);
+            }
+        });
+
+    // Каждая пара сравнивается в своей задаче пула
+    std::vector<Match> result(candidates.begin(), candidates.end());
+    pool_.parallelFor(candidates.size(), [&](size_t c) {
+        if (!originals[c]) {
+            return;
+        }
+        Match& verified = result[c];
+        const auto& originalTokens = *originals[c];
+        if (verifier_ == Verifier::Ncd) {
+            std::string encoded = ncd_.encode(originalTokens);
+            verified.similarityPercent = 100.0 * ncd_.similarity(
+                ownEncoded, ownCompressed, encoded, compressedSize(verified.submissionId, encoded));
+        } else {
+            verified.similarityPercent = verifiedSimilarity(ownTokens, originalTokens);
+        }
+        verified.verified = true;
+    });
+
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        if (result[c].verified) {
+            std::cout << "[AnalysisService] Verified candidate " << candidates[c].submissionId
+                      << ": estimate " << candidates[c].similarityPercent << "%, "
+                      << verifierName(verifier_) << " " << result[c].similarityPercent
+                      << "%" << std::endl;
+        }
+    }
+
+    std::sort(result.begin(), result.end(), higherScore);
+    return result;
+}
+
+std::vector<models::SimilarityPair> AnalysisService::similarityRow(const AnalyzeRequest& request,
+                                                                   const models::Signature& signature,
+                                                                   const std::vector<Match>& verified,
+                                                                   const BatchOverlay* batch) {
+    // Оценка по отпечаткам для всех работ с общими отпечатками,
+    // точный результат проверки заменяет оценку
+    std::unordered_map<int, Match> row;
+
+    // Dice >= matrixFloor_ требует shared >= matrixFloor_ * ownCount / 200:
+    // индекс может не сканировать самые длинные списки целиком
+    size_t ownCount = signature.fingerprints.size();
+    auto minShared = static_cast<size_t>(std::ceil(matrixFloor_ * static_cast<double>(ownCount) / 200.0 - 1e-9));
+    auto addEstimates = [&](const std::vector<indexing::Candidate>& candidates, bool earlierOnly) {
+        for (const auto& candidate : candidates) {
+            if (candidate.submissionId == request.submissionId ||
+                candidate.studentName == request.studentName ||
+                (earlierOnly && candidate.submissionId > request.submissionId)) {
+                continue;
+            }
+
+            double dice = 200.0 * static_cast<double>(candidate.sharedFingerprints) /
+                          static_cast<double>(ownCount + candidate.fingerprintCount);
+            row[candidate.submissionId] = {candidate.submissionId, dice};
+        }
+    };
+    addEstimates(shards_.query(request.taskId, signature.fingerprints, minShared), false);
+    if (batch != nullptr) {
+        addEstimates(batch->fingerprints.query(request.taskId, signature.fingerprints, minShared), true);
+    }
+
+    for (const auto& match : verified) {
+        row[match.submissionId] = match;
+    }
+
+    std::vector<models::SimilarityPair> pairs;
+    for (const auto& [id, match] : row) {
+        if (match.similarityPercent < matrixFloor_) {
+            continue;
+        }
+
+        models::SimilarityPair pair;
+        pair.taskId = request.taskId;
+        pair.submissionId = request.submissionId;
+        pair.otherSubmissionId = id;
+        pair.similarityPercent = match.similarityPercent;
+        pair.verified = match.verified;
+        pairs.push_back(pair);
+    }
+
+    return pairs;
+}
+
+std::vector<uint32_t> AnalysisService::stripBaseCode(
+    const std::vector<uint32_t>& tokens,
+    const std::vector<std::shared_ptr<const std::vector<uint32_t>>>& baseTokens) const {
+    if (baseTokens.empty() || tokens.empty()) {
+        return tokens;
+    }
+
+    // Токены, покрытые тайлами GST с любой заготовкой, выбрасываются (как base code в JPlag);
+    // заготовки сравниваются с работой параллельно
+    std::vector<similarity::TilingResult> tilings(baseTokens.size());
+    pool_.parallelFor(baseTokens.size(), [&](size_t b) {
+        tilings[b] = tiling_.compare(tokens, *baseTokens[b]);
+    });
+
+    std::vector<bool> covered(tokens.size(), false);
+    for (const auto& tiling : tilings) {
+        for (const auto& tile : tiling.tiles) {
+            std::fill(covered.begin() + tile.first, covered.begin() + tile.first + tile.length, true);
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (!covered[i]) {
+            result.push_back(tokens[i]);
+        }
+    }
+    return result;
+}
+
+double AnalysisService::verifiedSimilarity(const std::vector<uint32_t>& tokens,
+                                           const std::vector<uint32_t>& original) const {
+    switch (verifier_) {
+        case Verifier::Lcs:
+            return 100.0 * similarity::BitParallel::lcsSimilarity(tokens, original);
+        case Verifier::EditDistance:
+            return 100.0 * similarity::BitParallel::editSimilarity(tokens, original);
+        case Verifier::Ncd:
+            return 100.0 * ncd_.similarity(tokens, original);
+        case Verifier::Gst:
+            break;
+    }
+    return 100.0 * tiling_.compare(tokens, original).similarity;
+}
+
+size_t AnalysisService::compressedSize(int submissionId, const std::string& encoded) {
+    {
+        std::lock_guard lock(compressedMutex_);
+        auto it = compressedSizes_.find(submissionId);
+        if (it != compressedSizes_.end()) {
+            return it->second;
+        }
+    }
+
+    size_t size = ncd_.compressedSize(encoded);
+
+    std::lock_guard lock(compressedMutex_);
+    compressedSizes_[submissionId] = size;
+    return size;
+}
+
+std::vector<Match> AnalysisService::findBySimHash(const AnalyzeRequest& request,
+                                                  const models::Signature& signature) {
+    std::vector<Match> result;
+
+    for (const auto& candidate : simhashIndex_.query(request.taskId, signature.simhash)) {
+        if (candidate.submissionId >= request.submissionId ||
+            candidate.studentName == request.studentName) {
+            continue;
+        }
+
+        result.push_back({candidate.submissionId,
+                          100.0 * similarity::SimHash::estimateCosine(candidate.distance), false,
+                          candidate.studentName});
+        if (result.size() >= verifyTopN_) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+std::vector<Match> AnalysisService::findByMinHash(const AnalyzeRequest& request,
+                                                  const models::Signature& signature) {
+    std::vector<Match> result;
+
+    for (const auto& candidate : lshIndex_.query(request.taskId, signature.minhash)) {
+        if (candidate.submissionId >= request.submissionId ||
+            candidate.studentName == request.studentName) {
+            continue;
+        }
+
+        result.push_back({candidate.submissionId, 100.0 * candidate.estimatedJaccard, false,
+                          candidate.studentName});
+        if (result.size() >= verifyTopN_) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+std::vector<Match> AnalysisService::findInBatch(const AnalyzeRequest& request,
+                                                const models::Signature& signature,
+                                                const BatchOverlay& batch) {
+    std::vector<Match> result;
+    const auto& fingerprints = signature.fingerprints;
+
+    for (const auto& candidate : batch.fingerprints.query(request.taskId, fingerprints)) {
+        if (candidate.submissionId >= request.submissionId ||
+            candidate.studentName == request.studentName) {
+            continue;
+        }
+
+        // Та же оценка, что и в findByFingerprints
+        result.push_back({candidate.submissionId,
+                          100.0 * static_cast<double>(candidate.sharedFingerprints) /
+                              static_cast<double>(fingerprints.size()),
+                          false, candidate.studentName});
+        if (result.size() >= verifyTopN_) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+std::vector<Match> AnalysisService::findByFingerprints(const AnalyzeRequest& request,
+                                                       const models::Signature& signature) {
+    std::vector<Match> result;
+    const auto& fingerprints = signature.fingerprints;
+
+    for (const auto& candidate : shards_.query(request.taskId, fingerprints)) {
+        if (candidate.submissionId >= request.submissionId ||
+            candidate.studentName == request.studentName) {
+            continue;
+        }
+
+        // Доля отпечатков новой работы, встречающихся в более ранней
+        result.push_back({candidate.submissionId,
+                          100.0 * static_cast<double>(candidate.sharedFingerprints) /
+                              static_cast<double>(fingerprints.size()),
+                          false, candidate.studentName});
+        if (result.size() >= verifyTopN_) {
+            break;
+        }
+    }
+
+    return result;
+}
+
 }
\ No newline at end of file
@@ -5,10 +5,43 @@
 
 #include "../repository/reportrepository.h"
 #include "../clients/fileserviceclient.h"
+#include "../config/config.h"
+#include "../concurrency/threadpool.h"
+#include "../indexing/fingerprintindex.h"
+#include "../indexing/hashindex.h"
+#include "../indexing/lshindex.h"
+#include "../indexing/simhashindex.h"
+#include "../indexing/similaritygraph.h"
+#include "../indexing/boilerplatefilter.h"
+#include "../sharding/shardedindex.h"
+#include "../similarity/winnowing.h"
+#include "../similarity/minhash.h"
+#include "../similarity/greedytiling.h"
+#include "../similarity/bitparallel.h"
+#include "../similarity/ncd.h"
+#include "../similarity/pairwise.h"
+#include "../tokenizer/tokenizer.h"
 #include "../models/report.h"
+#include "../models/similaritypair.h"
+#include "../models/basefile.h"
+#include "../models/filehash.h"
 #include <string>
 #include <vector>
 #include <optional>
+#include <memory>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <exception>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 
 namespace service {
 
@@ -17,7 +50,8 @@ struct AnalyzeRequest {
   int submissionId;
   std::string taskId;
   std::string studentName;
-  std::string fileHash;
+  models::Sha256 fileHash{};
+  std::string filename;  // по расширению выбирается токенизатор
 };
 
 // Результат анализа
@@ -30,19 +64,320 @@ struct AnalyzeResult {
   std::string status;
 };
 
+// Результат анализа пакета работ
+struct BatchResult {
+  std::vector<AnalyzeResult> results;  // по возрастанию submission_id
+  size_t distinctFiles = 0;            // сколько разных файлов разобрано
+  double elapsedMs = 0.0;
+};
+
+// Более ранняя работа другого студента и её сходство с анализируемой
+struct Match {
+  int submissionId;
+  double similarityPercent;
+  bool verified = false;  // результат точной проверки, а не оценка фильтра
+  std::string studentName{};  // автор кандидата из индексов сходства
+};
+
+// Итог анализа одной работы: ошибка или результат
+using AnalyzeCallback = std::function<void(std::exception_ptr error, const AnalyzeResult& result)>;
+
+// Работа задания в матрице сходства
+struct MatrixSubmission {
+  int submissionId;
+  std::string studentName;
+  size_t fingerprintCount;
+};
+
+// Пара работ задания с общими отпечатками
+struct MatrixPair {
+  int firstSubmissionId;
+  int secondSubmissionId;
+  size_t sharedFingerprints;
+  double similarityPercent;
+};
+
+// Разреженная матрица попарного сходства: пары ниже порога не возвращаются
+struct SimilarityMatrix {
+  std::string taskId;
+  std::vector<MatrixSubmission> submissions;
+  std::vector<MatrixPair> pairs;
+  double elapsedMs = 0.0;
+};
+
+// Зарегистрированный файл-заготовка
+struct BaseFileResult {
+  int id;
+  std::string taskId;
+  std::string filename;
+  size_t fingerprintCount;
+};
+
+// Алгоритм точной проверки кандидатов
+enum class Verifier {
+  Gst,           // Greedy String Tiling: устойчив к перестановке блоков
+  Lcs,           // битово-параллельная LCS
+  EditDistance,  // битово-параллельное расстояние Левенштейна
+  Ncd            // Normalized Compression Distance по префиксу потока
+};
+
 class AnalysisService {
 public:
-  AnalysisService(repository::ReportRepository& repo, clients::FileServiceClient& fileClient);
+  AnalysisService(repository::ReportRepository& repo, clients::FileServiceClient& fileClient,
+                  indexing::HashIndex& hashIndex, indexing::FingerprintIndex& index,
+                  sharding::ShardedIndex& shards, indexing::LshIndex& lshIndex,
+                  indexing::SimHashIndex& simhashIndex, indexing::SimilarityGraph& graph,
+                  indexing::BoilerplateFilter& boilerplate, concurrency::ThreadPool& pool,
+                  const config::AnalysisConfig& config);
+  ~AnalysisService();
 
-  AnalyzeResult analyze(const AnalyzeRequest& request);
+  // Проанализировать работу, перевести её отчёт из pending в completed и
+  // вызвать done — ровно один раз, исключения из analyze не выходят.
+  // С lease задание очереди завершается вместе с отчётом; если аренду
+  // перехватили, done получает repository::LeaseLost и ничего не пишется.
+  // Копия файла, который уже анализируется, поток не занимает: analyze
+  // сразу возвращается, а done вызовет анализирующий первый экземпляр
+  void analyze(int pendingReportId, const AnalyzeRequest& request,
+               const std::optional<models::JobLease>& lease, AnalyzeCallback done);
+
+  // Пакет работ (импорт из LMS): файлы читаются и разбираются параллельно,
+  // одинаковые (тот же хэш) — один раз, отчёты пишутся одной вставкой.
+  // Работы учитываются по возрастанию submission_id, поэтому оригиналом,
+  // как и при поштучной загрузке, остаётся работа с меньшим id
+  BatchResult analyzeBatch(std::vector<AnalyzeRequest> requests);
+
+  // Сходство всех пар работ задания по отпечаткам (на всех ядрах)
+  SimilarityMatrix similarityMatrix(const std::string& taskId, double minPercent);
 
   std::optional<models::Report> getReport(int submissionId);
 
   std::vector<models::Report> getReportsByTask(const std::string& taskId);
 
+  // Файл-заготовка задания: его код не считается совпадением
+  BaseFileResult addBaseFile(const std::string& taskId, const std::string& filename,
+                             const std::string& content);
+
+  std::vector<models::BaseFile> getBaseFiles(const std::string& taskId);
+
+  // Сохранённые пары матрицы сходства для всех работ задания
+  std::unordered_map<int, std::vector<indexing::SimilarityEdge>> taskMatches(const std::string& taskId);
+
+  // Догнать индексы по отчётам, завершённым в общей БД этим и другими
+  // процессами анализа; возвращает число добавленных работ
+  size_t syncIndexes();
+
+  // Заменить в отчётах хэши, посчитанные по сырым байтам, хэшами канонической
+  // формы из File Storing Service (он пересчитывает свои при старте). Вызывается
+  // до restoreIndex; недоступные работы остаются до следующего старта.
+  // Возвращает число обновлённых работ
+  size_t normalizeStoredHashes();
+
+  // Восстановить индексы сходства и матрицу: из снимка с догоном по новым
+  // отчётам, а если снимка нет или он не подходит — из всех отчётов.
+  // Индекс копий всегда собирается из БД. Возвращает число работ в индексах.
+  size_t restoreIndex();
+
+  // Записать снимок индексов в INDEX_DIR; false, если снимки выключены
+  bool saveSnapshot();
+
+  // Периодические снимки в фоне
+  void startSnapshots(std::chrono::seconds interval);
+
+  // Размер индекса отпечатков и эффективность фильтров Блума
+  indexing::IndexStats indexStats() const;
+
+  // Запросы соседних узлов к диапазону индекса отпечатков этого узла
+  std::vector<indexing::Candidate> queryShard(const std::string& taskId,
+                                              const std::vector<uint64_t>& fingerprints,
+                                              size_t minShared);
+  void addShardPostings(int64_t completedXid, const std::string& taskId, int submissionId,
+                        const std::string& studentName, const std::vector<uint64_t>& fingerprints,
+                        size_t fingerprintCount);
+
 private:
+  // Одновременные анализы одного файла в одном задании (single-flight):
+  // первый (ведущий) читает и разбирает файл и один раз на всех ищет
+  // кандидатов, остальные только оставляют продолжение и освобождают поток.
+  // После посадки ведущий завершает свою работу, затем параллельно — их.
+  // Отчёт у каждой работы свой
+  using FlightKey = std::tuple<models::Sha256, std::string, tokenizer::Language>;
+  struct Participant {
+    int pendingReportId = 0;
+    AnalyzeRequest request;
+    std::optional<models::JobLease> lease;
+    AnalyzeCallback done;
+  };
+  struct Flight {
+    FlightKey key;
+    // Ведущий первым, затем ждущие. Дополняются под flightsMutex_, пока
+    // полёт в flights_, после посадки не меняются
+    std::vector<Participant> members;
+
+    std::vector<uint32_t> tokens;
+    std::vector<uint64_t> rawFingerprints;
+    models::Signature signature;
+    std::vector<Match> similar;  // кандидаты индексов сходства на всех участников
+
+    std::mutex mutex;
+    std::unordered_map<int, Match> verified;  // проверенные кандидаты по submission_id
+  };
+
+  // Присоединиться к полёту этого файла или открыть новый (true — ведущий)
+  std::pair<std::shared_ptr<Flight>, bool> joinFlight(Participant participant,
+                                                      tokenizer::Language language);
+  // Закрыть полёт для новых участников
+  void land(const Flight& flight);
+  // Токены и сигнатуры файла
+  void fingerprint(Flight& flight, const AnalyzeRequest& request,
+                   const tokenizer::Tokenizer& tokenizer);
+  // Кандидаты работы: точная копия или общий список полёта без своих и более
+  // поздних работ. Сравниваются только ещё не проверенные в полёте.
+  // По убыванию сходства, при равенстве — более ранние
+  std::vector<Match> matchCandidates(Flight& flight, const AnalyzeRequest& request,
+                                     const tokenizer::Tokenizer& tokenizer);
+  // Вердикт участника, его отчёт в БД и работа в индексах
+  AnalyzeResult complete(Flight& flight, const Participant& member,
+                         const tokenizer::Tokenizer& tokenizer);
+
+  // Работы пакета до записи в БД: в общие индексы они попадают только после
+  // неё, а друг друга находят здесь. При ошибке записи просто выбрасывается
+  struct BatchOverlay {
+    indexing::HashIndex hashes;
+    indexing::FingerprintIndex fingerprints;
+  };
+
+  // Кандидаты из дешёвых фильтров: точная копия по индексу хэшей, затем индексы
+  // сходства от дешёвых к дорогим. Не больше verifyTopN_, по убыванию оценки.
+  // С batch — и среди более ранних работ пакета
+  std::vector<Match> findCandidates(const AnalyzeRequest& request,
+                                    const models::Signature& signature,
+                                    const BatchOverlay* batch = nullptr);
+  // Точные копии по хэшу: самая ранняя более старая работа другого студента
+  std::vector<Match> findCopies(const AnalyzeRequest& request, const BatchOverlay* batch) const;
+  // Индексы сходства для нескольких работ задания (submission_id, студент)
+  // за один проход: этапы идут от дешёвых к дорогим, пока хоть у одной работы
+  // нет кандидата выше порога. Работе годятся кандидаты раньше неё и другого
+  // студента, отбирает их selectCandidates
+  std::vector<Match> findSimilar(const std::string& taskId, const models::Signature& signature,
+                                 const std::vector<std::pair<int, std::string>>& works,
+                                 const BatchOverlay* batch = nullptr);
+  // Кандидаты работы из общего списка: раньше неё и другого студента, одна
+  // (лучшая) оценка на кандидата, не больше verifyTopN_, по убыванию оценки
+  std::vector<Match> selectCandidates(const AnalyzeRequest& request,
+                                      std::vector<Match> candidates) const;
+  // Более ранние работы пакета с общими отпечатками
+  std::vector<Match> findInBatch(const AnalyzeRequest& request, const models::Signature& signature,
+                                 const BatchOverlay& batch);
+
+  // Точное сравнение кандидатов выбранным алгоритмом (VERIFY_ALGORITHM),
+  // по убыванию сходства. Содержимое кандидатов из contents не запрашивается
+  // у File Storing Service
+  std::vector<Match> verifyCandidates(
+      const std::string& taskId, int submissionId, const tokenizer::Tokenizer& tokenizer,
+      const std::vector<uint32_t>& tokens, const std::vector<Match>& candidates,
+      const std::unordered_map<int, std::shared_ptr<const std::string>>& contents = {});
+
+  // Вердикт по проверенным кандидатам (без id отчёта)
+  AnalyzeResult verdict(const AnalyzeRequest& request, const std::vector<Match>& verified) const;
+
+  // Поток токенов без участков, совпадающих с заготовками задания
+  std::vector<uint32_t> stripBaseCode(
+      const std::vector<uint32_t>& tokens,
+      const std::vector<std::shared_ptr<const std::vector<uint32_t>>>& baseTokens) const;
+
+  // Добавить заготовку в фильтр; возвращает число её отпечатков
+  size_t registerBaseFile(const models::BaseFile& baseFile);
+
+  // Строка матрицы сходства новой работы: пары не ниже matrixFloor_.
+  // Стоит O(числа кандидатов), а не размера задания. С batch — и пары с более
+  // ранними работами пакета; работы с большим submission_id ещё «не загружены»
+  std::vector<models::SimilarityPair> similarityRow(const AnalyzeRequest& request,
+                                                    const models::Signature& signature,
+                                                    const std::vector<Match>& verified,
+                                                    const BatchOverlay* batch = nullptr);
+
+  // Почти-дубликаты по SimHash: проверяются только работы с совпавшим блоком
+  std::vector<Match> findBySimHash(const AnalyzeRequest& request,
+                                   const models::Signature& signature);
+
+  // Почти-дубликаты из LSH: O(bands) независимо от размера задания
+  std::vector<Match> findByMinHash(const AnalyzeRequest& request,
+                                   const models::Signature& signature);
+
+  // Частичные совпадения по инвертированному индексу отпечатков
+  std::vector<Match> findByFingerprints(const AnalyzeRequest& request,
+                                        const models::Signature& signature);
+
+  // Сходство двух потоков токенов в процентах
+  double verifiedSimilarity(const std::vector<uint32_t>& tokens,
+                            const std::vector<uint32_t>& original) const;
+
+  // Сжатый размер потока работы для NCD: считается один раз на работу
+  size_t compressedSize(int submissionId, const std::string& encoded);
+
+  // Загрузка снимка и догон по отчётам после него; nullopt, если снимка
+  // нет или он снят с другими параметрами
+  // horizon — горизонт завершения, взятый до чтения хэшей файлов
+  std::optional<size_t> restoreFromSnapshot(int64_t horizon);
+  size_t restoreFromReports(int64_t horizon);
+
+  // Добавить в индексы отчёты, завершённые после lastCompletedXid_ и до
+  // горизонта, в порядке завершения; вызывается под completionMutex_
+  size_t catchUp();
+
+  // Применить к индексам сохранённые работы, заготовки и строки матрицы
+  void replaySignatures(const std::vector<models::SubmissionSignature>& signatures);
+  void replaySimilarityPairs(const std::vector<models::SimilarityPair>& pairs);
+
+  void snapshotLoop();
+
   repository::ReportRepository& repo_;
   clients::FileServiceClient& fileClient_;
+  indexing::HashIndex& hashIndex_;
+  indexing::FingerprintIndex& index_;
+  sharding::ShardedIndex& shards_;
+  indexing::LshIndex& lshIndex_;
+  indexing::SimHashIndex& simhashIndex_;
+  indexing::SimilarityGraph& graph_;
+  indexing::BoilerplateFilter& boilerplate_;
+  concurrency::ThreadPool& pool_;
+  similarity::Winnowing winnowing_;
+  similarity::MinHash minhash_;
+  similarity::GreedyStringTiling tiling_;
+  similarity::CompressionDistance ncd_;
+  similarity::PairwiseSimilarity pairwise_;
+  double plagiarismThreshold_;
+  size_t verifyTopN_;
+  double matrixFloor_;
+  Verifier verifier_;
+
+  // submission_id -> C(x) потока без кода заготовок; сбрасывается
+  // при новой заготовке
+  std::mutex compressedMutex_;
+  std::unordered_map<int, size_t> compressedSizes_;
+
+  std::mutex flightsMutex_;
+  std::map<FlightKey, std::shared_ptr<Flight>> flights_;
+
+  // Изменения индексов идут под общей блокировкой, снимок — под
+  // исключительной: в нём ровно отчёты с completed_xid <= lastCompletedXid_
+  std::shared_mutex applyMutex_;
+  // Догон индексов по БД: отчёты попадают в индексы строго в порядке
+  // завершения. Под этой блокировкой и под applyMutex_ нельзя ждать задач
+  // пула: ждущий поток выполняет чужие задачи и может войти в ту же
+  // блокировку повторно
+  std::mutex completionMutex_;
+  std::atomic<int64_t> lastCompletedXid_{0};
+  std::atomic<int> lastBaseFileId_{0};
+  std::atomic<int64_t> snapshotCompletedXid_{0};  // lastCompletedXid_ последнего снимка
+  std::string snapshotPath_;
+  uint64_t paramsHash_;
+
+  std::chrono::seconds snapshotInterval_{0};
+  std::thread snapshots_;
+  std::mutex stopMutex_;
+  std::condition_variable stopCv_;
+  bool stopping_ = false;
 };
 
 }
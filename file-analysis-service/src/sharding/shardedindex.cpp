@@ -0,0 +1,110 @@
+#include "shardedindex.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace sharding {
+
+ShardedIndex::ShardedIndex(indexing::FingerprintIndex& local, const ShardMap& map,
+                           const std::vector<std::string>& peerUrls,
+                           concurrency::ThreadPool& pool)
+    : local_(local)
+    , map_(map)
+    , pool_(pool)
+{
+    if (map_.shardCount() == 1) {
+        return;
+    }
+    if (peerUrls.size() != map_.shardCount()) {
+        throw std::invalid_argument("SHARD_PEERS must list " + std::to_string(map_.shardCount()) +
+                                    " node URLs, got " + std::to_string(peerUrls.size()));
+    }
+
+    peers_.resize(map_.shardCount());
+    for (size_t shard = 0; shard < peerUrls.size(); ++shard) {
+        if (shard != map_.shardId()) {
+            peers_[shard] = std::make_unique<clients::ShardClient>(peerUrls[shard]);
+        }
+    }
+}
+
+void ShardedIndex::addLocal(const std::string& taskId, int submissionId,
+                            const std::string& studentName,
+                            const std::vector<uint64_t>& fingerprints) {
+    local_.add(taskId, submissionId, studentName, map_.local(fingerprints), fingerprints.size());
+}
+
+void ShardedIndex::publish(int64_t completedXid, const std::string& taskId, int submissionId,
+                           const std::string& studentName, const std::vector<uint64_t>& fingerprints) {
+    if (map_.shardCount() == 1) {
+        return;
+    }
+
+    auto parts = map_.split(fingerprints);
+    pool_.parallelFor(parts.size(), [&](size_t shard) {
+        // Шарду без отпечатков работы нечего о ней знать
+        if (shard == map_.shardId() || parts[shard].empty()) {
+            return;
+        }
+        if (!peers_[shard]->add(completedXid, taskId, submissionId, studentName, parts[shard],
+                                fingerprints.size())) {
+            std::cerr << "[ShardedIndex] Submission " << submissionId << " not added to shard "
+                      << shard << " (" << peers_[shard]->url() << ")" << std::endl;
+        }
+    });
+}
+
+std::vector<indexing::Candidate> ShardedIndex::query(const std::string& taskId,
+                                                     const std::vector<uint64_t>& fingerprints,
+                                                     size_t minShared) const {
+    if (map_.shardCount() == 1) {
+        return local_.query(taskId, fingerprints, minShared);
+    }
+
+    auto parts = map_.split(fingerprints);
+    std::vector<std::vector<indexing::Candidate>> found(parts.size());
+    pool_.parallelFor(parts.size(), [&](size_t shard) {
+        if (parts[shard].empty()) {
+            return;
+        }
+        // Работа с minShared общими отпечатками делит с запросом в этом шарде
+        // не меньше minShared минус отпечатки запроса в остальных шардах.
+        // Порог по шарду не теряет таких работ, а их счёт остаётся точным.
+        size_t elsewhere = fingerprints.size() - parts[shard].size();
+        size_t shardMinShared = minShared > elsewhere ? minShared - elsewhere : 1;
+
+        found[shard] = shard == map_.shardId()
+                           ? local_.query(taskId, parts[shard], shardMinShared)
+                           : peers_[shard]->query(taskId, parts[shard], shardMinShared);
+    });
+
+    std::unordered_map<int, indexing::Candidate> merged;
+    for (auto& candidates : found) {
+        for (auto& candidate : candidates) {
+            auto [it, inserted] = merged.try_emplace(candidate.submissionId, std::move(candidate));
+            if (!inserted) {
+                it->second.sharedFingerprints += candidate.sharedFingerprints;
+            }
+        }
+    }
+
+    std::vector<indexing::Candidate> result;
+    result.reserve(merged.size());
+    for (auto& [id, candidate] : merged) {
+        if (candidate.sharedFingerprints >= minShared) {
+            result.push_back(std::move(candidate));
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const indexing::Candidate& a, const indexing::Candidate& b) {
+        if (a.sharedFingerprints != b.sharedFingerprints) {
+            return a.sharedFingerprints > b.sharedFingerprints;
+        }
+        return a.submissionId < b.submissionId;
+    });
+
+    return result;
+}
+
+}
@@ -0,0 +1,52 @@
+#ifndef SHARDEDINDEX_H
+#define SHARDEDINDEX_H
+
+#include "shardmap.h"
+#include "../clients/shardclient.h"
+#include "../concurrency/threadpool.h"
+#include "../indexing/fingerprintindex.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sharding {
+
+// Индекс отпечатков, разбитый по диапазонам хэша между узлами анализа.
+// Каждый узел хранит в своём FingerprintIndex только свой диапазон;
+// узел, анализирующий работу, рассылает её отпечатки по шардам
+// параллельно и складывает число совпадений по работам. Диапазоны
+// не пересекаются, поэтому сумма по шардам — точное число общих отпечатков.
+// С одним шардом все вызовы идут прямо в локальный индекс.
+class ShardedIndex {
+public:
+  // peerUrls — адреса всех узлов по номерам шардов (свой не используется)
+  ShardedIndex(indexing::FingerprintIndex& local, const ShardMap& map,
+               const std::vector<std::string>& peerUrls, concurrency::ThreadPool& pool);
+
+  // Добавить в локальный индекс только отпечатки своего диапазона
+  // (новая работа или восстановление из БД: каждый узел читает все работы)
+  void addLocal(const std::string& taskId, int submissionId,
+                const std::string& studentName, const std::vector<uint64_t>& fingerprints);
+
+  // Разослать остальным шардам их диапазоны отпечатков работы. Ждёт
+  // HTTP-запросов и задач пула, поэтому вызывается без блокировок сервиса
+  void publish(int64_t completedXid, const std::string& taskId, int submissionId,
+               const std::string& studentName, const std::vector<uint64_t>& fingerprints);
+
+  // Те же кандидаты, что дал бы один индекс со всеми отпечатками
+  std::vector<indexing::Candidate> query(const std::string& taskId,
+                                         const std::vector<uint64_t>& fingerprints,
+                                         size_t minShared = 1) const;
+
+  const ShardMap& map() const { return map_; }
+
+private:
+  indexing::FingerprintIndex& local_;
+  ShardMap map_;
+  std::vector<std::unique_ptr<clients::ShardClient>> peers_;  // nullptr для себя
+  concurrency::ThreadPool& pool_;
+};
+
+}
+
+#endif //SHARDEDINDEX_H
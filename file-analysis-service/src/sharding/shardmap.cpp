@@ -0,0 +1,61 @@
+#include "shardmap.h"
+#include <stdexcept>
+#include <string>
+
+namespace sharding {
+
+namespace {
+
+// Финализатор murmur3: другая функция, чем при выборе отпечатков
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}
+
+ShardMap::ShardMap(size_t shardId, size_t shardCount)
+    : shardId_(shardId)
+    , shardCount_(shardCount)
+{
+    if (shardCount_ == 0 || shardId_ >= shardCount_) {
+        throw std::invalid_argument("Invalid shard " + std::to_string(shardId_) + " of " +
+                                    std::to_string(shardCount_));
+    }
+}
+
+size_t ShardMap::shardOf(uint64_t fingerprint) const {
+    // Старшие 64 бита произведения: равные диапазоны без деления
+    return static_cast<size_t>((static_cast<unsigned __int128>(mix(fingerprint)) * shardCount_) >> 64);
+}
+
+std::vector<std::vector<uint64_t>> ShardMap::split(const std::vector<uint64_t>& fingerprints) const {
+    std::vector<std::vector<uint64_t>> parts(shardCount_);
+    for (auto& part : parts) {
+        part.reserve(fingerprints.size() / shardCount_ + 1);
+    }
+    for (uint64_t fp : fingerprints) {
+        parts[shardOf(fp)].push_back(fp);
+    }
+    return parts;
+}
+
+std::vector<uint64_t> ShardMap::local(const std::vector<uint64_t>& fingerprints) const {
+    if (shardCount_ == 1) {
+        return fingerprints;
+    }
+
+    std::vector<uint64_t> result;
+    for (uint64_t fp : fingerprints) {
+        if (owns(fp)) {
+            result.push_back(fp);
+        }
+    }
+    return result;
+}
+
+}
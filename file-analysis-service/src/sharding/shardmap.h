@@ -0,0 +1,36 @@
+#ifndef SHARDMAP_H
+#define SHARDMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sharding {
+
+// Разбиение пространства отпечатков на shardCount равных диапазонов.
+// Отпечатки — минимумы окна, то есть смещены к малым значениям, поэтому
+// диапазон выбирается по перемешанному значению.
+class ShardMap {
+public:
+  ShardMap(size_t shardId, size_t shardCount);
+
+  size_t shardOf(uint64_t fingerprint) const;
+  bool owns(uint64_t fingerprint) const { return shardOf(fingerprint) == shardId_; }
+
+  // Отпечатки по шардам; порядок внутри шарда сохраняется
+  std::vector<std::vector<uint64_t>> split(const std::vector<uint64_t>& fingerprints) const;
+
+  // Только отпечатки этого узла
+  std::vector<uint64_t> local(const std::vector<uint64_t>& fingerprints) const;
+
+  size_t shardId() const { return shardId_; }
+  size_t shardCount() const { return shardCount_; }
+
+private:
+  size_t shardId_;
+  size_t shardCount_;
+};
+
+}
+
+#endif //SHARDMAP_H
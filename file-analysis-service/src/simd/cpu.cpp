@@ -0,0 +1,45 @@
+#include "cpu.h"
+
+namespace simd {
+
+bool isaSupported(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+#if defined(ANALYSIS_SIMD_X86)
+        case Isa::Ssse3:
+            return __builtin_cpu_supports("ssse3");
+        case Isa::Sse42:
+            return __builtin_cpu_supports("sse4.2");
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2");
+#else
+        case Isa::Ssse3:
+        case Isa::Sse42:
+        case Isa::Avx2:
+            return false;
+#endif
+    }
+    return false;
+}
+
+Isa bestIsa() {
+    // Проверка CPUID делается один раз
+    static const Isa isa = isaSupported(Isa::Avx2)    ? Isa::Avx2
+                           : isaSupported(Isa::Sse42) ? Isa::Sse42
+                           : isaSupported(Isa::Ssse3) ? Isa::Ssse3
+                                                      : Isa::Scalar;
+    return isa;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Ssse3: return "ssse3";
+        case Isa::Sse42: return "sse4.2";
+        case Isa::Avx2: return "avx2";
+    }
+    return "scalar";
+}
+
+}
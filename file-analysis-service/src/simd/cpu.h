@@ -0,0 +1,23 @@
+#ifndef CPU_H
+#define CPU_H
+
+namespace simd {
+
+// Набор инструкций, которым считается ядро
+enum class Isa {
+  Scalar,
+  Ssse3,
+  Sse42,
+  Avx2
+};
+
+// Лучший набор инструкций, доступный на этом процессоре
+Isa bestIsa();
+
+bool isaSupported(Isa isa);
+
+const char* isaName(Isa isa);
+
+}
+
+#endif //CPU_H
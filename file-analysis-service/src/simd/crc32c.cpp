@@ -0,0 +1,59 @@
+#include "crc32c.h"
+#include <array>
+
+namespace simd {
+
+namespace {
+
+// Отражённый полином Castagnoli
+constexpr uint32_t kPolynomial = 0x82f63b78u;
+
+constexpr std::array<uint32_t, 256> buildTable() {
+    std::array<uint32_t, 256> table {};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (crc & 1 ? kPolynomial : 0);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> kTable = buildTable();
+
+uint32_t scalar(uint32_t state, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        state = (state >> 8) ^ kTable[(state ^ data[i]) & 0xff];
+    }
+    return state;
+}
+
+}
+
+namespace detail {
+
+#if !defined(ANALYSIS_SIMD_X86)
+uint32_t crc32cSse42(uint32_t state, const uint8_t* data, size_t size) {
+    return scalar(state, data, size);
+}
+#endif
+
+}
+
+uint32_t crc32c(uint32_t crc, const uint8_t* data, size_t size, Isa isa) {
+    uint32_t state = ~crc;
+    if (isa == Isa::Sse42 || isa == Isa::Avx2) {
+        state = detail::crc32cSse42(state, data, size);
+    } else {
+        state = scalar(state, data, size);
+    }
+    return ~state;
+}
+
+uint32_t crc32c(uint32_t crc, const uint8_t* data, size_t size) {
+    static const Isa isa = isaSupported(Isa::Sse42) ? Isa::Sse42 : Isa::Scalar;
+    return crc32c(crc, data, size, isa);
+}
+
+}
@@ -0,0 +1,26 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include "cpu.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// CRC-32C (Castagnoli) — контрольная сумма файлов снимков.
+// crc — значение для предыдущих данных (0 для начала), можно считать частями.
+uint32_t crc32c(uint32_t crc, const uint8_t* data, size_t size);
+
+// То же с явным выбором ядра (Scalar или Sse42)
+uint32_t crc32c(uint32_t crc, const uint8_t* data, size_t size, Isa isa);
+
+namespace detail {
+
+// Инструкция crc32 из SSE4.2 по 8 байт; работает с инвертированным состоянием
+uint32_t crc32cSse42(uint32_t state, const uint8_t* data, size_t size);
+
+}
+
+}
+
+#endif //CRC32C_H
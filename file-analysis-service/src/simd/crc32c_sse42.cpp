@@ -0,0 +1,27 @@
+#include "crc32c.h"
+#include <cstring>
+#include <nmmintrin.h>
+
+namespace simd {
+namespace detail {
+
+uint32_t crc32cSse42(uint32_t state, const uint8_t* data, size_t size) {
+    uint64_t crc = state;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u64(crc, word);
+        data += 8;
+        size -= 8;
+    }
+
+    auto crc32 = static_cast<uint32_t>(crc);
+    while (size > 0) {
+        crc32 = _mm_crc32_u8(crc32, *data++);
+        --size;
+    }
+    return crc32;
+}
+
+}
+}
@@ -0,0 +1,78 @@
+#include "rollinghash.h"
+
+namespace simd {
+
+namespace {
+
+// Хвост после векторного ядра: окна с first по конец, Хорнер для первого
+// и скользящее обновление для остальных
+void scalarTail(const uint32_t* tokens, size_t count, size_t k, uint32_t* out, size_t first) {
+    size_t windows = kgramCount(count, k);
+    if (first >= windows) {
+        return;
+    }
+
+    uint32_t highPower = 1;
+    for (size_t i = 1; i < k; ++i) {
+        highPower *= kRollingBase;
+    }
+
+    uint32_t h = 0;
+    for (size_t t = 0; t < k; ++t) {
+        h = h * kRollingBase + (tokens[first + t] + 1);
+    }
+    out[first] = h;
+
+    for (size_t i = first + 1; i < windows; ++i) {
+        h -= highPower * (tokens[i - 1] + 1);
+        h = h * kRollingBase + (tokens[i + k - 1] + 1);
+        out[i] = h;
+    }
+}
+
+}
+
+namespace detail {
+
+void kgramHashesScalar(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    scalarTail(tokens, count, k, out, 0);
+}
+
+#if !defined(ANALYSIS_SIMD_X86)
+size_t kgramHashesSse42(const uint32_t*, size_t, size_t, uint32_t*) {
+    return 0;
+}
+
+size_t kgramHashesAvx2(const uint32_t*, size_t, size_t, uint32_t*) {
+    return 0;
+}
+#endif
+
+}
+
+void kgramHashes(const uint32_t* tokens, size_t count, size_t k, uint32_t* out, Isa isa) {
+    if (kgramCount(count, k) == 0) {
+        return;
+    }
+
+    size_t done = 0;
+    switch (isa) {
+        case Isa::Avx2:
+            done = detail::kgramHashesAvx2(tokens, count, k, out);
+            break;
+        case Isa::Sse42:
+            done = detail::kgramHashesSse42(tokens, count, k, out);
+            break;
+        case Isa::Ssse3:
+        case Isa::Scalar:
+            break;
+    }
+
+    scalarTail(tokens, count, k, out, done);
+}
+
+void kgramHashes(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    kgramHashes(tokens, count, k, out, bestIsa());
+}
+
+}
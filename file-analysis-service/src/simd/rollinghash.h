@@ -0,0 +1,39 @@
+#ifndef ROLLINGHASH_H
+#define ROLLINGHASH_H
+
+#include "cpu.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Основание полиномиального хэша
+constexpr uint32_t kRollingBase = 16777619u;
+
+// Полиномиальные хэши всех k-грамм потока токенов (Рабин-Карп по модулю 2^32):
+//   out[i] = sum_{t<k} (tokens[i+t] + 1) * kRollingBase^(k-1-t)
+// out должен вмещать kgramCount(count, k) значений.
+// Результат не зависит от выбранного набора инструкций.
+void kgramHashes(const uint32_t* tokens, size_t count, size_t k, uint32_t* out);
+
+// То же с явным выбором ядра (для бенчмарков); Isa должен поддерживаться
+void kgramHashes(const uint32_t* tokens, size_t count, size_t k, uint32_t* out, Isa isa);
+
+inline size_t kgramCount(size_t count, size_t k) {
+  return k == 0 || count < k ? 0 : count - k + 1;
+}
+
+namespace detail {
+
+void kgramHashesScalar(const uint32_t* tokens, size_t count, size_t k, uint32_t* out);
+
+// Векторные ядра считают блоки по 4 (SSE4.2) и 8 (AVX2) окон
+// и возвращают число посчитанных окон; хвост досчитывает скалярный код
+size_t kgramHashesSse42(const uint32_t* tokens, size_t count, size_t k, uint32_t* out);
+size_t kgramHashesAvx2(const uint32_t* tokens, size_t count, size_t k, uint32_t* out);
+
+}
+
+}
+
+#endif //ROLLINGHASH_H
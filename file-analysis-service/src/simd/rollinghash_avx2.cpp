@@ -0,0 +1,122 @@
+#include "rollinghash.h"
+#include <immintrin.h>
+#include <vector>
+
+namespace simd {
+namespace detail {
+
+namespace {
+
+// До этой длины окна прямое вычисление быстрее префиксного сканирования
+constexpr size_t kDirectMaxK = 8;
+
+// Восемь соседних окон за раз: на шаге t все полосы читают tokens[i + lane + t]
+// одной невыровненной загрузкой и умножают на kRollingBase^(k-1-t).
+// Произведения независимы, поэтому цепочка зависимостей — только сложения.
+size_t directAvx2(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    size_t windows = kgramCount(count, k);
+    size_t blocks = windows / 8;
+
+    std::vector<uint32_t> powers(k);
+    uint32_t power = 1;
+    for (size_t t = k; t-- > 0;) {
+        powers[t] = power;
+        power *= kRollingBase;
+    }
+
+    const __m256i one = _mm256_set1_epi32(1);
+
+    for (size_t b = 0; b < blocks; ++b) {
+        const uint32_t* window = tokens + b * 8;
+        __m256i acc = _mm256_setzero_si256();
+
+        for (size_t t = 0; t < k; ++t) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(window + t));
+            __m256i p = _mm256_set1_epi32(static_cast<int>(powers[t]));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(_mm256_add_epi32(v, one), p));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + b * 8), acc);
+    }
+
+    return blocks * 8;
+}
+
+// Сдвиг на n полос к старшим с обнулением младших
+inline __m256i shiftLanes(__m256i v, __m256i index, __m256i mask) {
+    return _mm256_and_si256(_mm256_permutevar8x32_epi32(v, index), mask);
+}
+
+// Для длинных окон стоимость не зависит от k: считаем префиксные хэши
+//   prefix[n] = sum_{m<n} (tokens[m] + 1) * B^(n-1-m)
+// параллельным сканированием внутри блока из 8 токенов, а затем
+//   out[i] = prefix[i + k] - prefix[i] * B^k
+size_t prefixAvx2(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    size_t blocks = count / 8;
+    if (blocks * 8 < k + 8) {
+        return 0;
+    }
+
+    uint32_t powers[9];
+    powers[0] = 1;
+    for (size_t i = 1; i < 9; ++i) {
+        powers[i] = powers[i - 1] * kRollingBase;
+    }
+
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i b1 = _mm256_set1_epi32(static_cast<int>(powers[1]));
+    const __m256i b2 = _mm256_set1_epi32(static_cast<int>(powers[2]));
+    const __m256i b4 = _mm256_set1_epi32(static_cast<int>(powers[4]));
+    const __m256i lanePowers = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(powers + 1));
+    const __m256i idx1 = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+    const __m256i idx2 = _mm256_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5);
+    const __m256i idx4 = _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 2, 3);
+    const __m256i mask1 = _mm256_setr_epi32(0, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i mask2 = _mm256_setr_epi32(0, 0, -1, -1, -1, -1, -1, -1);
+    const __m256i mask4 = _mm256_setr_epi32(0, 0, 0, 0, -1, -1, -1, -1);
+    const __m256i lastLane = _mm256_set1_epi32(7);
+
+    std::vector<uint32_t> prefix(blocks * 8 + 1);
+    prefix[0] = 0;
+
+    // carry — prefix в начале блока, размноженный по всем полосам
+    __m256i carry = _mm256_setzero_si256();
+    for (size_t b = 0; b < blocks; ++b) {
+        __m256i s = _mm256_add_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tokens + b * 8)), one);
+        s = _mm256_add_epi32(s, _mm256_mullo_epi32(shiftLanes(s, idx1, mask1), b1));
+        s = _mm256_add_epi32(s, _mm256_mullo_epi32(shiftLanes(s, idx2, mask2), b2));
+        s = _mm256_add_epi32(s, _mm256_mullo_epi32(shiftLanes(s, idx4, mask4), b4));
+
+        __m256i p = _mm256_add_epi32(s, _mm256_mullo_epi32(carry, lanePowers));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(prefix.data() + b * 8 + 1), p);
+        carry = _mm256_permutevar8x32_epi32(p, lastLane);
+    }
+
+    uint32_t powerK = 1;
+    for (size_t i = 0; i < k; ++i) {
+        powerK *= kRollingBase;
+    }
+    const __m256i vPowerK = _mm256_set1_epi32(static_cast<int>(powerK));
+
+    // Окна, целиком покрытые префиксами
+    size_t windowBlocks = (blocks * 8 - k + 1) / 8;
+    for (size_t w = 0; w < windowBlocks; ++w) {
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prefix.data() + w * 8 + k));
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prefix.data() + w * 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w * 8),
+                            _mm256_sub_epi32(hi, _mm256_mullo_epi32(lo, vPowerK)));
+    }
+
+    return windowBlocks * 8;
+}
+
+}
+
+size_t kgramHashesAvx2(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    return k <= kDirectMaxK ? directAvx2(tokens, count, k, out)
+                            : prefixAvx2(tokens, count, k, out);
+}
+
+}
+}
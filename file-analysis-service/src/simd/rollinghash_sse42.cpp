@@ -0,0 +1,107 @@
+#include "rollinghash.h"
+#include <nmmintrin.h>
+#include <vector>
+
+namespace simd {
+namespace detail {
+
+namespace {
+
+// До этой длины окна прямое вычисление быстрее префиксного сканирования
+constexpr size_t kDirectMaxK = 3;
+
+// Четыре соседних окна за раз, та же схема, что и в прямом AVX2-ядре.
+// Стоимость растёт с k, поэтому годится только для самых коротких окон.
+size_t directSse42(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    size_t windows = kgramCount(count, k);
+    size_t blocks = windows / 4;
+
+    std::vector<uint32_t> powers(k);
+    uint32_t power = 1;
+    for (size_t t = k; t-- > 0;) {
+        powers[t] = power;
+        power *= kRollingBase;
+    }
+
+    const __m128i one = _mm_set1_epi32(1);
+
+    for (size_t b = 0; b < blocks; ++b) {
+        const uint32_t* window = tokens + b * 4;
+        __m128i acc = _mm_setzero_si128();
+
+        for (size_t t = 0; t < k; ++t) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + t));
+            __m128i p = _mm_set1_epi32(static_cast<int>(powers[t]));
+            acc = _mm_add_epi32(acc, _mm_mullo_epi32(_mm_add_epi32(v, one), p));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + b * 4), acc);
+    }
+
+    return blocks * 4;
+}
+
+// Префиксная схема, как в AVX2-ядре: сканирование внутри блока из 4 токенов,
+// затем out[i] = prefix[i + k] - prefix[i] * B^k. Перенос между блоками
+// считается в скалярном регистре (одно умножение на блок), поэтому
+// цепочка зависимостей не проходит через векторное умножение
+size_t prefixSse42(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    size_t blocks = count / 4;
+    if (blocks * 4 < k + 4) {
+        return 0;
+    }
+
+    uint32_t powers[5];
+    powers[0] = 1;
+    for (size_t i = 1; i < 5; ++i) {
+        powers[i] = powers[i - 1] * kRollingBase;
+    }
+
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i b1 = _mm_set1_epi32(static_cast<int>(powers[1]));
+    const __m128i b2 = _mm_set1_epi32(static_cast<int>(powers[2]));
+    const __m128i lanePowers = _mm_loadu_si128(reinterpret_cast<const __m128i*>(powers + 1));
+
+    std::vector<uint32_t> prefix(blocks * 4 + 1);
+    prefix[0] = 0;
+
+    uint32_t carry = 0;  // prefix в начале блока
+    for (size_t b = 0; b < blocks; ++b) {
+        __m128i s = _mm_add_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(tokens + b * 4)), one);
+        s = _mm_add_epi32(s, _mm_mullo_epi32(_mm_slli_si128(s, 4), b1));
+        s = _mm_add_epi32(s, _mm_mullo_epi32(_mm_slli_si128(s, 8), b2));
+
+        __m128i p = _mm_add_epi32(
+            s, _mm_mullo_epi32(_mm_set1_epi32(static_cast<int>(carry)), lanePowers));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(prefix.data() + b * 4 + 1), p);
+        carry = carry * powers[4] + static_cast<uint32_t>(_mm_extract_epi32(s, 3));
+    }
+
+    uint32_t powerK = 1;
+    for (size_t i = 0; i < k; ++i) {
+        powerK *= kRollingBase;
+    }
+    const __m128i vPowerK = _mm_set1_epi32(static_cast<int>(powerK));
+
+    // Окна, целиком покрытые префиксами
+    size_t windowBlocks = (blocks * 4 - k + 1) / 4;
+    for (size_t w = 0; w < windowBlocks; ++w) {
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prefix.data() + w * 4 + k));
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prefix.data() + w * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + w * 4),
+                         _mm_sub_epi32(hi, _mm_mullo_epi32(lo, vPowerK)));
+    }
+
+    return windowBlocks * 4;
+}
+
+}
+
+size_t kgramHashesSse42(const uint32_t* tokens, size_t count, size_t k, uint32_t* out) {
+    return k <= kDirectMaxK ? directSse42(tokens, count, k, out)
+                            : prefixSse42(tokens, count, k, out);
+}
+
+}
+}
@@ -0,0 +1,95 @@
+#include "streamvbyte.h"
+
+namespace simd {
+
+namespace {
+
+size_t byteLength(uint32_t value) {
+    if (value < (1u << 8)) {
+        return 1;
+    }
+    if (value < (1u << 16)) {
+        return 2;
+    }
+    if (value < (1u << 24)) {
+        return 3;
+    }
+    return 4;
+}
+
+// Скалярное декодирование значений с first по count
+size_t decodeTail(const uint8_t* control, const uint8_t* data, size_t first, size_t count,
+                  uint32_t previous, uint32_t* out) {
+    const uint8_t* start = data;
+    for (size_t i = first; i < count; ++i) {
+        size_t length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+
+        uint32_t delta = 0;
+        for (size_t b = 0; b < length; ++b) {
+            delta |= static_cast<uint32_t>(data[b]) << (8 * b);
+        }
+        data += length;
+
+        previous += delta;
+        out[i] = previous;
+    }
+    return static_cast<size_t>(data - start);
+}
+
+}
+
+namespace detail {
+
+#if !defined(ANALYSIS_SIMD_X86)
+size_t streamVByteDecodeDeltaSsse3(const uint8_t*, const uint8_t*&, size_t, uint32_t, uint32_t*) {
+    return 0;
+}
+#endif
+
+}
+
+size_t streamVByteEncodeDelta(const uint32_t* in, size_t count, uint32_t base, uint8_t* out) {
+    size_t controlBytes = (count + 3) / 4;
+    uint8_t* control = out;
+    uint8_t* data = out + controlBytes;
+
+    for (size_t i = 0; i < controlBytes; ++i) {
+        control[i] = 0;
+    }
+
+    uint32_t previous = base;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t delta = in[i] - previous;
+        previous = in[i];
+
+        size_t length = byteLength(delta);
+        control[i / 4] |= static_cast<uint8_t>((length - 1) << (2 * (i % 4)));
+        for (size_t b = 0; b < length; ++b) {
+            *data++ = static_cast<uint8_t>(delta >> (8 * b));
+        }
+    }
+
+    return static_cast<size_t>(data - out);
+}
+
+size_t streamVByteDecodeDelta(const uint8_t* in, size_t count, uint32_t base, uint32_t* out, Isa isa) {
+    const uint8_t* control = in;
+    const uint8_t* data = in + (count + 3) / 4;
+
+    size_t done = 0;
+    if (isa != Isa::Scalar) {
+        done = detail::streamVByteDecodeDeltaSsse3(control, data, count, base, out);
+    }
+
+    uint32_t previous = done > 0 ? out[done - 1] : base;
+    data += decodeTail(control, data, done, count, previous, out);
+    return static_cast<size_t>(data - in);
+}
+
+size_t streamVByteDecodeDelta(const uint8_t* in, size_t count, uint32_t base, uint32_t* out) {
+    // SSSE3 есть везде, где есть SSE4.2 и AVX2
+    static const Isa isa = isaSupported(Isa::Ssse3) ? Isa::Ssse3 : Isa::Scalar;
+    return streamVByteDecodeDelta(in, count, base, out, isa);
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef STREAMVBYTE_H
+#define STREAMVBYTE_H
+
+#include "cpu.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// StreamVByte (Lemire, Kurz, Rupp, 2017) для возрастающих последовательностей.
+// Кодируются разности с предыдущим значением (первое — с base).
+// Длины (1..4 байта, по 2 бита на число) лежат отдельно от данных:
+// сначала (count + 3) / 4 управляющих байтов, затем байты чисел.
+// Поэтому четыре числа декодируются одной перестановкой байтов (pshufb).
+
+// Сколько байт декодер может прочитать за концом кода — столько
+// должно быть доступно после буфера
+constexpr size_t kStreamVByteOverread = 16;
+
+// Верхняя граница размера кода count значений
+inline size_t streamVByteMaxBytes(size_t count) {
+  return (count + 3) / 4 + count * 4;
+}
+
+// Возвращает число записанных байт
+size_t streamVByteEncodeDelta(const uint32_t* in, size_t count, uint32_t base, uint8_t* out);
+
+// Возвращает число прочитанных байт
+size_t streamVByteDecodeDelta(const uint8_t* in, size_t count, uint32_t base, uint32_t* out);
+
+// То же с явным выбором ядра (для бенчмарков); Isa должен поддерживаться
+size_t streamVByteDecodeDelta(const uint8_t* in, size_t count, uint32_t base, uint32_t* out, Isa isa);
+
+namespace detail {
+
+// SSSE3-ядро декодирует полные четвёрки: возвращает их число в значениях,
+// data сдвигается за прочитанные байты
+size_t streamVByteDecodeDeltaSsse3(const uint8_t* control, const uint8_t*& data, size_t count,
+                                   uint32_t base, uint32_t* out);
+
+}
+
+}
+
+#endif //STREAMVBYTE_H
@@ -0,0 +1,63 @@
+#include "streamvbyte.h"
+#include <array>
+#include <tmmintrin.h>
+
+namespace simd {
+namespace detail {
+
+namespace {
+
+struct ShuffleTables {
+    std::array<std::array<uint8_t, 16>, 256> masks{};
+    std::array<uint8_t, 256> lengths{};
+};
+
+// Для каждого управляющего байта: какие байты данных разложить по четырём
+// 32-битным полосам (0x80 — обнулить) и сколько байт данных он занимает
+constexpr ShuffleTables buildTables() {
+    ShuffleTables tables;
+    for (size_t control = 0; control < 256; ++control) {
+        uint8_t offset = 0;
+        for (size_t lane = 0; lane < 4; ++lane) {
+            size_t length = ((control >> (2 * lane)) & 3) + 1;
+            for (size_t b = 0; b < 4; ++b) {
+                tables.masks[control][lane * 4 + b] =
+                    b < length ? static_cast<uint8_t>(offset + b) : 0x80;
+            }
+            offset = static_cast<uint8_t>(offset + length);
+        }
+        tables.lengths[control] = offset;
+    }
+    return tables;
+}
+
+constexpr ShuffleTables kTables = buildTables();
+
+}
+
+size_t streamVByteDecodeDeltaSsse3(const uint8_t* control, const uint8_t*& data, size_t count,
+                                   uint32_t base, uint32_t* out) {
+    size_t quads = count / 4;
+    __m128i previous = _mm_set1_epi32(static_cast<int>(base));
+
+    for (size_t q = 0; q < quads; ++q) {
+        uint8_t c = control[q];
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTables.masks[c].data()));
+        __m128i deltas = _mm_shuffle_epi8(bytes, mask);
+        data += kTables.lengths[c];
+
+        // Префиксная сумма разностей внутри четвёрки плюс последнее значение
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+        __m128i values = _mm_add_epi32(deltas, previous);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + q * 4), values);
+        previous = _mm_shuffle_epi32(values, 0xff);
+    }
+
+    return quads * 4;
+}
+
+}
+}
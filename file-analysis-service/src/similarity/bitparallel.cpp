@@ -0,0 +1,190 @@
+#include "bitparallel.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace similarity {
+
+namespace {
+
+constexpr size_t kWordBits = 64;
+
+// Таблица совпадений образца: для каждого различного токена — битовая маска
+// его позиций, по words слов на токен. Токены текста заранее переводятся
+// в номера строк таблицы; токены, которых нет в образце, получают нулевую строку.
+struct PatternMasks {
+    size_t words = 0;
+    std::vector<uint64_t> masks;
+    std::vector<uint32_t> textRows;
+
+    const uint64_t* row(size_t j) const {
+        return masks.data() + static_cast<size_t>(textRows[j]) * words;
+    }
+};
+
+PatternMasks buildMasks(const std::vector<uint32_t>& pattern, const std::vector<uint32_t>& text) {
+    PatternMasks result;
+    result.words = (pattern.size() + kWordBits - 1) / kWordBits;
+
+    std::unordered_map<uint32_t, uint32_t> rows;
+    rows.reserve(pattern.size());
+    for (uint32_t token : pattern) {
+        rows.emplace(token, static_cast<uint32_t>(rows.size()));
+    }
+
+    // Последняя строка — нулевая, для токенов вне образца
+    uint32_t missingRow = static_cast<uint32_t>(rows.size());
+    result.masks.assign((rows.size() + 1) * result.words, 0);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        uint64_t* row = result.masks.data() + static_cast<size_t>(rows[pattern[i]]) * result.words;
+        row[i / kWordBits] |= 1ULL << (i % kWordBits);
+    }
+
+    result.textRows.reserve(text.size());
+    for (uint32_t token : text) {
+        auto it = rows.find(token);
+        result.textRows.push_back(it == rows.end() ? missingRow : it->second);
+    }
+
+    return result;
+}
+
+size_t popcount(uint64_t x) {
+    return static_cast<size_t>(__builtin_popcountll(x));
+}
+
+// Шаг Myers для одного блока из 64 строк. hin — горизонтальная разность
+// над блоком (-1, 0, +1), возвращается разность на строке outBit.
+// Перенос между блоками передаётся через hin, поэтому сложение без переноса.
+int myersBlock(uint64_t& pv, uint64_t& mv, uint64_t eq, int hin, uint64_t outBit) {
+    uint64_t xv = eq | mv;
+    if (hin < 0) {
+        eq |= 1;
+    }
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+
+    int hout = 0;
+    if (ph & outBit) {
+        hout = 1;
+    } else if (mh & outBit) {
+        hout = -1;
+    }
+
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0) {
+        mh |= 1;
+    } else if (hin > 0) {
+        ph |= 1;
+    }
+
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+
+}
+
+size_t BitParallel::lcsLength(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    const auto& pattern = a.size() <= b.size() ? a : b;
+    const auto& text = a.size() <= b.size() ? b : a;
+    if (pattern.empty()) {
+        return 0;
+    }
+
+    PatternMasks masks = buildMasks(pattern, text);
+    size_t words = masks.words;
+
+    // Нулевые биты V отмечают строки, где LCS растёт:
+    //   U = V & M[c];  V' = (V + U) | (V - U)
+    // Сложение многословное, с переносом между словами.
+    std::vector<uint64_t> v(words, ~0ULL);
+
+    for (size_t j = 0; j < text.size(); ++j) {
+        const uint64_t* eq = masks.row(j);
+        uint64_t carry = 0;
+
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t u = v[w] & eq[w];
+            uint64_t sum = v[w] + u;
+            uint64_t nextCarry = sum < v[w];
+            sum += carry;
+            nextCarry |= sum < carry;
+            v[w] = sum | (v[w] - u);
+            carry = nextCarry;
+        }
+    }
+
+    // Биты за пределами образца в последнем слове не считаются
+    size_t zeros = 0;
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t valid = ~0ULL;
+        size_t rest = pattern.size() - w * kWordBits;
+        if (rest < kWordBits) {
+            valid = (1ULL << rest) - 1;
+        }
+        zeros += popcount(~v[w] & valid);
+    }
+    return zeros;
+}
+
+size_t BitParallel::editDistance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    const auto& pattern = a.size() <= b.size() ? a : b;
+    const auto& text = a.size() <= b.size() ? b : a;
+    if (pattern.empty()) {
+        return text.size();
+    }
+
+    PatternMasks masks = buildMasks(pattern, text);
+    size_t words = masks.words;
+
+    // Ответ читается со строки m, а не со старшего бита последнего блока:
+    // лишние биты выше неё на младшие не влияют
+    const uint64_t highBit = 1ULL << (kWordBits - 1);
+    const uint64_t lastBit = 1ULL << ((pattern.size() - 1) % kWordBits);
+
+    // D[i][0] = i: все вертикальные разности +1
+    std::vector<uint64_t> pv(words, ~0ULL);
+    std::vector<uint64_t> mv(words, 0);
+    size_t score = pattern.size();
+
+    if (words == 1) {
+        uint64_t p = pv[0];
+        uint64_t m = mv[0];
+        for (size_t j = 0; j < text.size(); ++j) {
+            score += myersBlock(p, m, masks.row(j)[0], 1, lastBit);
+        }
+        return score;
+    }
+
+    for (size_t j = 0; j < text.size(); ++j) {
+        const uint64_t* eq = masks.row(j);
+
+        // D[0][j] = j: над первым блоком разность +1
+        int h = 1;
+        for (size_t w = 0; w + 1 < words; ++w) {
+            h = myersBlock(pv[w], mv[w], eq[w], h, highBit);
+        }
+        score += myersBlock(pv[words - 1], mv[words - 1], eq[words - 1], h, lastBit);
+    }
+
+    return score;
+}
+
+double BitParallel::lcsSimilarity(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    if (a.empty() && b.empty()) {
+        return 0.0;
+    }
+    return 2.0 * static_cast<double>(lcsLength(a, b)) / static_cast<double>(a.size() + b.size());
+}
+
+double BitParallel::editSimilarity(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    size_t longest = std::max(a.size(), b.size());
+    if (longest == 0) {
+        return 0.0;
+    }
+    return 1.0 - static_cast<double>(editDistance(a, b)) / static_cast<double>(longest);
+}
+
+}
@@ -0,0 +1,32 @@
+#ifndef BITPARALLEL_H
+#define BITPARALLEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace similarity {
+
+// Битово-параллельные LCS и расстояние Левенштейна по потокам токенов.
+// Столбец матрицы ДП хранится как битовые векторы разностей соседних
+// клеток, поэтому один токен текста обрабатывается за O(m / 64) машинных
+// слов вместо O(m) клеток. Более короткая последовательность берётся
+// в качестве образца; длинная разбивается на блоки по 64 токена.
+class BitParallel {
+public:
+  // Длина наибольшей общей подпоследовательности (Hyyrö, 2004)
+  static size_t lcsLength(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+  // Расстояние Левенштейна (Myers, 1999; блочный вариант Hyyrö, 2003)
+  static size_t editDistance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+  // 2 * LCS / (|a| + |b|), в той же шкале, что и покрытие GST
+  static double lcsSimilarity(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+  // 1 - d / max(|a|, |b|)
+  static double editSimilarity(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+};
+
+}
+
+#endif //BITPARALLEL_H
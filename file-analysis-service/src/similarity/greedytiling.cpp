@@ -0,0 +1,210 @@
+#include "greedytiling.h"
+#include "suffixarray.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <queue>
+
+namespace similarity {
+
+namespace {
+
+constexpr uint64_t kSeparator = uint64_t{1} << 32;
+
+struct MatchCandidate {
+  size_t length;
+  size_t first;
+  size_t second;
+
+  bool operator<(const MatchCandidate& other) const {
+      if (length != other.length) {
+          return length < other.length;
+      }
+      // При равной длине раньше идёт более левый тайл — как в классическом GST
+      if (first != other.first) {
+          return first > other.first;
+      }
+      return second > other.second;
+  }
+};
+
+// Положенные тайлы одной последовательности: начало -> конец.
+// Тайлы не пересекаются, поэтому первый покрытый индекс ищется за O(log n).
+class TileSet {
+public:
+  // Первая покрытая позиция >= pos и конец покрывающего её тайла
+  std::pair<size_t, size_t> firstCovered(size_t pos) const {
+      auto it = tiles_.upper_bound(pos);
+      if (it != tiles_.begin()) {
+          auto prev = std::prev(it);
+          if (prev->second > pos) {
+              return {pos, prev->second};
+          }
+      }
+      if (it == tiles_.end()) {
+          return {std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max()};
+      }
+      return {it->first, it->second};
+  }
+
+  void add(size_t start, size_t length) {
+      tiles_.emplace(start, start + length);
+  }
+
+private:
+  std::map<size_t, size_t> tiles_;
+};
+
+// Для каждой позиции одной стороны — самое длинное совпадение с другой стороной.
+// Ближайший суффикс другой стороны в суффиксном массиве даёт максимум LCP.
+void bestPartners(const SuffixArray& sa, size_t sizeA, bool fromA,
+                  std::vector<size_t>& length, std::vector<size_t>& partner) {
+    const auto& suffixes = sa.suffixes();
+    const auto& lcp = sa.lcp();
+    const size_t n = suffixes.size();
+
+    auto isSource = [&](size_t pos) { return fromA ? pos < sizeA : pos > sizeA; };
+    auto isTarget = [&](size_t pos) { return fromA ? pos > sizeA : pos < sizeA; };
+
+    // Проход сверху вниз: ближайший предыдущий суффикс другой стороны
+    size_t runMin = 0;
+    size_t last = std::numeric_limits<size_t>::max();
+    for (size_t r = 0; r < n; ++r) {
+        if (r > 0) {
+            runMin = std::min(runMin, lcp[r]);
+        }
+        size_t pos = suffixes[r];
+        if (isTarget(pos)) {
+            last = pos;
+            runMin = std::numeric_limits<size_t>::max();
+        } else if (isSource(pos) && last != std::numeric_limits<size_t>::max()) {
+            size_t idx = fromA ? pos : pos - sizeA - 1;
+            if (runMin > length[idx]) {
+                length[idx] = runMin;
+                partner[idx] = last;
+            }
+        }
+    }
+
+    // Проход снизу вверх: ближайший следующий суффикс другой стороны
+    runMin = 0;
+    last = std::numeric_limits<size_t>::max();
+    for (size_t r = n; r-- > 0;) {
+        if (r + 1 < n) {
+            runMin = std::min(runMin, lcp[r + 1]);
+        }
+        size_t pos = suffixes[r];
+        if (isTarget(pos)) {
+            last = pos;
+            runMin = std::numeric_limits<size_t>::max();
+        } else if (isSource(pos) && last != std::numeric_limits<size_t>::max()) {
+            size_t idx = fromA ? pos : pos - sizeA - 1;
+            if (runMin > length[idx]) {
+                length[idx] = runMin;
+                partner[idx] = last;
+            }
+        }
+    }
+}
+
+}
+
+GreedyStringTiling::GreedyStringTiling(size_t minMatchLength)
+    : minMatchLength_(std::max<size_t>(minMatchLength, 1))
+{}
+
+TilingResult GreedyStringTiling::compare(const std::vector<uint32_t>& a,
+                                         const std::vector<uint32_t>& b) const {
+    TilingResult result;
+    if (a.empty() || b.empty()) {
+        return result;
+    }
+
+    // a + разделитель + b. Токен может быть любым 32-битным числом (слова
+    // текста — хэши), поэтому разделитель берётся за пределами uint32_t:
+    // общий префикс никогда через него не переходит
+    std::vector<uint64_t> text;
+    text.reserve(a.size() + b.size() + 1);
+    text.insert(text.end(), a.begin(), a.end());
+    text.push_back(kSeparator);
+    text.insert(text.end(), b.begin(), b.end());
+
+    SuffixArray sa(text);
+    const size_t offsetB = a.size() + 1;
+
+    std::vector<size_t> lengthA(a.size(), 0), partnerA(a.size(), 0);
+    std::vector<size_t> lengthB(b.size(), 0), partnerB(b.size(), 0);
+    bestPartners(sa, a.size(), true, lengthA, partnerA);
+    bestPartners(sa, a.size(), false, lengthB, partnerB);
+
+    // Кандидаты только с левых концов диагоналей: совпадение (i, j, len)
+    // не добавляем, если его покрывает (i-1, j-1, len+1)
+    std::priority_queue<MatchCandidate> queue;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (lengthA[i] < minMatchLength_) {
+            continue;
+        }
+        size_t j = partnerA[i] - offsetB;
+        if (i > 0 && lengthA[i - 1] == lengthA[i] + 1 && partnerA[i - 1] + 1 == partnerA[i]) {
+            continue;
+        }
+        queue.push({lengthA[i], i, j});
+    }
+    for (size_t j = 0; j < b.size(); ++j) {
+        if (lengthB[j] < minMatchLength_) {
+            continue;
+        }
+        size_t i = partnerB[j];
+        if (j > 0 && lengthB[j - 1] == lengthB[j] + 1 && partnerB[j - 1] + 1 == partnerB[j]) {
+            continue;
+        }
+        queue.push({lengthB[j], i, j});
+    }
+
+    TileSet tilesA, tilesB;
+
+    while (!queue.empty()) {
+        MatchCandidate m = queue.top();
+        queue.pop();
+
+        // Длина свободного префикса совпадения в обеих последовательностях
+        auto [blockA, endA] = tilesA.firstCovered(m.first);
+        auto [blockB, endB] = tilesB.firstCovered(m.second);
+        size_t freePrefix = std::min({m.length, blockA - m.first, blockB - m.second});
+
+        if (freePrefix == m.length) {
+            tilesA.add(m.first, m.length);
+            tilesB.add(m.second, m.length);
+            result.tiles.push_back({m.first, m.second, m.length});
+            result.coveredTokens += m.length;
+            continue;
+        }
+
+        // Совпадение задето тайлом: свободный префикс и остаток за
+        // мешающим тайлом возвращаются в очередь (остаток режется лениво)
+        if (freePrefix >= minMatchLength_) {
+            queue.push({freePrefix, m.first, m.second});
+        }
+
+        size_t skip = freePrefix + 1;
+        if (blockA - m.first == freePrefix) {
+            skip = std::max(skip, endA - m.first);
+        }
+        if (blockB - m.second == freePrefix) {
+            skip = std::max(skip, endB - m.second);
+        }
+        if (skip < m.length && m.length - skip >= minMatchLength_) {
+            queue.push({m.length - skip, m.first + skip, m.second + skip});
+        }
+    }
+
+    std::sort(result.tiles.begin(), result.tiles.end(),
+              [](const Tile& x, const Tile& y) { return x.first < y.first; });
+
+    result.similarity = 2.0 * static_cast<double>(result.coveredTokens) /
+                        static_cast<double>(a.size() + b.size());
+    return result;
+}
+
+}
@@ -0,0 +1,43 @@
+#ifndef GREEDYTILING_H
+#define GREEDYTILING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace similarity {
+
+// Совпавший участок: length токенов с позиции first в первой
+// последовательности и с позиции second во второй
+struct Tile {
+  size_t first;
+  size_t second;
+  size_t length;
+};
+
+struct TilingResult {
+  std::vector<Tile> tiles;
+  size_t coveredTokens = 0;
+  // 2 * покрытие / (|a| + |b|), как в JPlag
+  double similarity = 0.0;
+};
+
+// Greedy String Tiling (Wise; JPlag) с ускорением через суффиксный массив.
+// Для каждой позиции обеих последовательностей самое длинное совпадение
+// берётся из соседей в суффиксном массиве конкатенации, после чего тайлы
+// кладутся жадно от длинных к коротким через очередь с приоритетом.
+// Совпадение, задетое уже положенным тайлом, лениво режется на непокрытые
+// куски, и они возвращаются в очередь. Итого около O(n log n) вместо O(n^3).
+class GreedyStringTiling {
+public:
+  explicit GreedyStringTiling(size_t minMatchLength = 8);
+
+  TilingResult compare(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) const;
+
+private:
+  size_t minMatchLength_;
+};
+
+}
+
+#endif //GREEDYTILING_H
@@ -0,0 +1,74 @@
+#include "lzcompressor.h"
+#include <cstring>
+#include <vector>
+
+namespace similarity {
+
+namespace {
+
+constexpr size_t kHashBits = 14;
+constexpr size_t kMinMatch = 4;
+// Последние литералы LZ4 всегда пишет как есть
+constexpr size_t kLastLiterals = 5;
+
+uint32_t load32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// Байты продолжения длины: значение 15 в токене, затем по 255
+size_t lengthBytes(size_t length) {
+    return length < 15 ? 0 : 1 + (length - 15) / 255;
+}
+
+}
+
+size_t LzCompressor::compressedSize(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 1;
+    }
+
+    // Позиции + 1: ноль — пустая ячейка
+    std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+
+    size_t out = 0;
+    size_t anchor = 0;
+    size_t ip = 0;
+    size_t limit = size > kLastLiterals + kMinMatch ? size - kLastLiterals - kMinMatch : 0;
+
+    while (ip < limit) {
+        uint32_t sequence = load32(data + ip);
+        uint32_t& slot = table[hashSequence(sequence)];
+        size_t candidate = slot;
+        slot = static_cast<uint32_t>(ip + 1);
+
+        if (candidate == 0 || ip + 1 - candidate > kWindow || load32(data + candidate - 1) != sequence) {
+            // Ускорение LZ4: чем дольше нет совпадений, тем длиннее шаг
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+
+        size_t match = candidate - 1;
+        size_t length = kMinMatch;
+        size_t end = size - kLastLiterals;
+        while (ip + length < end && data[match + length] == data[ip + length]) {
+            ++length;
+        }
+
+        size_t literals = ip - anchor;
+        out += 1 + lengthBytes(literals) + literals + 2 + lengthBytes(length - kMinMatch);
+
+        ip += length;
+        anchor = ip;
+    }
+
+    size_t literals = size - anchor;
+    return out + 1 + lengthBytes(literals) + literals;
+}
+
+}
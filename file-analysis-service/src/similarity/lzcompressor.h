@@ -0,0 +1,29 @@
+#ifndef LZCOMPRESSOR_H
+#define LZCOMPRESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace similarity {
+
+// Быстрый LZ77 в духе LZ4: жадный поиск совпадений через хэш-таблицу
+// 4-байтных последовательностей, окно 64 КиБ, на несжимаемых данных шаг
+// поиска растёт. Для NCD нужна только длина результата, поэтому считается
+// размер блока в формате LZ4 (токен, длины, литералы, смещение), а сами
+// байты не пишутся.
+class LzCompressor {
+public:
+  // Максимальное смещение совпадения
+  static constexpr size_t kWindow = 65535;
+
+  static size_t compressedSize(const uint8_t* data, size_t size);
+
+  static size_t compressedSize(const std::string& data) {
+    return compressedSize(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  }
+};
+
+}
+
+#endif //LZCOMPRESSOR_H
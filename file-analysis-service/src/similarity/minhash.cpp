@@ -0,0 +1,70 @@
+#include "minhash.h"
+#include <limits>
+
+namespace similarity {
+
+namespace {
+
+// splitmix64 — детерминированный генератор коэффициентов перестановок
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+}
+
+MinHash::MinHash(size_t numPermutations, uint64_t seed) {
+    multipliers_.reserve(numPermutations);
+    offsets_.reserve(numPermutations);
+
+    uint64_t state = seed;
+    for (size_t i = 0; i < numPermutations; ++i) {
+        multipliers_.push_back(splitmix64(state) | 1);
+        offsets_.push_back(splitmix64(state));
+    }
+}
+
+std::vector<uint32_t> MinHash::signature(const std::vector<uint64_t>& shingles) const {
+    std::vector<uint32_t> result;
+    if (shingles.empty()) {
+        return result;
+    }
+
+    result.assign(multipliers_.size(), std::numeric_limits<uint32_t>::max());
+
+    // Внешний цикл по перестановкам: коэффициенты остаются в регистрах
+    for (size_t p = 0; p < multipliers_.size(); ++p) {
+        uint64_t a = multipliers_[p];
+        uint64_t b = offsets_[p];
+        uint32_t minValue = std::numeric_limits<uint32_t>::max();
+
+        for (uint64_t x : shingles) {
+            uint32_t h = static_cast<uint32_t>((a * x + b) >> 32);
+            if (h < minValue) {
+                minValue = h;
+            }
+        }
+        result[p] = minValue;
+    }
+
+    return result;
+}
+
+double MinHash::estimateJaccard(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    if (a.empty() || a.size() != b.size()) {
+        return 0.0;
+    }
+
+    size_t equal = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == b[i]) {
+            ++equal;
+        }
+    }
+
+    return static_cast<double>(equal) / static_cast<double>(a.size());
+}
+
+}
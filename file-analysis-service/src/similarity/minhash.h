@@ -0,0 +1,32 @@
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace similarity {
+
+// MinHash-сигнатура множества отпечатков (Broder).
+// Доля совпадающих позиций двух сигнатур — оценка коэффициента Жаккара.
+class MinHash {
+public:
+  explicit MinHash(size_t numPermutations = 128, uint64_t seed = 0x5eed5eed5eed5eedULL);
+
+  // Сигнатура множества; для пустого множества — пустой вектор
+  std::vector<uint32_t> signature(const std::vector<uint64_t>& shingles) const;
+
+  // Оценка коэффициента Жаккара по двум сигнатурам одинаковой длины
+  static double estimateJaccard(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+  size_t numPermutations() const { return multipliers_.size(); }
+
+private:
+  // Перестановки вида h(x) = (a * x + b) >> 32 с нечётным a
+  std::vector<uint64_t> multipliers_;
+  std::vector<uint64_t> offsets_;
+};
+
+}
+
+#endif //MINHASH_H
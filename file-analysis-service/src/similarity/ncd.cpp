@@ -0,0 +1,64 @@
+#include "ncd.h"
+#include "lzcompressor.h"
+#include <algorithm>
+
+namespace similarity {
+
+CompressionDistance::CompressionDistance(size_t sampleBytes)
+    : sampleBytes_(sampleBytes)
+{}
+
+std::string CompressionDistance::encode(const std::vector<uint32_t>& tokens) const {
+    std::string encoded;
+    encoded.reserve(sampleBytes_ > 0 ? std::min(sampleBytes_, tokens.size() * 2) : tokens.size() * 2);
+
+    for (uint32_t token : tokens) {
+        char bytes[5];
+        size_t length = 0;
+        while (token >= 0x80) {
+            bytes[length++] = static_cast<char>((token & 0x7f) | 0x80);
+            token >>= 7;
+        }
+        bytes[length++] = static_cast<char>(token);
+
+        // Префикс режется по границе токена
+        if (sampleBytes_ > 0 && encoded.size() + length > sampleBytes_) {
+            break;
+        }
+        encoded.append(bytes, length);
+    }
+
+    return encoded;
+}
+
+size_t CompressionDistance::compressedSize(const std::string& encoded) const {
+    return LzCompressor::compressedSize(encoded);
+}
+
+double CompressionDistance::similarity(const std::string& x, size_t compressedX,
+                                       const std::string& y, size_t compressedY) const {
+    if (x.empty() || y.empty()) {
+        return 0.0;
+    }
+
+    std::string xy;
+    xy.reserve(x.size() + y.size());
+    xy.append(x).append(y);
+    size_t compressedXY = LzCompressor::compressedSize(xy);
+
+    size_t low = std::min(compressedX, compressedY);
+    size_t high = std::max(compressedX, compressedY);
+    double distance = compressedXY > low
+                          ? static_cast<double>(compressedXY - low) / static_cast<double>(high)
+                          : 0.0;
+    return std::clamp(1.0 - distance, 0.0, 1.0);
+}
+
+double CompressionDistance::similarity(const std::vector<uint32_t>& a,
+                                       const std::vector<uint32_t>& b) const {
+    std::string x = encode(a);
+    std::string y = encode(b);
+    return similarity(x, compressedSize(x), y, compressedSize(y));
+}
+
+}
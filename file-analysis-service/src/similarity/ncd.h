@@ -0,0 +1,46 @@
+#ifndef NCD_H
+#define NCD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace similarity {
+
+// Normalized Compression Distance (Cilibrasi, Vitányi):
+//   NCD(x, y) = (C(xy) - min(C(x), C(y))) / max(C(x), C(y)),
+// C — размер после LzCompressor. Компрессор находит повторы в любом
+// порядке, поэтому переставленные блоки почти не снижают сходство.
+// Сжимаются нормализованные потоки токенов (varint), так что
+// переименования тоже не мешают.
+//
+// C(x) каждой работы можно посчитать один раз: сравнение пары с известными
+// C(x) и C(y) стоит одного сжатия конкатенации.
+class CompressionDistance {
+public:
+  // sampleBytes — сколько байт потока сжимается (префикс), 0 — весь поток.
+  // Ограничение даёт время сравнения независимо от размера работы;
+  // совпадения находятся, пока x и y вместе не длиннее окна (64 КиБ).
+  explicit CompressionDistance(size_t sampleBytes = 32768);
+
+  // Поток токенов в байтах, обрезанный до sampleBytes
+  std::string encode(const std::vector<uint32_t>& tokens) const;
+
+  size_t compressedSize(const std::string& encoded) const;
+
+  // 1 - NCD в [0, 1] по закодированным потокам и их сжатым размерам
+  double similarity(const std::string& x, size_t compressedX,
+                    const std::string& y, size_t compressedY) const;
+
+  double similarity(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) const;
+
+  size_t sampleBytes() const { return sampleBytes_; }
+
+private:
+  size_t sampleBytes_;
+};
+
+}
+
+#endif //NCD_H
@@ -0,0 +1,91 @@
+#include "pairwise.h"
+#include <algorithm>
+
+namespace similarity {
+
+PairwiseSimilarity::PairwiseSimilarity(concurrency::ThreadPool& pool, size_t stripSize)
+    : pool_(pool)
+    , stripSize_(std::max<size_t>(stripSize, 1))
+{}
+
+std::vector<PairScore> PairwiseSimilarity::compute(const std::vector<std::vector<uint32_t>>& sets,
+                                                   double minSimilarity) const {
+    size_t n = sets.size();
+
+    uint32_t universe = 0;
+    for (const auto& set : sets) {
+        if (!set.empty()) {
+            universe = std::max(universe, set.back() + 1);
+        }
+    }
+
+    // CSR: offsets[f]..offsets[f+1] — работы с отпечатком f по возрастанию
+    std::vector<uint32_t> offsets(static_cast<size_t>(universe) + 1, 0);
+    for (const auto& set : sets) {
+        for (uint32_t f : set) {
+            ++offsets[f + 1];
+        }
+    }
+    for (size_t f = 0; f < universe; ++f) {
+        offsets[f + 1] += offsets[f];
+    }
+
+    std::vector<uint32_t> postings(offsets[universe]);
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            for (uint32_t f : sets[i]) {
+                postings[cursor[f]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    size_t strips = (n + stripSize_ - 1) / stripSize_;
+
+    // Каждая полоса пишет только в свой слот — без блокировок
+    std::vector<std::vector<PairScore>> stripResults(strips);
+
+    pool_.parallelFor(strips, [&](size_t s) {
+        size_t rowBegin = s * stripSize_;
+        size_t rowEnd = std::min(rowBegin + stripSize_, n);
+
+        std::vector<uint32_t> counts(n, 0);
+        std::vector<uint32_t> touched;
+        auto& out = stripResults[s];
+
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            const auto& a = sets[i];
+            for (uint32_t f : a) {
+                const uint32_t* begin = postings.data() + offsets[f];
+                const uint32_t* end = postings.data() + offsets[f + 1];
+                // Только j > i: верхний треугольник
+                for (const uint32_t* p = std::upper_bound(begin, end, static_cast<uint32_t>(i)); p != end; ++p) {
+                    if (counts[*p]++ == 0) {
+                        touched.push_back(*p);
+                    }
+                }
+            }
+
+            std::sort(touched.begin(), touched.end());
+            for (uint32_t j : touched) {
+                size_t shared = counts[j];
+                counts[j] = 0;
+
+                double similarity = 2.0 * static_cast<double>(shared) /
+                                    static_cast<double>(a.size() + sets[j].size());
+                if (similarity >= minSimilarity) {
+                    out.push_back({i, j, shared, similarity});
+                }
+            }
+            touched.clear();
+        }
+    });
+
+    std::vector<PairScore> result;
+    for (auto& part : stripResults) {
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    return result;
+}
+
+}
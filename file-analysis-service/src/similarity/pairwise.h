@@ -0,0 +1,43 @@
+#ifndef PAIRWISE_H
+#define PAIRWISE_H
+
+#include "../concurrency/threadpool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace similarity {
+
+// Пара работ с общими отпечатками (индексы во входном массиве, first < second)
+struct PairScore {
+  size_t first;
+  size_t second;
+  size_t sharedFingerprints;
+  // 2 * |A ∩ B| / (|A| + |B|), в той же шкале, что GST и LCS
+  double similarity;
+};
+
+// Попарное сходство всех работ задания по множествам отпечатков.
+// Строится плотный инвертированный индекс (CSR: отпечаток -> работы по
+// возрастанию), и каждая полоса из stripSize строк матрицы — отдельная
+// задача пула: для строки i пересечения со всеми j > i накапливаются
+// в счётчиках, которые помещаются в L1. Работа пропорциональна
+// сумме квадратов длин списков, а не n^2 * |множество|.
+class PairwiseSimilarity {
+public:
+  explicit PairwiseSimilarity(concurrency::ThreadPool& pool, size_t stripSize = 16);
+
+  // sets — отсортированные множества плотных номеров отпечатков (0..U-1).
+  // Возвращаются пары со сходством не меньше minSimilarity,
+  // упорядоченные по (first, second).
+  std::vector<PairScore> compute(const std::vector<std::vector<uint32_t>>& sets,
+                                 double minSimilarity) const;
+
+private:
+  concurrency::ThreadPool& pool_;
+  size_t stripSize_;
+};
+
+}
+
+#endif //PAIRWISE_H
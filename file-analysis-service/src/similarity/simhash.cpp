@@ -0,0 +1,53 @@
+#include "simhash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace similarity {
+
+namespace {
+
+// Отпечатки winnowing уже перемешаны, но добавочное перемешивание
+// делает биты независимыми и для входов с плохим распределением
+uint64_t mix(uint64_t h) {
+    h ^= h >> 31;
+    h *= 0x7fb5d329728ea185ULL;
+    h ^= h >> 27;
+    h *= 0x81dadef4bc2dd44dULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}
+
+uint64_t SimHash::compute(const std::vector<uint64_t>& features) {
+    if (features.empty()) {
+        return 0;
+    }
+
+    int counts[64] = {};
+    for (uint64_t feature : features) {
+        uint64_t h = mix(feature);
+        for (int bit = 0; bit < 64; ++bit) {
+            counts[bit] += static_cast<int>((h >> bit) & 1) * 2 - 1;
+        }
+    }
+
+    uint64_t result = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        if (counts[bit] > 0) {
+            result |= 1ULL << bit;
+        }
+    }
+    return result;
+}
+
+int SimHash::hammingDistance(uint64_t a, uint64_t b) {
+    return __builtin_popcountll(a ^ b);
+}
+
+double SimHash::estimateCosine(int distance) {
+    double angle = M_PI * static_cast<double>(std::clamp(distance, 0, 64)) / 64.0;
+    return std::max(0.0, std::cos(angle));
+}
+
+}
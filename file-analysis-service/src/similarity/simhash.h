@@ -0,0 +1,25 @@
+#ifndef SIMHASH_H
+#define SIMHASH_H
+
+#include <cstdint>
+#include <vector>
+
+namespace similarity {
+
+// 64-битный SimHash (Charikar) по множеству отпечатков.
+// Вероятность расхождения бита равна θ/π, где θ — угол между множествами,
+// поэтому расстояние Хэмминга даёт оценку косинусного сходства.
+class SimHash {
+public:
+  // SimHash множества; для пустого множества — 0
+  static uint64_t compute(const std::vector<uint64_t>& features);
+
+  static int hammingDistance(uint64_t a, uint64_t b);
+
+  // Оценка косинусного сходства по расстоянию Хэмминга
+  static double estimateCosine(int distance);
+};
+
+}
+
+#endif //SIMHASH_H
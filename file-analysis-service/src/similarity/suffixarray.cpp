@@ -0,0 +1,96 @@
+#include "suffixarray.h"
+#include <algorithm>
+
+namespace similarity {
+
+SuffixArray::SuffixArray(const std::vector<uint64_t>& sequence) {
+    const size_t n = sequence.size();
+    suffixes_.resize(n);
+    lcp_.assign(n, 0);
+    if (n == 0) {
+        return;
+    }
+
+    // Начальные ранги — сжатые значения токенов (1..), 0 означает «за концом»
+    std::vector<uint64_t> alphabet(sequence);
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+
+    std::vector<size_t> rank(n);
+    for (size_t i = 0; i < n; ++i) {
+        rank[i] = static_cast<size_t>(
+            std::lower_bound(alphabet.begin(), alphabet.end(), sequence[i]) - alphabet.begin()) + 1;
+    }
+    size_t maxRank = alphabet.size();
+
+    std::vector<size_t> tmp(n);
+    std::vector<size_t> next(n);
+    std::vector<size_t> count;
+
+    for (size_t i = 0; i < n; ++i) {
+        suffixes_[i] = i;
+    }
+
+    for (size_t k = 1;; k <<= 1) {
+        auto second = [&](size_t i) { return i + k < n ? rank[i + k] : 0; };
+
+        // Поразрядная сортировка: сначала по второму ключу, затем устойчиво по первому
+        count.assign(maxRank + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            ++count[second(i)];
+        }
+        for (size_t r = 1; r <= maxRank; ++r) {
+            count[r] += count[r - 1];
+        }
+        for (size_t i = n; i-- > 0;) {
+            tmp[--count[second(i)]] = i;
+        }
+
+        count.assign(maxRank + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            ++count[rank[i]];
+        }
+        for (size_t r = 1; r <= maxRank; ++r) {
+            count[r] += count[r - 1];
+        }
+        for (size_t j = n; j-- > 0;) {
+            size_t i = tmp[j];
+            suffixes_[--count[rank[i]]] = i;
+        }
+
+        // Новые ранги по парам ключей
+        next[suffixes_[0]] = 1;
+        for (size_t j = 1; j < n; ++j) {
+            size_t prev = suffixes_[j - 1];
+            size_t cur = suffixes_[j];
+            bool same = rank[prev] == rank[cur] && second(prev) == second(cur);
+            next[cur] = next[prev] + (same ? 0 : 1);
+        }
+        rank.swap(next);
+        maxRank = rank[suffixes_[n - 1]];
+
+        if (maxRank == n || k >= n) {
+            break;
+        }
+    }
+
+    // Kasai: rank[i] теперь 1..n и задаёт позицию суффикса i
+    size_t h = 0;
+    for (size_t i = 0; i < n; ++i) {
+        size_t r = rank[i] - 1;
+        if (r == 0) {
+            h = 0;
+            continue;
+        }
+        size_t j = suffixes_[r - 1];
+        while (i + h < n && j + h < n && sequence[i + h] == sequence[j + h]) {
+            ++h;
+        }
+        lcp_[r] = h;
+        if (h > 0) {
+            --h;
+        }
+    }
+}
+
+}
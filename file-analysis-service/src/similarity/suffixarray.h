@@ -0,0 +1,31 @@
+#ifndef SUFFIXARRAY_H
+#define SUFFIXARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace similarity {
+
+// Суффиксный массив и массив LCP над последовательностью токенов.
+// Символы 64-битные: вызывающий может взять разделители вне 32-битных токенов.
+// Построение — удвоение префиксов с поразрядной сортировкой, O(n log n);
+// LCP — алгоритм Kasai, O(n).
+class SuffixArray {
+public:
+  explicit SuffixArray(const std::vector<uint64_t>& sequence);
+
+  // suffixes()[r] — начало r-го по порядку суффикса
+  const std::vector<size_t>& suffixes() const { return suffixes_; }
+
+  // lcp()[r] — длина общего префикса суффиксов r-1 и r (lcp()[0] = 0)
+  const std::vector<size_t>& lcp() const { return lcp_; }
+
+private:
+  std::vector<size_t> suffixes_;
+  std::vector<size_t> lcp_;
+};
+
+}
+
+#endif //SUFFIXARRAY_H
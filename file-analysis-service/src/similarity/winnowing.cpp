@@ -0,0 +1,88 @@
+#include "winnowing.h"
+#include "simd/rollinghash.h"
+#include <algorithm>
+#include <deque>
+
+namespace similarity {
+
+namespace {
+
+// Перемешивание 32-битного хэша k-граммы в 64 бита,
+// чтобы минимум в окне не зависел от порядка символов
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}
+
+Winnowing::Winnowing(WinnowingParams params)
+    : params_(params)
+{
+    params_.kgramSize = std::max<size_t>(params_.kgramSize, 1);
+    params_.windowSize = std::max<size_t>(params_.windowSize, 1);
+}
+
+std::vector<uint64_t> Winnowing::fingerprints(const std::vector<uint32_t>& tokens) const {
+    std::vector<uint64_t> hashes = kgramHashes(tokens);
+
+    std::vector<uint64_t> result;
+    if (hashes.empty()) {
+        return result;
+    }
+
+    // Документ короче одного окна — берём минимальный хэш целиком
+    size_t window = std::min(params_.windowSize, hashes.size());
+
+    // Монотонная очередь индексов: минимум окна всегда в начале.
+    // При равенстве выбираем самый правый минимум (robust winnowing).
+    std::deque<size_t> minQueue;
+    size_t lastSelected = hashes.size();
+
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        while (!minQueue.empty() && hashes[minQueue.back()] >= hashes[i]) {
+            minQueue.pop_back();
+        }
+        minQueue.push_back(i);
+
+        if (minQueue.front() + window <= i) {
+            minQueue.pop_front();
+        }
+
+        if (i + 1 >= window && minQueue.front() != lastSelected) {
+            lastSelected = minQueue.front();
+            result.push_back(hashes[lastSelected]);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+std::vector<uint64_t> Winnowing::kgramHashes(const std::vector<uint32_t>& tokens) const {
+    std::vector<uint64_t> hashes;
+    if (tokens.empty()) {
+        return hashes;
+    }
+
+    // Документ короче k — одна k-грамма на весь документ
+    size_t k = std::min(params_.kgramSize, tokens.size());
+
+    // Полиномиальные хэши считает векторное ядро (AVX2/SSE4.2 при наличии)
+    std::vector<uint32_t> raw(simd::kgramCount(tokens.size(), k));
+    simd::kgramHashes(tokens.data(), tokens.size(), k, raw.data());
+
+    hashes.reserve(raw.size());
+    for (uint32_t h : raw) {
+        hashes.push_back(mix(h));
+    }
+
+    return hashes;
+}
+
+}
@@ -0,0 +1,33 @@
+#ifndef WINNOWING_H
+#define WINNOWING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace similarity {
+
+// Параметры winnowing (Schleimer, Wilkerson, Aiken — MOSS).
+// Любое совпадение длиной не меньше k + window - 1 токенов гарантированно
+// даёт хотя бы один общий отпечаток.
+struct WinnowingParams {
+  size_t kgramSize = 5;
+  size_t windowSize = 6;
+};
+
+class Winnowing {
+public:
+  explicit Winnowing(WinnowingParams params = {});
+
+  // Отпечатки потока токенов: отсортированные уникальные хэши k-грамм
+  std::vector<uint64_t> fingerprints(const std::vector<uint32_t>& tokens) const;
+
+private:
+  std::vector<uint64_t> kgramHashes(const std::vector<uint32_t>& tokens) const;
+
+  WinnowingParams params_;
+};
+
+}
+
+#endif //WINNOWING_H
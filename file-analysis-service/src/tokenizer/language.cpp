@@ -0,0 +1,43 @@
+#include "language.h"
+#include <algorithm>
+#include <cctype>
+
+namespace tokenizer {
+
+Language detectLanguage(const std::string& filename) {
+    size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos) {
+        return Language::Text;
+    }
+
+    std::string ext = filename.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (ext == "c" || ext == "h") {
+        return Language::C;
+    }
+    if (ext == "cpp" || ext == "cc" || ext == "cxx" || ext == "hpp" || ext == "hh" || ext == "hxx") {
+        return Language::Cpp;
+    }
+    if (ext == "java") {
+        return Language::Java;
+    }
+    if (ext == "py") {
+        return Language::Python;
+    }
+    return Language::Text;
+}
+
+const char* languageName(Language language) {
+    switch (language) {
+        case Language::C: return "c";
+        case Language::Cpp: return "cpp";
+        case Language::Java: return "java";
+        case Language::Python: return "python";
+        case Language::Text: return "text";
+    }
+    return "text";
+}
+
+}
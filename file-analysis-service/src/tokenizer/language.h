@@ -0,0 +1,23 @@
+#ifndef LANGUAGE_H
+#define LANGUAGE_H
+
+#include <string>
+
+namespace tokenizer {
+
+enum class Language {
+  C,
+  Cpp,
+  Java,
+  Python,
+  Text  // эссе и всё, что не распознано как код
+};
+
+// Язык по расширению имени файла
+Language detectLanguage(const std::string& filename);
+
+const char* languageName(Language language);
+
+}
+
+#endif //LANGUAGE_H
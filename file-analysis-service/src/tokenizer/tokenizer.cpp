@@ -0,0 +1,421 @@
+#include "tokenizer.h"
+#include "textnormalizer/textnormalizer.h"
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace tokenizer {
+
+namespace {
+
+enum CharClass : uint8_t {
+  kOther,
+  kSpace,
+  kIdent,   // буквы, '_', '$' и байты UTF-8 >= 0x80
+  kDigit,
+  kQuote,
+  kSlash,
+  kHash,
+  kDot
+};
+
+constexpr std::array<uint8_t, 256> makeClassTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = kOther;
+    }
+    for (int c : {' ', '\t', '\n', '\r', '\v', '\f'}) {
+        table[c] = kSpace;
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        table[c] = kIdent;
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        table[c] = kIdent;
+    }
+    for (int c = 0x80; c < 256; ++c) {
+        table[c] = kIdent;
+    }
+    table['_'] = kIdent;
+    table['$'] = kIdent;
+    for (int c = '0'; c <= '9'; ++c) {
+        table[c] = kDigit;
+    }
+    table['"'] = kQuote;
+    table['\''] = kQuote;
+    table['/'] = kSlash;
+    table['#'] = kHash;
+    table['.'] = kDot;
+    return table;
+}
+
+// Символы, продолжающие идентификатор или слово
+constexpr std::array<bool, 256> makeIdentTable() {
+    std::array<bool, 256> table{};
+    constexpr auto classes = makeClassTable();
+    for (int c = 0; c < 256; ++c) {
+        table[c] = classes[c] == kIdent || classes[c] == kDigit;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> makeLowerTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    }
+    return table;
+}
+
+constexpr auto kCharClass = makeClassTable();
+constexpr auto kIdentChar = makeIdentTable();
+constexpr auto kLower = makeLowerTable();
+
+inline uint32_t stepHash(uint32_t h, unsigned char c) {
+    return h * 31u + c;
+}
+
+const char* const kCKeywords[] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do", "double",
+    "else", "enum", "extern", "float", "for", "goto", "if", "inline", "int", "long",
+    "register", "restrict", "return", "short", "signed", "sizeof", "static", "struct",
+    "switch", "typedef", "union", "unsigned", "void", "volatile", "while", "_Bool",
+    "include", "define", "ifdef", "ifndef", "endif", "pragma"
+};
+
+const char* const kCppKeywords[] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do", "double",
+    "else", "enum", "extern", "float", "for", "goto", "if", "inline", "int", "long",
+    "register", "return", "short", "signed", "sizeof", "static", "struct", "switch",
+    "typedef", "union", "unsigned", "void", "volatile", "while", "alignas", "alignof",
+    "and", "asm", "bool", "catch", "class", "concept", "constexpr", "const_cast",
+    "co_await", "co_return", "co_yield", "decltype", "delete", "dynamic_cast",
+    "explicit", "export", "false", "final", "friend", "mutable", "namespace", "new",
+    "noexcept", "not", "nullptr", "operator", "or", "override", "private", "protected",
+    "public", "reinterpret_cast", "requires", "static_assert", "static_cast",
+    "template", "this", "thread_local", "throw", "true", "try", "typeid", "typename",
+    "using", "virtual", "wchar_t", "include", "define", "ifdef", "ifndef", "endif",
+    "pragma"
+};
+
+const char* const kJavaKeywords[] = {
+    "abstract", "assert", "boolean", "break", "byte", "case", "catch", "char", "class",
+    "const", "continue", "default", "do", "double", "else", "enum", "extends", "final",
+    "finally", "float", "for", "goto", "if", "implements", "import", "instanceof", "int",
+    "interface", "long", "native", "new", "package", "private", "protected", "public",
+    "record", "return", "short", "static", "strictfp", "super", "switch", "synchronized",
+    "this", "throw", "throws", "transient", "try", "var", "void", "volatile", "while",
+    "yield", "true", "false", "null"
+};
+
+const char* const kPythonKeywords[] = {
+    "False", "None", "True", "and", "as", "assert", "async", "await", "break", "class",
+    "continue", "def", "del", "elif", "else", "except", "finally", "for", "from",
+    "global", "if", "import", "in", "is", "lambda", "nonlocal", "not", "or", "pass",
+    "raise", "return", "try", "while", "with", "yield"
+};
+
+}
+
+// Хэш-таблица ключевых слов с открытой адресацией.
+// Хэш совпадает с тем, что токенизатор считает при сканировании идентификатора.
+class KeywordTable {
+public:
+    template <size_t N>
+    explicit KeywordTable(const char* const (&words)[N]) {
+        static_assert(N * 2 <= kSize, "keyword table is too dense");
+        for (size_t i = 0; i < N; ++i) {
+            insert(words[i], static_cast<uint32_t>(kKeywordBase + i));
+        }
+    }
+
+    // id ключевого слова или 0
+    uint32_t find(const unsigned char* word, size_t len, uint32_t hash) const {
+        for (size_t i = hash & (kSize - 1);; i = (i + 1) & (kSize - 1)) {
+            const Slot& slot = slots_[i];
+            if (slot.word == nullptr) {
+                return 0;
+            }
+            if (slot.hash == hash && slot.len == len && std::memcmp(slot.word, word, len) == 0) {
+                return slot.id;
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kSize = 256;
+
+    struct Slot {
+        const char* word = nullptr;
+        size_t len = 0;
+        uint32_t hash = 0;
+        uint32_t id = 0;
+    };
+
+    void insert(const char* word, uint32_t id) {
+        size_t len = std::strlen(word);
+        uint32_t hash = 0;
+        for (size_t i = 0; i < len; ++i) {
+            hash = stepHash(hash, static_cast<unsigned char>(word[i]));
+        }
+
+        size_t i = hash & (kSize - 1);
+        while (slots_[i].word != nullptr) {
+            i = (i + 1) & (kSize - 1);
+        }
+        slots_[i] = Slot{word, len, hash, id};
+    }
+
+    std::array<Slot, kSize> slots_{};
+};
+
+namespace {
+
+const KeywordTable* keywordsFor(Language language) {
+    static const KeywordTable c(kCKeywords);
+    static const KeywordTable cpp(kCppKeywords);
+    static const KeywordTable java(kJavaKeywords);
+    static const KeywordTable python(kPythonKeywords);
+
+    switch (language) {
+        case Language::C: return &c;
+        case Language::Cpp: return &cpp;
+        case Language::Java: return &java;
+        case Language::Python: return &python;
+        case Language::Text: return nullptr;
+    }
+    return nullptr;
+}
+
+// Префиксы строковых литералов: u8"", L'', R"()", f"", rb'' и т.п.
+bool isStringPrefix(const unsigned char* word, size_t len, Language language) {
+    if (len > 3) {
+        return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        unsigned char c = word[i];
+        bool allowed = language == Language::Python
+            ? std::strchr("rRbBuUfF", c) != nullptr
+            : std::strchr("uUL8R", c) != nullptr;
+        if (!allowed || c == '\0') {
+            return false;
+        }
+    }
+    return language != Language::Java;
+}
+
+const unsigned char* skipLine(const unsigned char* p, const unsigned char* end) {
+    const void* nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return nl ? static_cast<const unsigned char*>(nl) + 1 : end;
+}
+
+const unsigned char* skipBlockComment(const unsigned char* p, const unsigned char* end) {
+    // p указывает на "/*"
+    for (p += 2; p + 1 < end; ++p) {
+        if (p[0] == '*' && p[1] == '/') {
+            return p + 2;
+        }
+    }
+    return end;
+}
+
+// p указывает на открывающую кавычку
+const unsigned char* skipQuoted(const unsigned char* p, const unsigned char* end, Language language) {
+    unsigned char quote = *p;
+
+    // Тройные кавычки Python
+    if (language == Language::Python && end - p >= 3 && p[1] == quote && p[2] == quote) {
+        for (p += 3; p + 2 < end; ++p) {
+            if (*p == '\\') {
+                ++p;
+            } else if (p[0] == quote && p[1] == quote && p[2] == quote) {
+                return p + 3;
+            }
+        }
+        return end;
+    }
+
+    for (++p; p < end; ++p) {
+        if (*p == '\\') {
+            ++p;
+        } else if (*p == quote) {
+            return p + 1;
+        } else if (*p == '\n') {
+            return p;  // незакрытый литерал
+        }
+    }
+    return end;
+}
+
+// Сырые строки C++: p указывает на '"' в R"delim( ... )delim"
+const unsigned char* skipRawString(const unsigned char* p, const unsigned char* end) {
+    const unsigned char* open = p + 1;
+    while (open < end && *open != '(' && open - p <= 17) {
+        ++open;
+    }
+    if (open >= end || *open != '(') {
+        return skipQuoted(p, end, Language::Cpp);
+    }
+
+    size_t delimLen = static_cast<size_t>(open - (p + 1));
+    for (const unsigned char* q = open + 1; q + delimLen + 1 < end; ++q) {
+        if (*q == ')' && std::memcmp(q + 1, p + 1, delimLen) == 0 && q[delimLen + 1] == '"') {
+            return q + delimLen + 2;
+        }
+    }
+    return end;
+}
+
+const unsigned char* skipNumber(const unsigned char* p, const unsigned char* end) {
+    unsigned char prev = 0;
+    while (p < end) {
+        unsigned char c = *p;
+        bool exponentSign = (c == '+' || c == '-') &&
+                            (prev == 'e' || prev == 'E' || prev == 'p' || prev == 'P');
+        if (!kIdentChar[c] && c != '.' && c != '\'' && !exponentSign) {
+            break;
+        }
+        prev = c;
+        ++p;
+    }
+    return p;
+}
+
+}
+
+Tokenizer::Tokenizer(Language language)
+    : language_(language)
+    , keywords_(keywordsFor(language))
+{}
+
+std::vector<uint32_t> Tokenizer::tokenize(std::string_view content) const {
+    // Токенов не больше, чем байт: пишем в неинициализированный буфер
+    // без проверок ёмкости, затем копируем ровно нужное число
+    std::unique_ptr<uint32_t[]> buffer(new uint32_t[content.size() + 1]);
+
+    size_t count = language_ == Language::Text
+        ? tokenizeText(content, buffer.get())
+        : tokenizeCode(content, buffer.get());
+
+    return std::vector<uint32_t>(buffer.get(), buffer.get() + count);
+}
+
+size_t Tokenizer::tokenizeCode(std::string_view content, uint32_t* out) const {
+    const auto* p = reinterpret_cast<const unsigned char*>(content.data());
+    const auto* end = p + content.size();
+    uint32_t* const outBegin = out;
+
+    const bool python = language_ == Language::Python;
+
+    while (p < end) {
+        unsigned char c = *p;
+
+        switch (kCharClass[c]) {
+            case kSpace:
+                ++p;
+                while (p < end && kCharClass[*p] == kSpace) {
+                    ++p;
+                }
+                break;
+
+            case kIdent: {
+                const unsigned char* start = p;
+                uint32_t hash = 0;
+                do {
+                    hash = stepHash(hash, *p);
+                    ++p;
+                } while (p < end && kIdentChar[*p]);
+
+                size_t len = static_cast<size_t>(p - start);
+
+                if (p < end && kCharClass[*p] == kQuote && isStringPrefix(start, len, language_)) {
+                    bool raw = !python && start[len - 1] == 'R' && *p == '"';
+                    bool isChar = !python && *p == '\'';
+                    p = raw ? skipRawString(p, end) : skipQuoted(p, end, language_);
+                    *out++ = isChar ? kChar : kString;
+                    break;
+                }
+
+                uint32_t keyword = keywords_->find(start, len, hash);
+                *out++ = keyword ? keyword : kIdentifier;
+                break;
+            }
+
+            case kDigit:
+                p = skipNumber(p, end);
+                *out++ = kNumber;
+                break;
+
+            case kQuote: {
+                bool isChar = !python && c == '\'';
+                p = skipQuoted(p, end, language_);
+                *out++ = isChar ? kChar : kString;
+                break;
+            }
+
+            case kSlash:
+                if (!python && p + 1 < end && p[1] == '/') {
+                    p = skipLine(p, end);
+                } else if (!python && p + 1 < end && p[1] == '*') {
+                    p = skipBlockComment(p, end);
+                } else {
+                    *out++ = c;
+                    ++p;
+                }
+                break;
+
+            case kHash:
+                if (python) {
+                    p = skipLine(p, end);
+                } else {
+                    *out++ = c;
+                    ++p;
+                }
+                break;
+
+            case kDot:
+                if (p + 1 < end && kCharClass[p[1]] == kDigit) {
+                    p = skipNumber(p, end);
+                    *out++ = kNumber;
+                } else {
+                    *out++ = c;
+                    ++p;
+                }
+                break;
+
+            default:
+                // Управляющие символы не несут смысла
+                if (c >= 0x20) {
+                    *out++ = c;
+                }
+                ++p;
+                break;
+        }
+    }
+
+    return static_cast<size_t>(out - outBegin);
+}
+
+// Слова берутся в канонической форме TextNormalizer (регистр кириллицы,
+// подмена букв латиницей, ё, типографская пунктуация) прямо по ходу
+// сканирования, без промежуточной нормализованной строки. В коде это не
+// нужно: идентификаторы и строки и так схлопываются в классы.
+size_t Tokenizer::tokenizeText(std::string_view content, uint32_t* out) const {
+    uint32_t* const outBegin = out;
+
+    utils::TextWords words(content);
+    std::string_view word;
+    while (words.next(word)) {
+        // FNV-1a по слову в нижнем регистре
+        uint32_t hash = 2166136261u;
+        for (char c : word) {
+            hash = (hash ^ kLower[static_cast<unsigned char>(c)]) * 16777619u;
+        }
+        *out++ = hash | kWordFlag;
+    }
+
+    return static_cast<size_t>(out - outBegin);
+}
+
+}
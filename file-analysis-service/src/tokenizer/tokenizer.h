@@ -0,0 +1,59 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include "language.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace tokenizer {
+
+// Идентификаторы токенов.
+// 0-255 — символы пунктуации и операторов как есть,
+// затем классы, в которые схлопываются идентификаторы и литералы.
+enum TokenId : uint32_t {
+  kIdentifier = 256,
+  kNumber = 257,
+  kString = 258,
+  kChar = 259,
+  kKeywordBase = 512
+};
+
+// Слова текста кодируются хэшем с установленным старшим битом,
+// чтобы не пересекаться с токенами кода
+constexpr uint32_t kWordFlag = 0x80000000u;
+
+class KeywordTable;
+
+// Нормализованный поток токенов:
+//  - комментарии и пробелы выбрасываются;
+//  - все идентификаторы схлопываются в kIdentifier, поэтому поток
+//    не меняется при любом переименовании переменных;
+//  - литералы сводятся к классам kNumber / kString / kChar;
+//  - ключевые слова языка получают собственные id.
+// Для Language::Text поток — хэши слов в нижнем регистре.
+//
+// Классы символов берутся из таблиц на 256 элементов, ключевые слова —
+// из хэш-таблицы с открытой адресацией; хэш идентификатора считается
+// тем же проходом, которым ищется его конец. Аллокация одна на документ.
+class Tokenizer {
+public:
+  explicit Tokenizer(Language language);
+
+  std::vector<uint32_t> tokenize(std::string_view content) const;
+
+  Language language() const { return language_; }
+
+private:
+  // Пишут токены в out и возвращают их число
+  size_t tokenizeCode(std::string_view content, uint32_t* out) const;
+  size_t tokenizeText(std::string_view content, uint32_t* out) const;
+
+  Language language_;
+  const KeywordTable* keywords_;
+};
+
+}
+
+#endif //TOKENIZER_H
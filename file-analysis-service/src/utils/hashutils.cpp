@@ -0,0 +1,66 @@
+#include "hashutils.h"
+#include <array>
+
+namespace utils {
+
+namespace {
+
+// Байт -> две hex-цифры
+constexpr std::array<char, 512> makeHexPairs() {
+    constexpr char digits[] = "0123456789abcdef";
+    std::array<char, 512> pairs{};
+    for (int b = 0; b < 256; ++b) {
+        pairs[2 * b] = digits[b >> 4];
+        pairs[2 * b + 1] = digits[b & 0xf];
+    }
+    return pairs;
+}
+
+// Символ -> значение hex-цифры, -1 — не цифра
+constexpr std::array<int8_t, 256> makeHexValues() {
+    std::array<int8_t, 256> values{};
+    for (int c = 0; c < 256; ++c) {
+        values[c] = -1;
+    }
+    for (int d = 0; d < 10; ++d) {
+        values['0' + d] = static_cast<int8_t>(d);
+    }
+    for (int d = 0; d < 6; ++d) {
+        values['a' + d] = static_cast<int8_t>(10 + d);
+        values['A' + d] = static_cast<int8_t>(10 + d);
+    }
+    return values;
+}
+
+constexpr auto kHexPairs = makeHexPairs();
+constexpr auto kHexValues = makeHexValues();
+
+}
+
+std::string HashUtils::toHex(const models::Sha256& hash) {
+    std::string hex(hash.size() * 2, '\0');
+    for (size_t i = 0; i < hash.size(); ++i) {
+        hex[2 * i] = kHexPairs[2 * hash[i]];
+        hex[2 * i + 1] = kHexPairs[2 * hash[i] + 1];
+    }
+    return hex;
+}
+
+std::optional<models::Sha256> HashUtils::fromHex(std::string_view hex) {
+    models::Sha256 hash;
+    if (hex.size() != hash.size() * 2) {
+        return std::nullopt;
+    }
+
+    for (size_t i = 0; i < hash.size(); ++i) {
+        int high = kHexValues[static_cast<unsigned char>(hex[2 * i])];
+        int low = kHexValues[static_cast<unsigned char>(hex[2 * i + 1])];
+        if (high < 0 || low < 0) {
+            return std::nullopt;
+        }
+        hash[i] = static_cast<uint8_t>(high << 4 | low);
+    }
+    return hash;
+}
+
+}
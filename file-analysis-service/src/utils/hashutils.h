@@ -0,0 +1,23 @@
+#ifndef HASHUTILS_H
+#define HASHUTILS_H
+
+#include "../models/filehash.h"
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace utils {
+
+// Хэш файла ходит между сервисами в hex, внутри — 32 байта
+class HashUtils {
+public:
+  // 64 hex-символа в нижнем регистре
+  static std::string toHex(const models::Sha256& hash);
+
+  // Обратно из hex (любой регистр); nullopt, если строка не SHA-256
+  static std::optional<models::Sha256> fromHex(std::string_view hex);
+};
+
+}
+
+#endif //HASHUTILS_H
@@ -0,0 +1,125 @@
+// Порядок выборки заданий из analysis_jobs. Нужна база PostgreSQL:
+// ANALYSIS_TEST_DB — строка подключения; без неё тест пропускается.
+// Таблицы создаются из init-scripts/analysis-db.sql во временной схеме.
+
+#include "repository/jobrepository.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kSkipped = 77;
+constexpr size_t kCapacity = 1000;
+const auto kLease = std::chrono::seconds(60);
+const auto kAgingStep = std::chrono::milliseconds(5000);
+
+int failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << "FAIL: " << message << std::endl;
+        ++failures;
+    }
+}
+
+int enqueue(repository::JobRepository& jobs, int submissionId, const std::string& taskId,
+            int priority) {
+    models::AnalysisJob job;
+    job.submissionId = submissionId;
+    job.taskId = taskId;
+    job.studentName = "student" + std::to_string(submissionId);
+    job.filename = "main.cpp";
+    job.priority = priority;
+    job.maxAttempts = 3;
+    return jobs.enqueue(job, kCapacity)->id;
+}
+
+void exec(db::Database& database, const std::string& sql) {
+    pqxx::work txn(database.connection());
+    txn.exec(sql);
+    txn.commit();
+}
+
+// Свежая загрузка идёт раньше голов фонового класса, даже если она
+// вторая в очереди своего задания
+void interactiveBeforeBackfillHeads(db::Database& database, repository::JobRepository& jobs) {
+    for (int task = 0; task < 10; ++task) {
+        enqueue(jobs, 100 + task, "backfill-" + std::to_string(task), 2);
+    }
+    int first = enqueue(jobs, 1, "busy", 0);
+    int second = enqueue(jobs, 2, "busy", 0);
+
+    auto claimed = jobs.claim("test", 2, kLease, kAgingStep);
+    check(claimed.size() == 2, "two jobs claimed");
+    check(claimed.size() == 2 && claimed[0].id == first && claimed[1].id == second,
+          "both interactive jobs of the busy task are claimed before backfill heads");
+
+    exec(database, "DELETE FROM analysis_jobs");
+}
+
+// Внутри класса — по кругу: голова другого задания раньше второй работы
+void roundRobinWithinClass(db::Database& database, repository::JobRepository& jobs) {
+    int first = enqueue(jobs, 1, "busy", 0);
+    enqueue(jobs, 2, "busy", 0);
+    int other = enqueue(jobs, 3, "quiet", 0);
+
+    auto claimed = jobs.claim("test", 2, kLease, kAgingStep);
+    check(claimed.size() == 2 && claimed[0].id == first && claimed[1].id == other,
+          "the head of another task is claimed before the second job of the busy task");
+
+    exec(database, "DELETE FROM analysis_jobs");
+}
+
+// Фоновое задание, прождавшее два шага старения, идёт наравне с загрузками
+void agedBackfillCompetes(db::Database& database, repository::JobRepository& jobs) {
+    enqueue(jobs, 1, "busy", 0);
+    enqueue(jobs, 2, "busy", 0);
+    int aged = enqueue(jobs, 100, "backfill", 2);
+    exec(database, "UPDATE analysis_jobs SET available_at = NOW() - interval '11 seconds' "
+                   "WHERE id = " + std::to_string(aged));
+
+    auto claimed = jobs.claim("test", 2, kLease, kAgingStep);
+    check(claimed.size() == 2 && (claimed[0].id == aged || claimed[1].id == aged),
+          "an aged backfill job is claimed before the second job of the busy task");
+
+    exec(database, "DELETE FROM analysis_jobs");
+}
+
+}
+
+int main() {
+    const char* url = std::getenv("ANALYSIS_TEST_DB");
+    if (url == nullptr || *url == '\0') {
+        std::cout << "ANALYSIS_TEST_DB is not set, skipped" << std::endl;
+        return kSkipped;
+    }
+
+    std::ifstream file(ANALYSIS_DB_SCHEMA);
+    std::stringstream schema;
+    schema << file.rdbuf();
+
+    db::Database database(url, 1, 0);
+    std::string name = "jobrepository_test_" + std::to_string(getpid());
+    exec(database, "CREATE SCHEMA " + name + "; SET search_path TO " + name + ";" + schema.str());
+
+    repository::JobRepository jobs(database);
+    try {
+        interactiveBeforeBackfillHeads(database, jobs);
+        roundRobinWithinClass(database, jobs);
+        agedBackfillCompetes(database, jobs);
+    } catch (const std::exception& e) {
+        check(false, e.what());
+    }
+
+    exec(database, "DROP SCHEMA " + name + " CASCADE");
+
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Квантили гистограммы длительностей планировщика. База не нужна.
+
+#include "concurrency/scheduler.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << "FAIL: " << message << std::endl;
+        ++failures;
+    }
+}
+
+void recordMs(concurrency::DurationHistogram& histogram, double ms, int times) {
+    for (int i = 0; i < times; ++i) {
+        histogram.record(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(ms)));
+    }
+}
+
+// p50 и p99 в разных корзинах: ни один не равен максимуму
+void percentilesInDifferentBuckets() {
+    concurrency::DurationHistogram histogram;
+    recordMs(histogram, 3.0, 90);    // корзина [2, 4)
+    recordMs(histogram, 100.0, 9);   // корзина [64, 128)
+    recordMs(histogram, 1000.0, 1);  // корзина [512, 1024)
+
+    double p50 = histogram.percentileMs(0.5);
+    double p99 = histogram.percentileMs(0.99);
+    check(p50 >= 2.0 && p50 < 4.0, "p50 lies in the [2, 4) bucket, got " + std::to_string(p50));
+    check(p99 >= 64.0 && p99 < 128.0, "p99 lies in the [64, 128) bucket, got " + std::to_string(p99));
+    check(p99 < histogram.maxMs(), "p99 is below the maximum");
+}
+
+// Внутри одной корзины квантили различаются и не выходят за максимум
+void interpolatedWithinBucket() {
+    concurrency::DurationHistogram histogram;
+    recordMs(histogram, 70.0, 50);
+    recordMs(histogram, 120.0, 50);
+
+    double p50 = histogram.percentileMs(0.5);
+    double p99 = histogram.percentileMs(0.99);
+    check(p50 > 64.0 && p50 < p99, "p50 is interpolated below p99, got " + std::to_string(p50));
+    check(p99 <= histogram.maxMs(), "p99 does not exceed the maximum");
+}
+
+// Последняя корзина без верхней границы ограничена максимумом
+void lastBucketBoundedByMax() {
+    concurrency::DurationHistogram histogram;
+    double huge = concurrency::DurationHistogram::upperBoundMs(
+            concurrency::DurationHistogram::kBuckets - 2) * 4;
+    recordMs(histogram, huge, 2);
+
+    double p99 = histogram.percentileMs(0.99);
+    check(p99 <= histogram.maxMs() + 1e-6, "p99 in the last bucket is finite and bounded by the maximum");
+}
+
+}
+
+int main() {
+    check(concurrency::DurationHistogram().percentileMs(0.5) == 0.0, "empty histogram gives zero");
+    percentilesInDifferentBuckets();
+    interpolatedWithinBucket();
+    lastBucketBoundedByMax();
+
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "OK" << std::endl;
+    return 0;
+}
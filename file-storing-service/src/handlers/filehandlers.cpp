@@ -1,4 +1,5 @@
 #include "filehandlers.h"
+#include "../utils/hashutils.h"
 #include "json.hpp"
 #include <iostream>
 
@@ -27,7 +28,7 @@ void FileHandlers::registerRoutes(httplib::Server& server) {
         handleDownload(req, res);
     });
 
-    server.Get(R"(/files/hash/([a-f0-9]+))", [this](const httplib::Request& req, httplib::Response& res) {
+    server.Get(R"(/files/hash/([a-fA-F0-9]+))", [this](const httplib::Request& req, httplib::Response& res) {
         handleFindByHash(req, res);
     });
 }
@@ -78,7 +79,7 @@ void FileHandlers::handleUpload(const httplib::Request& req, httplib::Response&
         response["student_name"] = result.studentName;
         response["task_id"] = result.taskId;
         response["filename"] = result.filename;
-        response["file_hash"] = result.fileHash;
+        response["file_hash"] = utils::HashUtils::toHex(result.fileHash);
         response["file_size"] = result.fileSize;
         response["message"] = "File uploaded successfully";
 
@@ -108,7 +109,7 @@ void FileHandlers::handleGetFile(const httplib::Request& req, httplib::Response&
         response["student_name"] = submission->studentName;
         response["task_id"] = submission->taskId;
         response["filename"] = submission->filename;
-        response["file_hash"] = submission->fileHash;
+        response["file_hash"] = utils::HashUtils::toHex(submission->fileHash);
         response["file_size"] = submission->fileSize;
         response["uploaded_at"] = submission->uploadedAt;
 
@@ -149,7 +150,13 @@ void FileHandlers::handleFindByHash(const httplib::Request& req, httplib::Respon
         std::string hash = req.matches[1];
         std::cout << "[FileHandlers] GET /files/hash/" << hash << std::endl;
 
-        auto submissions = fileService_.findByHash(hash);
+        auto binary = utils::HashUtils::fromHex(hash);
+        if (!binary) {
+            sendError(res, 400, "Hash must be 64 hex characters");
+            return;
+        }
+
+        auto submissions = fileService_.findByHash(*binary);
 
         json files = json::array();
         for (const auto& s : submissions) {
@@ -22,6 +22,13 @@ int main() {
     service::FileService fileService(fileRepo, cfg.server().uploadPath);
     handlers::FileHandlers fileHandlers(fileService);
 
+    // Хэши старых загрузок посчитаны по сырым байтам: до приёма запросов
+    // приводим их к канонической форме, иначе копии с ними не совпадут
+    size_t rehashed = fileService.normalizeStoredHashes();
+    if (rehashed > 0) {
+      std::cout << "[Main] Rehashed " << rehashed << " submissions uploaded before normalization" << std::endl;
+    }
+
     // 4. Настраиваем HTTP сервер
     httplib::Server server;
     fileHandlers.registerRoutes(server);
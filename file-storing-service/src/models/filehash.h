@@ -0,0 +1,14 @@
+#ifndef FILEHASH_H
+#define FILEHASH_H
+
+#include <array>
+#include <cstdint>
+
+namespace models {
+
+// SHA-256 в двоичном виде; в hex переводится только на границе API
+using Sha256 = std::array<uint8_t, 32>;
+
+}
+
+#endif //FILEHASH_H
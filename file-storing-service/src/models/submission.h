@@ -1,6 +1,7 @@
 #ifndef SUBMISSION_H
 #define SUBMISSION_H
 
+#include "filehash.h"
 #include <string>
 #include <cstdint>
 
@@ -12,7 +13,7 @@ struct Submission {
   std::string taskId;
   std::string filename;
   std::string filePath;
-  std::string fileHash;
+  Sha256 fileHash{};
   int64_t fileSize = 0;
   std::string uploadedAt;
 };
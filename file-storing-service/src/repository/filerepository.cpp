@@ -1,4 +1,5 @@
 #include "filerepository.h"
+#include <algorithm>
 #include <pqxx/pqxx>
 
 namespace repository {
@@ -17,7 +18,7 @@ int FileRepository::create(const models::Submission& submission) {
                    + txn.quote(submission.taskId) + ", "
                    + txn.quote(submission.filename) + ", "
                    + txn.quote(submission.filePath) + ", "
-                   + txn.quote(submission.fileHash) + ", "
+                   + txn.quote_raw(submission.fileHash.data(), submission.fileHash.size()) + ", "
                    + std::to_string(submission.fileSize) + ") "
         "RETURNING id";
 
@@ -44,12 +45,12 @@ std::optional<models::Submission> FileRepository::findById(int id) {
     return rowToSubmission(result[0]);
 }
 
-std::vector<models::Submission> FileRepository::findByHash(const std::string& hash) {
+std::vector<models::Submission> FileRepository::findByHash(const models::Sha256& hash) {
     pqxx::work txn(db_.connection());
 
     std::string query =
         "SELECT id, student_name, task_id, filename, file_path, file_hash, file_size, uploaded_at "
-        "FROM submissions WHERE file_hash = " + txn.quote(hash) + " "
+        "FROM submissions WHERE file_hash = " + txn.quote_raw(hash.data(), hash.size()) + " "
         "ORDER BY uploaded_at ASC";
 
     pqxx::result result = txn.exec(query);
@@ -86,6 +87,39 @@ std::vector<models::Submission> FileRepository::findByTaskId(const std::string&
     return submissions;
 }
 
+std::vector<models::Submission> FileRepository::findWithRawHash() {
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "SELECT id, student_name, task_id, filename, file_path, file_hash, file_size, uploaded_at "
+        "FROM submissions WHERE NOT hash_normalized "
+        "ORDER BY id ASC";
+
+    pqxx::result result = txn.exec(query);
+    txn.commit();
+
+    std::vector<models::Submission> submissions;
+    submissions.reserve(result.size());
+
+    for (const auto& row : result) {
+        submissions.push_back(rowToSubmission(row));
+    }
+
+    return submissions;
+}
+
+void FileRepository::updateHash(int id, const models::Sha256& hash) {
+    pqxx::work txn(db_.connection());
+
+    std::string query =
+        "UPDATE submissions SET file_hash = " + txn.quote_raw(hash.data(), hash.size()) + ", "
+        "hash_normalized = TRUE "
+        "WHERE id = " + std::to_string(id);
+
+    txn.exec(query);
+    txn.commit();
+}
+
 models::Submission FileRepository::rowToSubmission(const pqxx::row& row) {
     models::Submission s;
     s.id = row[0].as<int>();
@@ -93,7 +127,8 @@ models::Submission FileRepository::rowToSubmission(const pqxx::row& row) {
     s.taskId = row[2].as<std::string>();
     s.filename = row[3].as<std::string>();
     s.filePath = row[4].as<std::string>();
-    s.fileHash = row[5].as<std::string>();
+    pqxx::binarystring hash(row[5]);
+    std::copy_n(hash.data(), std::min(hash.size(), s.fileHash.size()), s.fileHash.begin());
     s.fileSize = row[6].as<int64_t>();
     s.uploadedAt = row[7].as<std::string>();
     return s;
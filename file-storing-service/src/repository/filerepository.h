@@ -19,11 +19,17 @@ public:
   std::optional<models::Submission> findById(int id);
 
   // Найти все файлы с указанным хэшем
-  std::vector<models::Submission> findByHash(const std::string& hash);
+  std::vector<models::Submission> findByHash(const models::Sha256& hash);
 
   // Найти все файлы для задания
   std::vector<models::Submission> findByTaskId(const std::string& taskId);
 
+  // Файлы, хэш которых посчитан по сырым байтам (загружены до нормализации)
+  std::vector<models::Submission> findWithRawHash();
+
+  // Заменить хэш файла хэшем канонической формы
+  void updateHash(int id, const models::Sha256& hash);
+
 private:
   models::Submission rowToSubmission(const pqxx::row& row);
 
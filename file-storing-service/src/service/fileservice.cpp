@@ -1,11 +1,48 @@
 #include "fileservice.h"
 #include "../utils/hashutils.h"
+#include "textnormalizer/textnormalizer.h"
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <iostream>
 #include <sstream>
 #include <stdexcept>
 
 namespace service {
 
+namespace {
+
+// Исходники нормализуются бережнее текста: регистр и пунктуация значимы
+utils::TextNormalizer::Mode normalizationMode(const std::string& filename) {
+    size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos) {
+        return utils::TextNormalizer::Mode::Text;
+    }
+
+    std::string ext = filename.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    static const char* const kCodeExtensions[] = {
+        "c", "h", "cpp", "cc", "cxx", "hpp", "hh", "hxx", "java", "py"
+    };
+    for (const char* code : kCodeExtensions) {
+        if (ext == code) {
+            return utils::TextNormalizer::Mode::Code;
+        }
+    }
+    return utils::TextNormalizer::Mode::Text;
+}
+
+// Хэш канонической формы: копия с заменёнными буквами или другой
+// пунктуацией считается той же работой
+models::Sha256 contentHash(const std::string& content, const std::string& filename) {
+    return utils::HashUtils::sha256(
+        utils::TextNormalizer::normalize(content, normalizationMode(filename)));
+}
+
+}
+
 FileService::FileService(repository::FileRepository& repo, const std::string& uploadPath)
     : repo_(repo)
     , uploadPath_(uploadPath)
@@ -23,11 +60,11 @@ UploadResult FileService::uploadFile(const UploadRequest& request) {
         throw std::invalid_argument("Task ID cannot be empty");
     }
 
-    // Вычисляем хэш
-    std::string fileHash = utils::HashUtils::sha256(request.content);
+    // На диск пишется оригинал, хэш — от канонической формы
+    models::Sha256 fileHash = contentHash(request.content, request.filename);
 
     // Формируем путь для сохранения
-    std::string filePath = uploadPath_ + fileHash + "_" + request.filename;
+    std::string filePath = uploadPath_ + utils::HashUtils::toHex(fileHash) + "_" + request.filename;
 
     // Сохраняем на диск
     saveToFile(filePath, request.content);
@@ -68,7 +105,7 @@ std::string FileService::getFileContent(int id) {
     return readFromFile(submission->filePath);
 }
 
-std::vector<models::Submission> FileService::findByHash(const std::string& hash) {
+std::vector<models::Submission> FileService::findByHash(const models::Sha256& hash) {
     return repo_.findByHash(hash);
 }
 
@@ -76,6 +113,24 @@ std::vector<models::Submission> FileService::findByTaskId(const std::string& tas
     return repo_.findByTaskId(taskId);
 }
 
+size_t FileService::normalizeStoredHashes() {
+    size_t updated = 0;
+    for (const auto& submission : repo_.findWithRawHash()) {
+        std::string content;
+        try {
+            content = readFromFile(submission.filePath);
+        } catch (const std::exception& e) {
+            // Запись остаётся отмеченной: повторим при следующем старте
+            std::cerr << "[FileService] Cannot rehash submission " << submission.id
+                      << ": " << e.what() << std::endl;
+            continue;
+        }
+        repo_.updateHash(submission.id, contentHash(content, submission.filename));
+        ++updated;
+    }
+    return updated;
+}
+
 void FileService::saveToFile(const std::string& path, const std::string& content) {
     std::ofstream ofs(path, std::ios::binary);
     if (!ofs) {
@@ -23,7 +23,7 @@ struct UploadResult {
   std::string studentName;
   std::string taskId;
   std::string filename;
-  std::string fileHash;
+  models::Sha256 fileHash;
   int64_t fileSize;
 };
 
@@ -41,11 +41,15 @@ public:
   std::string getFileContent(int id);
 
   // Найти файлы по хэшу
-  std::vector<models::Submission> findByHash(const std::string& hash);
+  std::vector<models::Submission> findByHash(const models::Sha256& hash);
 
   // Найти файлы по заданию
   std::vector<models::Submission> findByTaskId(const std::string& taskId);
 
+  // Пересчитать хэши файлов, загруженных до нормализации, по их содержимому
+  // на диске. Возвращает число обновлённых записей
+  size_t normalizeStoredHashes();
+
 private:
   void saveToFile(const std::string& path, const std::string& content);
   std::string readFromFile(const std::string& path);
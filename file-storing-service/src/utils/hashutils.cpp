@@ -1,19 +1,73 @@
 #include "hashutils.h"
-#include <sstream>
-#include <iomanip>
+#include <array>
 #include <openssl/sha.h>
 
 namespace utils {
 
-std::string HashUtils::sha256(const std::string& data) {
-  unsigned char hash[SHA256_DIGEST_LENGTH];
-  SHA256(reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), hash);
+namespace {
 
-  std::stringstream ss;
-  for (int i = 0; i < SHA256_DIGEST_LENGTH; ++i) {
-    ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+// Байт -> две hex-цифры
+constexpr std::array<char, 512> makeHexPairs() {
+  constexpr char digits[] = "0123456789abcdef";
+  std::array<char, 512> pairs{};
+  for (int b = 0; b < 256; ++b) {
+    pairs[2 * b] = digits[b >> 4];
+    pairs[2 * b + 1] = digits[b & 0xf];
   }
-  return ss.str();
+  return pairs;
 }
 
-}
\ No newline at end of file
+// Символ -> значение hex-цифры, -1 — не цифра
+constexpr std::array<int8_t, 256> makeHexValues() {
+  std::array<int8_t, 256> values{};
+  for (int c = 0; c < 256; ++c) {
+    values[c] = -1;
+  }
+  for (int d = 0; d < 10; ++d) {
+    values['0' + d] = static_cast<int8_t>(d);
+  }
+  for (int d = 0; d < 6; ++d) {
+    values['a' + d] = static_cast<int8_t>(10 + d);
+    values['A' + d] = static_cast<int8_t>(10 + d);
+  }
+  return values;
+}
+
+constexpr auto kHexPairs = makeHexPairs();
+constexpr auto kHexValues = makeHexValues();
+
+}
+
+models::Sha256 HashUtils::sha256(std::string_view data) {
+  models::Sha256 hash;
+  SHA256(reinterpret_cast<const unsigned char*>(data.data()), data.size(), hash.data());
+  return hash;
+}
+
+std::string HashUtils::toHex(const models::Sha256& hash) {
+  std::string hex(hash.size() * 2, '\0');
+  for (size_t i = 0; i < hash.size(); ++i) {
+    hex[2 * i] = kHexPairs[2 * hash[i]];
+    hex[2 * i + 1] = kHexPairs[2 * hash[i] + 1];
+  }
+  return hex;
+}
+
+std::optional<models::Sha256> HashUtils::fromHex(std::string_view hex) {
+  models::Sha256 hash;
+  if (hex.size() != hash.size() * 2) {
+    return std::nullopt;
+  }
+
+  for (size_t i = 0; i < hash.size(); ++i) {
+    int high = kHexValues[static_cast<unsigned char>(hex[2 * i])];
+    int low = kHexValues[static_cast<unsigned char>(hex[2 * i + 1])];
+    if (high < 0 || low < 0) {
+      return std::nullopt;
+    }
+    hash[i] = static_cast<uint8_t>(high << 4 | low);
+  }
+  return hash;
+}
+
+}
@@ -1,13 +1,22 @@
 #ifndef HASHUTILS_H
 #define HASHUTILS_H
 
+#include "../models/filehash.h"
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace utils {
 
 class HashUtils {
 public:
-  static std::string sha256(const std::string& data);
+  static models::Sha256 sha256(std::string_view data);
+
+  // 64 hex-символа в нижнем регистре
+  static std::string toHex(const models::Sha256& hash);
+
+  // Обратно из hex (любой регистр); nullopt, если строка не SHA-256
+  static std::optional<models::Sha256> fromHex(std::string_view hex);
 };
 
 }
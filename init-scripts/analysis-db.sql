@@ -8,12 +8,74 @@ CREATE TABLE IF NOT EXISTS reports (
     similarity_percent DECIMAL(5,2) DEFAULT 0.00,
     original_submission_id INTEGER,
     status VARCHAR(50) DEFAULT 'pending',
+    file_hash BYTEA,
+    -- FALSE — хэш по сырым байтам (отчёт до нормализации), его заменяет
+    -- хэшем из File Storing Service сервис анализа при старте
+    hash_normalized BOOLEAN NOT NULL DEFAULT TRUE,
     report_path VARCHAR(500),
     word_cloud_url VARCHAR(500),
+    fingerprints BYTEA,
+    minhash BYTEA,
+    simhash BIGINT,
     created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-    completed_at TIMESTAMP
+    completed_at TIMESTAMP,
+    -- Номер транзакции, завершившей отчёт: порядок догона индексов
+    completed_xid BIGINT
     );
 
 CREATE INDEX IF NOT EXISTS idx_reports_submission ON reports(submission_id);
+CREATE INDEX IF NOT EXISTS idx_reports_completed ON reports(completed_xid);
+CREATE INDEX IF NOT EXISTS idx_reports_file_hash ON reports USING HASH (file_hash);
 CREATE INDEX IF NOT EXISTS idx_reports_task ON reports(task_id);
-CREATE INDEX IF NOT EXISTS idx_reports_plagiarism ON reports(is_plagiarism);
\ No newline at end of file
+CREATE INDEX IF NOT EXISTS idx_reports_plagiarism ON reports(is_plagiarism);
+
+-- Разреженная матрица сходства: по строке на пару (новая работа, более ранняя)
+-- со сходством не ниже MATRIX_FLOOR
+CREATE TABLE IF NOT EXISTS similarity_pairs (
+    task_id VARCHAR(100) NOT NULL,
+    submission_id INTEGER NOT NULL,
+    other_submission_id INTEGER NOT NULL,
+    similarity_percent DECIMAL(5,2) NOT NULL,
+    verified BOOLEAN DEFAULT FALSE,
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    PRIMARY KEY (submission_id, other_submission_id)
+    );
+
+CREATE INDEX IF NOT EXISTS idx_similarity_pairs_task ON similarity_pairs(task_id);
+CREATE INDEX IF NOT EXISTS idx_similarity_pairs_other ON similarity_pairs(other_submission_id);
+
+-- Файлы-заготовки заданий: их код не считается совпадением
+CREATE TABLE IF NOT EXISTS base_files (
+    id SERIAL PRIMARY KEY,
+    task_id VARCHAR(100) NOT NULL,
+    filename VARCHAR(255) NOT NULL,
+    content TEXT NOT NULL,
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+    );
+
+CREATE INDEX IF NOT EXISTS idx_base_files_task ON base_files(task_id);
+
+-- Очередь анализа: задание на каждую работу, поставленную через POST /analyze.
+-- Обработчики берут задания FOR UPDATE SKIP LOCKED и держат аренду до lease_until
+CREATE TABLE IF NOT EXISTS analysis_jobs (
+    id SERIAL PRIMARY KEY,
+    report_id INTEGER NOT NULL,
+    submission_id INTEGER NOT NULL,
+    task_id VARCHAR(100) NOT NULL,
+    student_name VARCHAR(255) NOT NULL,
+    file_hash BYTEA NOT NULL,
+    filename VARCHAR(255) NOT NULL DEFAULT '',
+    priority SMALLINT NOT NULL DEFAULT 0,
+    status VARCHAR(20) NOT NULL DEFAULT 'queued',
+    attempts INTEGER NOT NULL DEFAULT 0,
+    max_attempts INTEGER NOT NULL DEFAULT 3,
+    last_error TEXT,
+    lease_owner VARCHAR(255),
+    lease_until TIMESTAMP,
+    available_at TIMESTAMP NOT NULL DEFAULT NOW(),
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+    );
+
+CREATE INDEX IF NOT EXISTS idx_analysis_jobs_queued ON analysis_jobs(available_at, id) WHERE status = 'queued';
+CREATE INDEX IF NOT EXISTS idx_analysis_jobs_running ON analysis_jobs(lease_until) WHERE status = 'running';
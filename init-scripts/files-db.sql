@@ -5,12 +5,16 @@ CREATE TABLE IF NOT EXISTS submissions (
     task_id VARCHAR(100) NOT NULL,
     filename VARCHAR(255) NOT NULL,
     file_path VARCHAR(500) NOT NULL,
-    file_hash VARCHAR(64) NOT NULL,
+    file_hash BYTEA NOT NULL,
     file_size BIGINT NOT NULL,
+    -- FALSE — хэш по сырым байтам (загрузка до нормализации), его
+    -- пересчитывает File Storing Service при старте
+    hash_normalized BOOLEAN NOT NULL DEFAULT TRUE,
     uploaded_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
     );
 
-CREATE INDEX idx_submissions_hash ON submissions(file_hash);
+-- Хэш ищется только на равенство
+CREATE INDEX idx_submissions_hash ON submissions USING HASH (file_hash);
 
 CREATE INDEX idx_submissions_task ON submissions(task_id);
 
@@ -0,0 +1,501 @@
+#include "textnormalizer.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace utils {
+
+namespace {
+
+enum CharKind : uint8_t {
+    kSpace,      // пробельные и управляющие
+    kPunct,      // пунктуация и символы
+    kIgnore,     // невидимые: выбрасываются, слово не разрывают
+    kDigit,
+    kLatin,
+    kCyrillic,
+    kOtherLetter // прочие буквы и диакритика: копируются как есть
+};
+
+struct CharInfo {
+    uint8_t kind = kOtherLetter;
+    uint16_t lower = 0;  // нижний регистр
+    uint16_t twin = 0;   // двойник из другой письменности того же регистра, 0 — нет
+};
+
+// Таблицы на кодовые точки до U+0500: ASCII, Latin-1, Latin Extended, кириллица
+constexpr uint32_t kTableSize = 0x500;
+
+constexpr std::array<std::pair<uint16_t, uint16_t>, 26> kTwins = {{
+    {'A', 0x410}, {'a', 0x430}, {'B', 0x412}, {'E', 0x415}, {'e', 0x435},
+    {'K', 0x41A}, {'M', 0x41C}, {'H', 0x41D}, {'O', 0x41E}, {'o', 0x43E},
+    {'P', 0x420}, {'p', 0x440}, {'C', 0x421}, {'c', 0x441}, {'T', 0x422},
+    {'Y', 0x423}, {'y', 0x443}, {'X', 0x425}, {'x', 0x445}, {'S', 0x405},
+    {'s', 0x455}, {'I', 0x406}, {'i', 0x456}, {'J', 0x408}, {'j', 0x458},
+    {'h', 0x4BB},
+}};
+
+constexpr std::array<CharInfo, kTableSize> makeTable() {
+    std::array<CharInfo, kTableSize> table{};
+
+    for (uint32_t c = 0; c < kTableSize; ++c) {
+        table[c].lower = static_cast<uint16_t>(c);
+    }
+
+    for (uint32_t c = 0; c < 0x80; ++c) {
+        if (c <= 0x20 || c == 0x7F) {
+            table[c].kind = kSpace;
+        } else if (c >= '0' && c <= '9') {
+            table[c].kind = kDigit;
+        } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            table[c].kind = kLatin;
+        } else {
+            table[c].kind = kPunct;
+        }
+        if (c >= 'A' && c <= 'Z') {
+            table[c].lower = static_cast<uint16_t>(c + 0x20);
+        }
+    }
+
+    // Latin-1: управляющие, NBSP, знаки, затем буквы с диакритикой
+    for (uint32_t c = 0x80; c < 0xC0; ++c) {
+        table[c].kind = c <= 0xA0 ? kSpace : kPunct;
+    }
+    table[0xAD].kind = kIgnore;  // мягкий перенос
+    for (uint32_t c = 0xC0; c < 0x250; ++c) {
+        table[c].kind = kLatin;
+    }
+    table[0xD7].kind = kPunct;
+    table[0xF7].kind = kPunct;
+    for (uint32_t c = 0xC0; c <= 0xDE; ++c) {
+        if (c != 0xD7) {
+            table[c].lower = static_cast<uint16_t>(c + 0x20);
+        }
+    }
+    for (uint32_t c = 0x100; c < 0x180; c += 2) {
+        table[c].lower = static_cast<uint16_t>(c + 1);
+    }
+
+    // Кириллица
+    for (uint32_t c = 0x400; c < 0x500; ++c) {
+        table[c].kind = kCyrillic;
+    }
+    for (uint32_t c = 0x400; c < 0x410; ++c) {
+        table[c].lower = static_cast<uint16_t>(c + 0x50);
+    }
+    for (uint32_t c = 0x410; c < 0x430; ++c) {
+        table[c].lower = static_cast<uint16_t>(c + 0x20);
+    }
+    for (uint32_t c = 0x460; c < 0x482; c += 2) {
+        table[c].lower = static_cast<uint16_t>(c + 1);
+    }
+    for (uint32_t c = 0x48A; c < 0x4C0; c += 2) {
+        table[c].lower = static_cast<uint16_t>(c + 1);
+    }
+    for (uint32_t c = 0x4D0; c < 0x500; c += 2) {
+        table[c].lower = static_cast<uint16_t>(c + 1);
+    }
+    table[0x482].kind = kPunct;  // ҂
+
+    for (const auto& [latin, cyrillic] : kTwins) {
+        table[latin].twin = cyrillic;
+        table[cyrillic].twin = latin;
+    }
+    return table;
+}
+
+constexpr auto kTable = makeTable();
+
+// Байт, которого нет в UTF-8: отметка некорректного байта в декодированном слове
+constexpr uint32_t kRawByte = 0x110000;
+
+CharKind kindOf(uint32_t cp) {
+    if (cp < kTableSize) {
+        return static_cast<CharKind>(kTable[cp].kind);
+    }
+    if (cp >= kRawByte) {
+        return kOtherLetter;
+    }
+    if (cp == 0x200B || cp == 0x200C || cp == 0x200D || cp == 0x2060 || cp == 0xFEFF) {
+        return kIgnore;
+    }
+    if (cp <= 0x200A || cp == 0x2028 || cp == 0x2029 || cp == 0x202F || cp == 0x205F ||
+        cp == 0x3000) {
+        return cp >= 0x2000 ? kSpace : kOtherLetter;
+    }
+    if ((cp >= 0x2010 && cp <= 0x206F) || (cp >= 0x2190 && cp <= 0x23FF) ||
+        (cp >= 0x3001 && cp <= 0x303F) || (cp >= 0xFF01 && cp <= 0xFF0F)) {
+        return kPunct;
+    }
+    return kOtherLetter;
+}
+
+bool isWordKind(CharKind kind) {
+    return kind == kDigit || kind == kLatin || kind == kCyrillic || kind == kOtherLetter;
+}
+
+// Декодирует один символ; некорректный байт возвращается как kRawByte + байт
+uint32_t decode(const uint8_t*& p, const uint8_t* end) {
+    uint8_t c = *p;
+    size_t length = c < 0x80 ? 1 : c >= 0xC2 && c <= 0xDF ? 2 : c >= 0xE0 && c <= 0xEF ? 3
+                  : c >= 0xF0 && c <= 0xF4 ? 4 : 0;
+    if (length == 0 || static_cast<size_t>(end - p) < length) {
+        ++p;
+        return kRawByte + c;
+    }
+
+    uint32_t cp = length == 1 ? c : c & (0xFF >> (length + 1));
+    for (size_t i = 1; i < length; ++i) {
+        if ((p[i] & 0xC0) != 0x80) {
+            ++p;
+            return kRawByte + c;
+        }
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    p += length;
+    return cp;
+}
+
+void encode(uint32_t cp, std::string& out) {
+    if (cp >= kRawByte) {
+        out.push_back(static_cast<char>(cp - kRawByte));
+    } else if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+bool isAsciiWordByte(uint8_t c) {
+    return c < 0x80 && (kTable[c].kind == kDigit || kTable[c].kind == kLatin);
+}
+
+bool isAsciiSeparatorByte(uint8_t c) {
+    return c < 0x80 && (kTable[c].kind == kSpace || kTable[c].kind == kPunct);
+}
+
+// Длина серии ASCII-букв и цифр (word) или ASCII-разделителей от p
+size_t asciiRun(const uint8_t* p, const uint8_t* end, bool word) {
+    const uint8_t* start = p;
+#if defined(__SSE2__)
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i beforeA = _mm_set1_epi8('a' - 1);
+    const __m128i afterZ = _mm_set1_epi8('z' + 1);
+    const __m128i before0 = _mm_set1_epi8('0' - 1);
+    const __m128i after9 = _mm_set1_epi8('9' + 1);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // Байты не из ASCII отрицательны и не попадают ни в один диапазон
+        __m128i folded = _mm_or_si128(v, caseBit);
+        __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, beforeA), _mm_cmplt_epi8(folded, afterZ));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, before0), _mm_cmplt_epi8(v, after9));
+        unsigned wordMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(letter, digit)));
+        unsigned nonAscii = static_cast<unsigned>(_mm_movemask_epi8(v));
+
+        unsigned stop = word ? ~wordMask & 0xFFFF : (wordMask | nonAscii);
+        if (stop != 0) {
+            return static_cast<size_t>(p - start) + static_cast<size_t>(__builtin_ctz(stop));
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && (word ? isAsciiWordByte(*p) : isAsciiSeparatorByte(*p))) {
+        ++p;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+// Копирует слово, в режиме Text — с ASCII-буквами в нижнем регистре.
+// Байты не из ASCII не трогаются, поэтому годится и для готового слова TextWords
+void appendAsciiWord(const uint8_t* p, size_t length, bool foldCase, std::string& out) {
+    size_t offset = out.size();
+    out.append(reinterpret_cast<const char*>(p), length);
+    if (!foldCase) {
+        return;
+    }
+
+    char* q = &out[offset];
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i beforeA = _mm_set1_epi8('A' - 1);
+    const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + i));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, beforeA), _mm_cmplt_epi8(v, afterZ));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(q + i),
+                         _mm_or_si128(v, _mm_and_si128(upper, caseBit)));
+    }
+#endif
+    for (; i < length; ++i) {
+        if (q[i] >= 'A' && q[i] <= 'Z') {
+            q[i] = static_cast<char>(q[i] + 0x20);
+        }
+    }
+}
+
+// Слово с буквами не из ASCII: выбрать письменность по голосам букв
+// без двойника и свернуть двойники к ней. Ничья — кириллица; слово
+// только из двойников (сор/cop) — латиница, чтобы оба варианта совпали.
+void appendWord(const std::vector<uint32_t>& word, bool foldCase, std::string& out) {
+    int votes = 0;
+    bool voted = false;
+    for (uint32_t cp : word) {
+        if (cp >= kTableSize) {
+            continue;
+        }
+        const CharInfo& info = kTable[cp];
+        if (info.kind != kLatin && info.kind != kCyrillic) {
+            continue;
+        }
+        // Двойник только в одном регистре (B/В, но b/в) — буква голосует
+        if (info.twin != 0 && kTable[info.lower].twin != 0) {
+            continue;
+        }
+        votes += info.kind == kCyrillic ? 1 : -1;
+        voted = true;
+    }
+    CharKind target = votes > 0 || (voted && votes == 0) ? kCyrillic : kLatin;
+
+    for (uint32_t cp : word) {
+        if (cp < kTableSize) {
+            const CharInfo& info = kTable[cp];
+            if ((info.kind == kLatin || info.kind == kCyrillic) && info.kind != target && info.twin != 0) {
+                cp = info.twin;
+            }
+            if (foldCase) {
+                cp = kTable[cp].lower;
+            }
+        }
+        encode(cp, out);
+    }
+}
+
+// Буква U+0400..U+047F в нижнем регистре (после ё -> е) в UTF-8
+// и признак того, что она голосует за кириллицу в appendWord
+struct CyrillicLetter {
+    char lead = 0;
+    char trail = 0;
+    bool votes = false;
+};
+
+constexpr std::array<CyrillicLetter, 0x80> makeCyrillicLetters() {
+    std::array<CyrillicLetter, 0x80> letters{};
+    for (uint32_t i = 0; i < 0x80; ++i) {
+        uint32_t cp = 0x400 + i;
+        if (cp == 0x451) {
+            cp = 0x435;
+        } else if (cp == 0x401) {
+            cp = 0x415;
+        }
+        const CharInfo& info = kTable[cp];
+        uint32_t lower = info.lower;
+        letters[i].lead = static_cast<char>(0xC0 | (lower >> 6));
+        letters[i].trail = static_cast<char>(0x80 | (lower & 0x3F));
+        letters[i].votes = info.twin == 0 || kTable[info.lower].twin == 0;
+    }
+    return letters;
+}
+
+constexpr auto kCyrillicLetters = makeCyrillicLetters();
+
+// Кончается ли слово перед p: дальше разделитель или конец текста
+bool endsWord(const uint8_t* p, const uint8_t* end) {
+    if (p == end || isAsciiSeparatorByte(*p)) {
+        return true;
+    }
+    if (*p < 0x80) {
+        return false;
+    }
+    CharKind kind = kindOf(decode(p, end));
+    return kind == kSpace || kind == kPunct;
+}
+
+// Быстрый путь для слова только из букв U+0400..U+047F (два байта на букву):
+// если в нём есть буква без латинского двойника, appendWord оставил бы его
+// кириллицей, так что достаточно свернуть регистр по таблице. Возвращает
+// длину слова в байтах или 0, тогда out не меняется и нужен медленный путь.
+size_t appendCyrillicWord(const uint8_t* p, const uint8_t* end, std::string& out) {
+    const uint8_t* start = p;
+    size_t offset = out.size();
+    bool voted = false;
+    while (end - p >= 2 && (p[0] == 0xD0 || p[0] == 0xD1) && (p[1] & 0xC0) == 0x80) {
+        const CyrillicLetter& letter = kCyrillicLetters[((p[0] & 1u) << 6) | (p[1] & 0x3Fu)];
+        out.push_back(letter.lead);
+        out.push_back(letter.trail);
+        voted |= letter.votes;
+        p += 2;
+    }
+    if (p == start || !voted || !endsWord(p, end)) {
+        out.resize(offset);
+        return 0;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+// Слово от p целиком: невидимые символы внутри выбрасываются, ё -> е
+void readWord(const uint8_t*& p, const uint8_t* end, std::vector<uint32_t>& word) {
+    word.clear();
+    while (p < end) {
+        const uint8_t* next = p;
+        uint32_t cp = decode(next, end);
+        CharKind kind = kindOf(cp);
+        if (kind == kIgnore) {
+            p = next;
+            continue;
+        }
+        if (!isWordKind(kind)) {
+            break;
+        }
+        if (cp == 0x451) {
+            cp = 0x435;
+        } else if (cp == 0x401) {
+            cp = 0x415;
+        }
+        word.push_back(cp);
+        p = next;
+    }
+}
+
+}
+
+TextWords::TextWords(std::string_view text)
+    : p_(reinterpret_cast<const uint8_t*>(text.data()))
+    , end_(p_ + text.size())
+{}
+
+bool TextWords::next(std::string_view& word) {
+    while (p_ < end_) {
+        if (isAsciiSeparatorByte(*p_)) {
+            p_ += asciiRun(p_, end_, false);
+            continue;
+        }
+
+        if (isAsciiWordByte(*p_)) {
+            size_t length = asciiRun(p_, end_, true);
+            if (p_ + length == end_ || isAsciiSeparatorByte(p_[length])) {
+                word = std::string_view(reinterpret_cast<const char*>(p_), length);
+                p_ += length;
+                return true;
+            }
+        }
+
+        buffer_.clear();
+        if (size_t length = appendCyrillicWord(p_, end_, buffer_)) {
+            p_ += length;
+            word = buffer_;
+            return true;
+        }
+
+        // В режиме Text всё, что не слово, — разделитель
+        const uint8_t* next = p_;
+        if (!isWordKind(kindOf(decode(next, end_)))) {
+            p_ = next;
+            continue;
+        }
+
+        readWord(p_, end_, scratch_);
+        appendWord(scratch_, true, buffer_);
+        word = buffer_;
+        return true;
+    }
+    return false;
+}
+
+std::string TextNormalizer::normalize(std::string_view text, Mode mode) {
+    std::string out;
+    out.reserve(text.size());
+
+    if (mode == Mode::Text) {
+        TextWords words(text);
+        std::string_view word;
+        while (words.next(word)) {
+            if (!out.empty()) {
+                out.push_back(' ');
+            }
+            appendAsciiWord(reinterpret_cast<const uint8_t*>(word.data()), word.size(), true, out);
+        }
+        return out;
+    }
+
+    const auto* p = reinterpret_cast<const uint8_t*>(text.data());
+    const auto* end = p + text.size();
+
+    // Разделитель выводится лениво, перед следующим словом или знаком:
+    // так нет пробелов в начале и в конце
+    bool pendingSpace = false;
+    auto flushSpace = [&]() {
+        if (pendingSpace && !out.empty()) {
+            out.push_back(' ');
+        }
+        pendingSpace = false;
+    };
+
+    std::vector<uint32_t> word;
+
+    while (p < end) {
+        // Быстрый путь: ASCII-пробелы и знаки
+        if (isAsciiSeparatorByte(*p)) {
+            if (kTable[*p].kind == kSpace) {
+                ++p;
+                pendingSpace = true;
+            } else {
+                flushSpace();
+                out.push_back(static_cast<char>(*p++));
+            }
+            continue;
+        }
+
+        // Быстрый путь: ASCII-слово, за которым не идёт буква не из ASCII
+        if (isAsciiWordByte(*p)) {
+            size_t length = asciiRun(p, end, true);
+            if (p + length == end || isAsciiSeparatorByte(p[length])) {
+                flushSpace();
+                appendAsciiWord(p, length, false, out);
+                p += length;
+                continue;
+            }
+        }
+
+        // Медленный путь: символ UTF-8 или слово с такими символами
+        const uint8_t* next = p;
+        CharKind kind = kindOf(decode(next, end));
+
+        if (kind == kIgnore) {
+            p = next;
+            continue;
+        }
+        if (kind == kSpace) {
+            p = next;
+            pendingSpace = true;
+            continue;
+        }
+        if (kind == kPunct) {
+            flushSpace();
+            out.append(reinterpret_cast<const char*>(p), static_cast<size_t>(next - p));
+            p = next;
+            continue;
+        }
+
+        readWord(p, end, word);
+        flushSpace();
+        appendWord(word, false, out);
+    }
+
+    return out;
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef TEXTNORMALIZER_H
+#define TEXTNORMALIZER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+// Каноническая форма UTF-8 текста (кириллица и латиница) для хэша
+// и отпечатков. В обоих режимах:
+//  - ё -> е, невидимые символы (U+200B, U+00AD, BOM, ...) выбрасываются;
+//  - слово приводится к одной письменности: латинские буквы, похожие
+//    на кириллические (a/а, o/о, B/В, ...), в русском слове заменяются
+//    кириллическими, и наоборот. Письменность выбирается по буквам,
+//    у которых двойника нет, при равенстве — кириллица.
+// Text дополнительно переводит в нижний регистр и сводит любые серии
+// пунктуации и пробелов к одному пробелу. Code сохраняет регистр
+// и пунктуацию, сводит к пробелу только серии пробельных символов.
+//
+// Символы классифицируются по таблицам, построенным при компиляции;
+// серии ASCII-символов просматриваются по 16 байт (SSE2), слова из
+// кириллицы U+0400..U+047F сворачиваются без декодирования в буфер.
+class TextNormalizer {
+public:
+  enum class Mode { Text, Code };
+
+  static std::string normalize(std::string_view text, Mode mode = Mode::Text);
+};
+
+// Слова канонической формы Text по одному, без сборки всей строки:
+// normalize(text) — это слова через пробел. ASCII-слово отдаётся прямо
+// из text, и регистр в нём не свёрнут; остальные слова — из внутреннего
+// буфера, уже свёрнутые. word действителен до следующего next.
+class TextWords {
+public:
+  explicit TextWords(std::string_view text);
+
+  bool next(std::string_view& word);
+
+private:
+  const uint8_t* p_;
+  const uint8_t* end_;
+  std::string buffer_;
+  std::vector<uint32_t> scratch_;
+};
+
+}
+
+#endif //TEXTNORMALIZER_H